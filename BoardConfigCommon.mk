@@ -161,6 +161,7 @@ BOARD_ROOT_EXTRA_FOLDERS := \
 
 # RIL
 BOARD_PROVIDES_LIBRIL := true
+TARGET_RIL_EVENT_USES_EPOLL := true
 
 # RPC
 TARGET_NO_RPC := true
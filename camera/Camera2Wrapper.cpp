@@ -627,6 +627,8 @@ static int camera2_dump(struct camera_device *device, int fd)
     ALOGV("%s->%08X->%08X", __FUNCTION__, (uintptr_t)device,
             (uintptr_t)(((wrapper_camera2_device_t*)device)->vendor));
 
+    camera_dump_looper_stats(fd);
+
     return VENDOR_CALL(device, dump, fd);
 }
 
@@ -129,6 +129,8 @@ static void camera3_dump(const camera3_device_t *device, int fd)
     if (!device)
         return;
 
+    camera_dump_looper_stats(fd);
+
     VENDOR_CALL(device, dump, fd);
 }
 
@@ -21,6 +21,8 @@
 #define LOG_TAG "CameraWrapper"
 #include <log/log.h>
 
+#include <dlfcn.h>
+
 #include "CameraWrapper.h"
 #include "Camera2Wrapper.h"
 #include "Camera3Wrapper.h"
@@ -41,6 +43,19 @@ static int check_vendor_module()
     return rv;
 }
 
+void camera_dump_looper_stats(int fd)
+{
+    // libshim_camera is linked into the vendor HAL, look it up without loading it
+    void *shim = dlopen("libshim_camera.so", RTLD_NOW | RTLD_NOLOAD);
+    if (!shim)
+        return;
+
+    void (*looper_dump)(int) = (void (*)(int)) dlsym(shim, "looper_shim_dump");
+    if (looper_dump)
+        looper_dump(fd);
+    dlclose(shim);
+}
+
 static struct hw_module_methods_t camera_module_methods = {
         .open = camera_device_open
 };
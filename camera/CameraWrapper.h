@@ -32,3 +32,6 @@ static int camera_get_camera_info(int camera_id, struct camera_info *info);
 static int camera_set_callbacks(const camera_module_callbacks_t *callbacks);
 static void camera_get_vendor_tag_ops(vendor_tag_ops_t* ops);
 static int camera_open_legacy(const struct hw_module_t* module, const char* id, uint32_t halVersion, struct hw_device_t** device);
+
+// Dump the counters of the shimmed Loopers the vendor HAL runs on, if the shim is loaded
+void camera_dump_looper_stats(int fd);
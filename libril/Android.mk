@@ -1,18 +1,18 @@
 # Copyright 2006 The Android Open Source Project
 
 LOCAL_PATH:= $(call my-dir)
-include $(CLEAR_VARS)
-
-LOCAL_VENDOR_MODULE := true
 
-LOCAL_SRC_FILES:= \
+libril_src_files := \
     ril.cpp \
     ril_event.cpp\
+    ril_latency.cpp \
+    ril_recorder.cpp \
+    ril_response_sender.cpp \
     RilSapSocket.cpp \
     ril_service.cpp \
     sap_service.cpp
 
-LOCAL_SHARED_LIBRARIES := \
+libril_shared_libraries := \
     liblog \
     libutils \
     libcutils \
@@ -25,25 +25,41 @@ LOCAL_SHARED_LIBRARIES := \
     libhidltransport \
     libhwbinder
 
-LOCAL_STATIC_LIBRARIES := \
+libril_static_libraries := \
     libprotobuf-c-nano-enable_malloc-32bit \
 
-LOCAL_CFLAGS += -Wall -Wextra -Wno-unused-parameter -Werror
-LOCAL_CFLAGS += -DPB_FIELD_32BIT
+libril_cflags := -Wall -Wextra -Wno-unused-parameter -Werror
+libril_cflags += -DPB_FIELD_32BIT
 
 ifeq ($(SIM_COUNT), 2)
-    LOCAL_CFLAGS += -DANDROID_MULTI_SIM -DDSDA_RILD1
-    LOCAL_CFLAGS += -DANDROID_SIM_COUNT_2
+    libril_cflags += -DANDROID_MULTI_SIM -DDSDA_RILD1
+    libril_cflags += -DANDROID_SIM_COUNT_2
 endif
 
 ifneq ($(DISABLE_RILD_OEM_HOOK),)
-    LOCAL_CFLAGS += -DOEM_HOOK_DISABLED
+    libril_cflags += -DOEM_HOOK_DISABLED
+endif
+
+ifeq ($(TARGET_RIL_EVENT_USES_EPOLL),true)
+    libril_cflags += -DRIL_EVENT_USE_EPOLL
 endif
 
 ifneq ($(TARGET_USES_OLD_MNC_FORMAT),)
-    LOCAL_CFLAGS += -DOLD_MNC_FORMAT
+    libril_cflags += -DOLD_MNC_FORMAT
 endif
 
+include $(CLEAR_VARS)
+
+LOCAL_VENDOR_MODULE := true
+
+LOCAL_SRC_FILES:= $(libril_src_files)
+
+LOCAL_SHARED_LIBRARIES := $(libril_shared_libraries)
+
+LOCAL_STATIC_LIBRARIES := $(libril_static_libraries)
+
+LOCAL_CFLAGS += $(libril_cflags)
+
 LOCAL_C_INCLUDES += external/nanopb-c
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/../include
 LOCAL_EXPORT_C_INCLUDE_DIRS := $(LOCAL_PATH)/../include
@@ -52,3 +68,78 @@ LOCAL_MODULE:= libril
 LOCAL_SANITIZE := integer
 
 include $(BUILD_SHARED_LIBRARY)
+
+include $(CLEAR_VARS)
+
+LOCAL_VENDOR_MODULE := true
+
+LOCAL_SRC_FILES:= \
+    ril_response_sender.cpp \
+    tests/ril_response_sender_test.cpp
+
+LOCAL_SHARED_LIBRARIES := \
+    liblog \
+    libutils \
+    libhidlbase
+
+LOCAL_CFLAGS += $(libril_cflags)
+
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../include
+
+LOCAL_MODULE:= ril_response_sender_test
+LOCAL_SANITIZE := integer
+
+include $(BUILD_NATIVE_TEST)
+
+# Builds the libril sources in, so that their heap allocations can be counted
+include $(CLEAR_VARS)
+
+LOCAL_VENDOR_MODULE := true
+
+LOCAL_SRC_FILES:= \
+    $(libril_src_files) \
+    tests/fake_vendor_ril.cpp \
+    tests/ril_load_generator.cpp
+
+LOCAL_SHARED_LIBRARIES := $(libril_shared_libraries)
+
+LOCAL_STATIC_LIBRARIES := $(libril_static_libraries)
+
+LOCAL_CFLAGS += $(libril_cflags)
+LOCAL_CFLAGS += -DANDROID_WAKE_LOCK_NAME=\"ril_load_generator\"
+LOCAL_CFLAGS += -DANDROID_COALESCE_WAKE_LOCK_NAME=\"ril_load_generator-coalesce\"
+
+LOCAL_LDFLAGS := -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=strdup
+
+LOCAL_C_INCLUDES += external/nanopb-c
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../include
+
+LOCAL_MODULE:= ril_load_generator
+LOCAL_GTEST := false
+
+include $(BUILD_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+
+LOCAL_VENDOR_MODULE := true
+
+LOCAL_SRC_FILES:= \
+    $(libril_src_files) \
+    tests/fake_vendor_ril.cpp \
+    tests/ril_trace_replayer.cpp
+
+LOCAL_SHARED_LIBRARIES := $(libril_shared_libraries)
+
+LOCAL_STATIC_LIBRARIES := $(libril_static_libraries)
+
+LOCAL_CFLAGS += $(libril_cflags)
+LOCAL_CFLAGS += -DANDROID_WAKE_LOCK_NAME=\"ril_trace_replayer\"
+LOCAL_CFLAGS += -DANDROID_COALESCE_WAKE_LOCK_NAME=\"ril_trace_replayer-coalesce\"
+
+LOCAL_C_INCLUDES += external/nanopb-c
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../include
+
+LOCAL_MODULE:= ril_trace_replayer
+LOCAL_GTEST := false
+
+include $(BUILD_NATIVE_TEST)
@@ -27,6 +27,8 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <sap_service.h>
+#include <ril_latency.h>
+#include <telephony/librilutils.h>
 
 static RilSapSocket::RilSapSocketList *head = NULL;
 
@@ -209,9 +211,12 @@ void RilSapSocket::dispatchRequest(MsgHeader *req) {
     currRequest->token = req->token;
     currRequest->curr = req;
     currRequest->p_next = NULL;
+    currRequest->p_prev = NULL;
     currRequest->socketId = id;
+    currRequest->startTime = ril_nano_time();
 
     pendingResponseQueue.enqueue(currRequest);
+    android::ril_latency_sap_start(req->id);
 
     if (uimFuncs) {
         RLOGI("RilSapSocket::dispatchRequest [%d] > SAP REQUEST type: %d. id: %d. error: %d, \
@@ -246,23 +251,15 @@ void RilSapSocket::onRequestComplete(RIL_Token t, RIL_Errno e, void *response,
     rsp.type = MsgType_RESPONSE;
     rsp.id = request->curr->id;
     rsp.error = (Error)e;
-    rsp.payload = (pb_bytes_array_t *)calloc(1, sizeof(pb_bytes_array_t) + response_len);
-    if (!rsp.payload) {
-        RLOGE("onRequestComplete: OOM");
-    } else {
-        if (response && response_len > 0) {
-            memcpy(rsp.payload->bytes, response, response_len);
-            rsp.payload->size = response_len;
-        } else {
-            rsp.payload->size = 0;
-        }
+    // the response is decoded straight from the vendor buffer
+    rsp.payload = NULL;
 
-        RLOGE("RilSapSocket::onRequestComplete: Token:%d, MessageId:%d ril token 0x%p",
-                hdr->token, hdr->id, t);
+    RLOGE("RilSapSocket::onRequestComplete: Token:%d, MessageId:%d ril token 0x%p",
+            hdr->token, hdr->id, t);
 
-        sap::processResponse(&rsp, this);
-        free(rsp.payload);
-    }
+    sap::processResponse(&rsp, response, response ? response_len : 0, this);
+
+    android::ril_latency_sap_complete(hdr->id, request->startTime);
 
     // Deallocate SapSocketRequest
     if(!pendingResponseQueue.checkAndDequeue(hdr->id, hdr->token)) {
@@ -276,20 +273,11 @@ void RilSapSocket::onRequestComplete(RIL_Token t, RIL_Errno e, void *response,
 
 void RilSapSocket::onUnsolicitedResponse(int unsolResponse, void *data, size_t datalen) {
     if (data && datalen > 0) {
-        pb_bytes_array_t *payload = (pb_bytes_array_t *)calloc(1,
-                sizeof(pb_bytes_array_t) + datalen);
-        if (!payload) {
-            RLOGE("onUnsolicitedResponse: OOM");
-            return;
-        }
-        memcpy(payload->bytes, data, datalen);
-        payload->size = datalen;
         MsgHeader rsp;
-        rsp.payload = payload;
+        rsp.payload = NULL;
         rsp.type = MsgType_UNSOL_RESPONSE;
         rsp.id = (MsgId)unsolResponse;
         rsp.error = Error_RIL_E_SUCCESS;
-        sap::processUnsolResponse(&rsp, this);
-        free(payload);
+        sap::processUnsolResponse(&rsp, data, datalen, this);
     }
 }
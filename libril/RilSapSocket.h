@@ -48,18 +48,20 @@ class RilSapSocket : public RilSocket {
         int token;
         MsgHeader* curr;
         struct SapSocketRequest* p_next;
+        struct SapSocketRequest* p_prev;
         RIL_SOCKET_ID socketId;
+        uint64_t startTime;
     } SapSocketRequest;
 
     /**
      * Queue for requests that are pending dispatch.
      */
-    Ril_queue<SapSocketRequest> dispatchQueue;
+    Ril_mpsc_queue<SapSocketRequest> dispatchQueue;
 
     /**
      * Queue for requests that are dispatched but are pending response
      */
-    Ril_queue<SapSocketRequest> pendingResponseQueue;
+    Ril_mpsc_queue<SapSocketRequest> pendingResponseQueue;
 
     public:
         /**
@@ -24,6 +24,7 @@
 #include <cutils/jstring.h>
 #include <hwbinder/ProcessState.h>
 #include <telephony/record_stream.h>
+#include <telephony/librilutils.h>
 #include <utils/Log.h>
 #include <utils/SystemClock.h>
 #include <pthread.h>
@@ -42,11 +43,15 @@
 #include <errno.h>
 #include <assert.h>
 #include <ctype.h>
+#include <inttypes.h>
 #include <sys/un.h>
 #include <assert.h>
 #include <netinet/in.h>
 #include <cutils/properties.h>
 #include <RilSapSocket.h>
+#include <rilObjectPool.h>
+#include <ril_latency.h>
+#include <ril_recorder.h>
 #include <ril_service.h>
 #include <sap_service.h>
 
@@ -64,7 +69,14 @@ namespace android {
 #define PHONE_PROCESS "radio"
 #define BLUETOOTH_PROCESS "bluetooth"
 
+// Overridden by the test tools, so their wake locks are not mistaken for rild's
+#ifndef ANDROID_WAKE_LOCK_NAME
 #define ANDROID_WAKE_LOCK_NAME "radio-interface"
+#endif
+// Held while a WAKE_PARTIAL indication waits for the coalescing flush
+#ifndef ANDROID_COALESCE_WAKE_LOCK_NAME
+#define ANDROID_COALESCE_WAKE_LOCK_NAME "radio-interface-coalesce"
+#endif
 
 #define ANDROID_WAKE_LOCK_SECS 0
 #define ANDROID_WAKE_LOCK_USECS 200000
@@ -91,6 +103,17 @@ namespace android {
 // Set hwbinder buffer size to 512KB
 #define HW_BINDER_MMAP_SIZE 524288
 
+// Number of hash buckets per slot for pending requests, must be a power of 2
+#define PENDING_REQUEST_BUCKETS 128
+
+// Preallocated objects; allocations beyond these fall back to the heap
+#define REQUEST_INFO_POOL_SIZE 256
+#define USER_CALLBACK_INFO_POOL_SIZE 64
+
+// Coalescing window for bursty indications, in ms, 0 disables coalescing
+#define PROPERTY_UNSOL_COALESCE_MS "ro.ril.unsol_coalesce_ms"
+#define PROPERTY_UNSOL_COALESCE_SCREEN_OFF_MS "ro.ril.unsol_coalesce_screen_off_ms"
+
 enum WakeType {DONT_WAKE, WAKE_PARTIAL};
 
 typedef struct {
@@ -100,6 +123,17 @@ typedef struct {
     WakeType wakeType;
 } UnsolResponseInfo;
 
+/**
+ * Requests handed to the vendor RIL and not yet completed, hashed by the
+ * RequestInfo pointer that doubles as the RIL_Token. Chains are linked
+ * through RequestInfo::p_next.
+ */
+typedef struct PendingRequestTable {
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    RequestInfo *buckets[PENDING_REQUEST_BUCKETS] = {};
+    int count = 0;
+} PendingRequestTable;
+
 typedef struct UserCallbackInfo {
     RIL_TimedCallback p_callback;
     void *userParam;
@@ -131,24 +165,13 @@ int s_wakelock_count = 0;
 
 static struct ril_event s_wakeupfd_event;
 
-static pthread_mutex_t s_pendingRequestsMutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t s_wakeLockCountMutex = PTHREAD_MUTEX_INITIALIZER;
-static RequestInfo *s_pendingRequests = NULL;
 
-#if (SIM_COUNT >= 2)
-static pthread_mutex_t s_pendingRequestsMutex_socket2  = PTHREAD_MUTEX_INITIALIZER;
-static RequestInfo *s_pendingRequests_socket2          = NULL;
-#endif
+/** Index == socket_id */
+static PendingRequestTable s_pendingRequests[SIM_COUNT];
 
-#if (SIM_COUNT >= 3)
-static pthread_mutex_t s_pendingRequestsMutex_socket3  = PTHREAD_MUTEX_INITIALIZER;
-static RequestInfo *s_pendingRequests_socket3          = NULL;
-#endif
-
-#if (SIM_COUNT >= 4)
-static pthread_mutex_t s_pendingRequestsMutex_socket4  = PTHREAD_MUTEX_INITIALIZER;
-static RequestInfo *s_pendingRequests_socket4          = NULL;
-#endif
+static Ril_pool<RequestInfo, REQUEST_INFO_POOL_SIZE> s_requestInfoPool;
+static Ril_pool<UserCallbackInfo, USER_CALLBACK_INFO_POOL_SIZE> s_userCallbackInfoPool;
 
 static const struct timeval TIMEVAL_WAKE_TIMEOUT = {ANDROID_WAKE_LOCK_SECS,ANDROID_WAKE_LOCK_USECS};
 
@@ -156,11 +179,61 @@ static const struct timeval TIMEVAL_WAKE_TIMEOUT = {ANDROID_WAKE_LOCK_SECS,ANDRO
 static pthread_mutex_t s_startupMutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t s_startupCond = PTHREAD_COND_INITIALIZER;
 
-static UserCallbackInfo *s_last_wake_timeout_info = NULL;
+/**
+ * Wake lock state, all guarded by s_wakeLockCountMutex. The kernel wake lock
+ * is only touched when s_wakeLockHeld flips; every grab in between just moves
+ * s_wake_timeout_deadline, which the single s_wake_timeout_event enforces.
+ */
+static bool s_wakeLockHeld = false;
+static uint64_t s_wakeLockHeldSince = 0;
+static uint64_t s_wake_timeout_deadline = 0;
+static struct ril_event s_wake_timeout_event;
+static bool s_wakeTimeoutArmed = false;
+static uint64_t s_wakeLockGrabs = 0;
+static uint64_t s_wakeLockAcquisitions = 0;
+static uint64_t s_wakeLockHoldTime = 0;
+static uint64_t s_wakeLockTimeouts = 0;
 
 static void *s_lastNITZTimeData = NULL;
 static size_t s_lastNITZTimeDataSize;
 
+/**
+ * Indications that are held back for the coalescing window, latest value wins.
+ * Repeats of the last delivered payload are dropped for the ones with dropRepeats.
+ */
+static const struct {
+    int unsolResponse;
+    bool dropRepeats;
+} s_coalescedUnsols[] = {
+    {RIL_UNSOL_SIGNAL_STRENGTH, true},
+    {RIL_UNSOL_CELL_INFO_LIST, true},
+    // no payload, it only tells the framework to poll the state again
+    {RIL_UNSOL_RESPONSE_VOICE_NETWORK_STATE_CHANGED, false},
+};
+
+typedef struct CoalescedUnsol {
+    bool pending;
+    void *data;
+    size_t datalen;
+    bool delivered;         // lastData holds the payload last sent to the framework
+    void *lastData;
+    size_t lastDataLen;
+} CoalescedUnsol;
+
+static pthread_mutex_t s_coalesceMutex = PTHREAD_MUTEX_INITIALIZER;
+static CoalescedUnsol s_coalesced[SIM_COUNT][NUM_ELEMS(s_coalescedUnsols)];
+static UserCallbackInfo *s_coalesce_flush_info = NULL;
+// Passed to coalesceFlushCallback() so it only clears s_coalesce_flush_info if still its own
+static uintptr_t s_coalesceFlushGeneration;
+static bool s_coalesceWakeLockHeld;
+static struct timeval s_coalesceWindow;
+static struct timeval s_coalesceScreenOffWindow;
+static bool s_screenOn = true;
+static uint64_t s_coalesceHeld;
+static uint64_t s_coalesceSuperseded;
+static uint64_t s_coalesceRepeatsDropped;
+static uint64_t s_coalesceFlushed;
+
 #if RILC_LOG
     static char printBuf[PRINTBUF_SIZE];
 #endif
@@ -168,7 +241,7 @@ static size_t s_lastNITZTimeDataSize;
 /*******************************************************************/
 static void grabPartialWakeLock();
 void releaseWakeLock();
-static void wakeTimeoutCallback(void *);
+static void wakeTimeoutCallback(int fd, short flags, void *param);
 
 #ifdef RIL_SHLIB
 #if defined(ANDROID_MULTI_SIM)
@@ -189,6 +262,10 @@ extern "C" void RIL_onUnsolicitedResponse(int unsolResponse, const void *data,
 static UserCallbackInfo * internalRequestTimedCallback
     (RIL_TimedCallback callback, void *param,
         const struct timeval *relativeTime);
+static void extendWakeTimeoutLocked();
+static int deliverUnsolResponse(int unsolResponseIndex, const void *data,
+        size_t datalen, RIL_SOCKET_ID soc_id);
+static void coalesceFlushCallback(void *param);
 
 /** Index == requestNumber */
 static CommandInfo s_commands[] = {
@@ -203,42 +280,34 @@ char * RIL_getServiceName() {
     return ril_service_name;
 }
 
+static inline RequestInfo **
+pendingRequestBucket(PendingRequestTable *table, RequestInfo *pRI) {
+    // allocations are at least 8 byte aligned, so drop the low bits; the
+    // product of two 32 bit values can't overflow 64 bits, which matters
+    // because libril is built with the integer sanitizer
+    uint64_t key = (uint32_t) ((uintptr_t) pRI >> 3);
+    key *= 2654435761u;
+    return &table->buckets[(key >> 7) & (PENDING_REQUEST_BUCKETS - 1)];
+}
+
 RequestInfo *
 addRequestToList(int serial, int slotId, int request) {
     RequestInfo *pRI;
     int ret;
     RIL_SOCKET_ID socket_id = (RIL_SOCKET_ID) slotId;
-    /* Hook for current context */
-    /* pendingRequestsMutextHook refer to &s_pendingRequestsMutex */
-    pthread_mutex_t* pendingRequestsMutexHook = &s_pendingRequestsMutex;
-    /* pendingRequestsHook refer to &s_pendingRequests */
-    RequestInfo**    pendingRequestsHook = &s_pendingRequests;
 
-#if (SIM_COUNT >= 2)
-    if (socket_id == RIL_SOCKET_2) {
-        pendingRequestsMutexHook = &s_pendingRequestsMutex_socket2;
-        pendingRequestsHook = &s_pendingRequests_socket2;
-    }
-#if (SIM_COUNT >= 3)
-    else if (socket_id == RIL_SOCKET_3) {
-        pendingRequestsMutexHook = &s_pendingRequestsMutex_socket3;
-        pendingRequestsHook = &s_pendingRequests_socket3;
-    }
-#endif
-#if (SIM_COUNT >= 4)
-    else if (socket_id == RIL_SOCKET_4) {
-        pendingRequestsMutexHook = &s_pendingRequestsMutex_socket4;
-        pendingRequestsHook = &s_pendingRequests_socket4;
+    if (slotId < 0 || slotId >= SIM_COUNT) {
+        RLOGE("Request %s on invalid slot %d", requestToString(request), slotId);
+        return NULL;
     }
-#endif
-#endif
+    PendingRequestTable *table = &s_pendingRequests[slotId];
 
     if (request >= (int)NUM_ELEMS(s_commands)) {
         RLOGE("Request %s not supported", requestToString(request));
         return NULL;
     }
 
-    pRI = (RequestInfo *)calloc(1, sizeof(RequestInfo));
+    pRI = s_requestInfoPool.alloc();
     if (pRI == NULL) {
         RLOGE("Memory allocation failed for request %s", requestToString(request));
         return NULL;
@@ -247,19 +316,72 @@ addRequestToList(int serial, int slotId, int request) {
     pRI->token = serial;
     pRI->pCI = &(s_commands[request]);
     pRI->socket_id = socket_id;
+    pRI->startTime = ril_nano_time();
+
+    RequestInfo **bucket = pendingRequestBucket(table, pRI);
 
-    ret = pthread_mutex_lock(pendingRequestsMutexHook);
+    ret = pthread_mutex_lock(&table->mutex);
     assert (ret == 0);
 
-    pRI->p_next = *pendingRequestsHook;
-    *pendingRequestsHook = pRI;
+    pRI->p_next = *bucket;
+    *bucket = pRI;
+    table->count++;
 
-    ret = pthread_mutex_unlock(pendingRequestsMutexHook);
+    ret = pthread_mutex_unlock(&table->mutex);
     assert (ret == 0);
 
+    ril_latency_request_start(request, serial);
+
     return pRI;
 }
 
+/**
+ * Write every request still waiting on the vendor RIL, with its age, to fd.
+ */
+void
+dumpPendingRequests(int fd) {
+    uint64_t now = ril_nano_time();
+
+    for (int slotId = 0; slotId < SIM_COUNT; slotId++) {
+        PendingRequestTable *table = &s_pendingRequests[slotId];
+        pthread_mutex_lock(&table->mutex);
+
+        dprintf(fd, "%s: %d pending requests\n",
+                rilSocketIdToString((RIL_SOCKET_ID) slotId), table->count);
+        for (int i = 0; i < PENDING_REQUEST_BUCKETS; i++) {
+            for (RequestInfo *pRI = table->buckets[i]; pRI != NULL; pRI = pRI->p_next) {
+                dprintf(fd, "  [%04d] %s age=%" PRIu64 "ms%s%s\n", pRI->token,
+                        requestToString(pRI->pCI->requestNumber),
+                        (now - pRI->startTime) / 1000000,
+                        pRI->wasAckSent ? " acked" : "",
+                        pRI->cancelled ? " cancelled" : "");
+            }
+        }
+
+        pthread_mutex_unlock(&table->mutex);
+    }
+}
+
+static void
+dumpPoolStats(int fd, const char *name, const RilPoolStats &stats) {
+    dprintf(fd, "%s pool: capacity=%u inUse=%u highWater=%u allocations=%" PRIu64
+            " heapFallbacks=%" PRIu64 "\n", name, stats.capacity, stats.inUse,
+            stats.highWater, stats.allocations, stats.heapFallbacks);
+}
+
+/**
+ * Write usage of the RequestInfo and UserCallbackInfo pools to fd.
+ */
+void
+dumpObjectPools(int fd) {
+    RilPoolStats stats;
+
+    s_requestInfoPool.getStats(&stats);
+    dumpPoolStats(fd, "RequestInfo", stats);
+    s_userCallbackInfoPool.getStats(&stats);
+    dumpPoolStats(fd, "UserCallbackInfo", stats);
+}
+
 static void triggerEvLoop() {
     int ret;
     if (!pthread_equal(pthread_self(), s_tid_dispatch)) {
@@ -298,8 +420,8 @@ static void resendLastNITZTimeData(RIL_SOCKET_ID socket_id) {
         int responseType = (s_callbacks.version >= 13)
                            ? RESPONSE_UNSOLICITED_ACK_EXP
                            : RESPONSE_UNSOLICITED;
-        // acquire read lock for the service before calling nitzTimeReceivedInd() since it reads
-        // nitzTimeReceived in ril_service
+        // acquire read lock for the service before calling nitzTimeReceivedInd() since it uses
+        // the indication callback
         pthread_rwlock_t *radioServiceRwlockPtr = radio::getRadioServiceRwlock(
                 (int) socket_id);
         int rwlockRet = pthread_rwlock_rdlock(radioServiceRwlockPtr);
@@ -319,6 +441,17 @@ static void resendLastNITZTimeData(RIL_SOCKET_ID socket_id) {
 }
 
 void onNewCommandConnect(RIL_SOCKET_ID socket_id) {
+    // A new client has not seen anything yet, so nothing counts as a repeat
+    pthread_mutex_lock(&s_coalesceMutex);
+    for (size_t i = 0; i < NUM_ELEMS(s_coalescedUnsols); i++) {
+        CoalescedUnsol *entry = &s_coalesced[socket_id][i];
+        free(entry->lastData);
+        entry->lastData = NULL;
+        entry->lastDataLen = 0;
+        entry->delivered = false;
+    }
+    pthread_mutex_unlock(&s_coalesceMutex);
+
     // Inform we are connected and the ril version
     int rilVer = s_callbacks.version;
     RIL_UNSOL_RESPONSE(RIL_UNSOL_RIL_CONNECTED,
@@ -354,13 +487,17 @@ static void userTimerCallback (int fd, short flags, void *param) {
 
     p_info->p_callback(p_info->userParam);
 
+    s_userCallbackInfoPool.release(p_info);
+}
 
-    // FIXME generalize this...there should be a cancel mechanism
-    if (s_last_wake_timeout_info != NULL && s_last_wake_timeout_info == p_info) {
-        s_last_wake_timeout_info = NULL;
+/**
+ * Cancel a callback scheduled with internalRequestTimedCallback().
+ * If it is already being fired it is left alone, and will free itself.
+ */
+static void cancelTimedCallback(UserCallbackInfo *p_info) {
+    if (ril_timer_del(&(p_info->event))) {
+        s_userCallbackInfoPool.release(p_info);
     }
-
-    free(p_info);
 }
 
 
@@ -471,6 +608,22 @@ RIL_register (const RIL_RadioFunctions *callbacks) {
                 == s_unsolResponses[i].requestNumber);
     }
 
+    int coalesceMs = property_get_int32(PROPERTY_UNSOL_COALESCE_MS, 0);
+    int coalesceScreenOffMs = property_get_int32(PROPERTY_UNSOL_COALESCE_SCREEN_OFF_MS,
+            coalesceMs);
+    if (coalesceMs > 0) {
+        s_coalesceWindow.tv_sec = coalesceMs / 1000;
+        s_coalesceWindow.tv_usec = (coalesceMs % 1000) * 1000;
+    }
+    if (coalesceScreenOffMs > 0) {
+        s_coalesceScreenOffWindow.tv_sec = coalesceScreenOffMs / 1000;
+        s_coalesceScreenOffWindow.tv_usec = (coalesceScreenOffMs % 1000) * 1000;
+    }
+    RLOGI("RIL_register: coalescing indications for %d ms, %d ms with screen off",
+            coalesceMs, coalesceScreenOffMs);
+
+    ril_recorder_init(s_callbacks.version);
+
     radio::registerService(&s_callbacks, s_commands);
     RLOGI("RILHIDL called registerService");
 
@@ -513,56 +666,42 @@ RIL_register_socket (const RIL_RadioFunctions *(*Init)(const struct RIL_Env *, i
 static int
 checkAndDequeueRequestInfoIfAck(struct RequestInfo *pRI, bool isAck) {
     int ret = 0;
-    /* Hook for current context
-       pendingRequestsMutextHook refer to &s_pendingRequestsMutex */
-    pthread_mutex_t* pendingRequestsMutexHook = &s_pendingRequestsMutex;
-    /* pendingRequestsHook refer to &s_pendingRequests */
-    RequestInfo ** pendingRequestsHook = &s_pendingRequests;
 
     if (pRI == NULL) {
         return 0;
     }
 
-#if (SIM_COUNT >= 2)
-    if (pRI->socket_id == RIL_SOCKET_2) {
-        pendingRequestsMutexHook = &s_pendingRequestsMutex_socket2;
-        pendingRequestsHook = &s_pendingRequests_socket2;
-    }
-#if (SIM_COUNT >= 3)
-        if (pRI->socket_id == RIL_SOCKET_3) {
-            pendingRequestsMutexHook = &s_pendingRequestsMutex_socket3;
-            pendingRequestsHook = &s_pendingRequests_socket3;
-        }
-#endif
-#if (SIM_COUNT >= 4)
-    if (pRI->socket_id == RIL_SOCKET_4) {
-        pendingRequestsMutexHook = &s_pendingRequestsMutex_socket4;
-        pendingRequestsHook = &s_pendingRequests_socket4;
-    }
-#endif
-#endif
-    pthread_mutex_lock(pendingRequestsMutexHook);
-
-    for(RequestInfo **ppCur = pendingRequestsHook
-        ; *ppCur != NULL
-        ; ppCur = &((*ppCur)->p_next)
-    ) {
-        if (pRI == *ppCur) {
-            ret = 1;
-            if (isAck) { // Async ack
-                if (pRI->wasAckSent == 1) {
-                    RLOGD("Ack was already sent for %s", requestToString(pRI->pCI->requestNumber));
+    // pRI came back from the vendor RIL and may be bogus, so only its address
+    // is used until it is found in one of the tables
+    for (int slotId = 0; slotId < SIM_COUNT && ret == 0; slotId++) {
+        PendingRequestTable *table = &s_pendingRequests[slotId];
+        RequestInfo **bucket = pendingRequestBucket(table, pRI);
+
+        pthread_mutex_lock(&table->mutex);
+
+        for(RequestInfo **ppCur = bucket
+            ; *ppCur != NULL
+            ; ppCur = &((*ppCur)->p_next)
+        ) {
+            if (pRI == *ppCur) {
+                ret = 1;
+                if (isAck) { // Async ack
+                    if (pRI->wasAckSent == 1) {
+                        RLOGD("Ack was already sent for %s",
+                                requestToString(pRI->pCI->requestNumber));
+                    } else {
+                        pRI->wasAckSent = 1;
+                    }
                 } else {
-                    pRI->wasAckSent = 1;
+                    *ppCur = (*ppCur)->p_next;
+                    table->count--;
                 }
-            } else {
-                *ppCur = (*ppCur)->p_next;
+                break;
             }
-            break;
         }
-    }
 
-    pthread_mutex_unlock(pendingRequestsMutexHook);
+        pthread_mutex_unlock(&table->mutex);
+    }
 
     return ret;
 }
@@ -581,6 +720,7 @@ RIL_onRequestAck(RIL_Token t) {
     }
 
     socket_id = pRI->socket_id;
+    ril_latency_request_ack(pRI->pCI->requestNumber, pRI->startTime);
 
 #if VDBG
     RLOGD("Request Ack, %s", rilSocketIdToString(socket_id));
@@ -614,6 +754,9 @@ RIL_onRequestComplete(RIL_Token t, RIL_Errno e, void *response, size_t responsel
     }
 
     socket_id = pRI->socket_id;
+    ril_latency_request_complete(pRI->pCI->requestNumber, pRI->token, pRI->startTime);
+    ril_recorder_complete(pRI->pCI->requestNumber, pRI->token, (int) socket_id, e, response,
+            responselen);
 #if VDBG
     RLOGD("RequestComplete, %s", rilSocketIdToString(socket_id));
 #endif
@@ -623,7 +766,7 @@ RIL_onRequestComplete(RIL_Token t, RIL_Errno e, void *response, size_t responsel
         // response does not go back up the command socket
         RLOGD("C[locl]< %s", requestToString(pRI->pCI->requestNumber));
 
-        free(pRI);
+        s_requestInfoPool.release(pRI);
         return;
     }
 
@@ -656,80 +799,319 @@ RIL_onRequestComplete(RIL_Token t, RIL_Errno e, void *response, size_t responsel
         rwlockRet = pthread_rwlock_unlock(radioServiceRwlockPtr);
         assert(rwlockRet == 0);
     }
-    free(pRI);
+    s_requestInfoPool.release(pRI);
 }
 
 static void
 grabPartialWakeLock() {
-    if (s_callbacks.version >= 13) {
-        int ret;
-        ret = pthread_mutex_lock(&s_wakeLockCountMutex);
-        assert(ret == 0);
-        acquire_wake_lock(PARTIAL_WAKE_LOCK, ANDROID_WAKE_LOCK_NAME);
+    int ret;
+    ret = pthread_mutex_lock(&s_wakeLockCountMutex);
+    assert(ret == 0);
 
-        UserCallbackInfo *p_info =
-                internalRequestTimedCallback(wakeTimeoutCallback, NULL, &TIMEVAL_WAKE_TIMEOUT);
-        if (p_info == NULL) {
-            release_wake_lock(ANDROID_WAKE_LOCK_NAME);
-        } else {
-            s_wakelock_count++;
-            if (s_last_wake_timeout_info != NULL) {
-                s_last_wake_timeout_info->userParam = (void *)1;
-            }
-            s_last_wake_timeout_info = p_info;
-        }
-        ret = pthread_mutex_unlock(&s_wakeLockCountMutex);
-        assert(ret == 0);
-    } else {
+    s_wakeLockGrabs++;
+    if (!s_wakeLockHeld) {
         acquire_wake_lock(PARTIAL_WAKE_LOCK, ANDROID_WAKE_LOCK_NAME);
+        s_wakeLockHeld = true;
+        s_wakeLockHeldSince = ril_nano_time();
+        s_wakeLockAcquisitions++;
+    }
+    if (s_callbacks.version >= 13) {
+        s_wakelock_count++;
+    }
+    extendWakeTimeoutLocked();
+
+    ret = pthread_mutex_unlock(&s_wakeLockCountMutex);
+    assert(ret == 0);
+}
+
+/**
+ * Drop the kernel wake lock if it is held.
+ * Must be called with s_wakeLockCountMutex held.
+ */
+static void
+releaseWakeLockLocked() {
+    s_wakelock_count = 0;
+    if (s_wakeLockHeld) {
+        release_wake_lock(ANDROID_WAKE_LOCK_NAME);
+        s_wakeLockHeld = false;
+        s_wakeLockHoldTime += ril_nano_time() - s_wakeLockHeldSince;
     }
 }
 
 void
 releaseWakeLock() {
-    if (s_callbacks.version >= 13) {
-        int ret;
-        ret = pthread_mutex_lock(&s_wakeLockCountMutex);
-        assert(ret == 0);
+    int ret;
+    ret = pthread_mutex_lock(&s_wakeLockCountMutex);
+    assert(ret == 0);
+
+    if (s_callbacks.version >= 13 && s_wakelock_count > 1) {
+        s_wakelock_count--;
+    } else {
+        // The deadline timer stays armed and finds nothing to do when it fires
+        releaseWakeLockLocked();
+    }
+
+    ret = pthread_mutex_unlock(&s_wakeLockCountMutex);
+    assert(ret == 0);
+}
 
-        if (s_wakelock_count > 1) {
-            s_wakelock_count--;
+/**
+ * Push the wake lock timeout out to TIMEVAL_WAKE_TIMEOUT from now.
+ * The timer is only armed if it is not already, it re-arms itself when it
+ * fires before the deadline.
+ * Must be called with s_wakeLockCountMutex held.
+ */
+static void
+extendWakeTimeoutLocked() {
+    s_wake_timeout_deadline = ril_nano_time()
+            + ANDROID_WAKE_LOCK_SECS * 1000000000ULL + ANDROID_WAKE_LOCK_USECS * 1000ULL;
+
+    if (!s_wakeTimeoutArmed) {
+        struct timeval timeout = TIMEVAL_WAKE_TIMEOUT;
+        ril_event_set(&s_wake_timeout_event, -1, false, wakeTimeoutCallback, NULL);
+        ril_timer_add(&s_wake_timeout_event, &timeout);
+        s_wakeTimeoutArmed = true;
+        triggerEvLoop();
+    }
+}
+
+/**
+ * Timer callback to put us back to sleep before the default timeout
+ */
+static void
+wakeTimeoutCallback(int fd, short flags, void *param) {
+    int ret;
+    ret = pthread_mutex_lock(&s_wakeLockCountMutex);
+    assert(ret == 0);
+
+    s_wakeTimeoutArmed = false;
+    if (s_wakeLockHeld) {
+        uint64_t now = ril_nano_time();
+        if (now >= s_wake_timeout_deadline) {
+            s_wakeLockTimeouts++;
+            releaseWakeLockLocked();
         } else {
-            s_wakelock_count = 0;
-            release_wake_lock(ANDROID_WAKE_LOCK_NAME);
-            if (s_last_wake_timeout_info != NULL) {
-                s_last_wake_timeout_info->userParam = (void *)1;
-            }
+            // Grabbed again since the timer was armed, wait out the rest
+            uint64_t remaining = (s_wake_timeout_deadline - now + 999) / 1000;
+            struct timeval timeout = {(time_t) (remaining / 1000000),
+                    (suseconds_t) (remaining % 1000000)};
+            ril_timer_add(&s_wake_timeout_event, &timeout);
+            s_wakeTimeoutArmed = true;
+        }
+    }
+
+    ret = pthread_mutex_unlock(&s_wakeLockCountMutex);
+    assert(ret == 0);
+}
+
+/**
+ * Write the wake lock counters to fd.
+ */
+void
+dumpWakeLockStats(int fd) {
+    pthread_mutex_lock(&s_wakeLockCountMutex);
+    uint64_t holdTime = s_wakeLockHoldTime;
+    if (s_wakeLockHeld) {
+        holdTime += ril_nano_time() - s_wakeLockHeldSince;
+    }
+    dprintf(fd, "Wake lock: held=%d count=%d grabs=%" PRIu64 " acquisitions=%" PRIu64
+            " holdTime=%" PRIu64 "ms timeouts=%" PRIu64 "\n", s_wakeLockHeld,
+            s_wakelock_count, s_wakeLockGrabs, s_wakeLockAcquisitions, holdTime / 1000000,
+            s_wakeLockTimeouts);
+    pthread_mutex_unlock(&s_wakeLockCountMutex);
+}
+
+/**
+ * Must be called with s_coalesceMutex held.
+ */
+static const struct timeval *
+coalesceWindowLocked() {
+    const struct timeval *window = s_screenOn ? &s_coalesceWindow : &s_coalesceScreenOffWindow;
+    return (window->tv_sec == 0 && window->tv_usec == 0) ? NULL : window;
+}
+
+/**
+ * Keep a coalescable indication until the next flush instead of delivering it now.
+ *
+ * @return true if the indication was held or dropped, false if it must be
+ *         delivered right away
+ */
+static bool
+holdCoalescedUnsol(int unsolResponse, const void *data, size_t datalen,
+        RIL_SOCKET_ID soc_id) {
+    size_t i;
+    for (i = 0; i < NUM_ELEMS(s_coalescedUnsols); i++) {
+        if (s_coalescedUnsols[i].unsolResponse == unsolResponse) {
+            break;
         }
+    }
+    if (i == NUM_ELEMS(s_coalescedUnsols)) {
+        return false;
+    }
 
-        ret = pthread_mutex_unlock(&s_wakeLockCountMutex);
-        assert(ret == 0);
+    pthread_mutex_lock(&s_coalesceMutex);
+
+    const struct timeval *window = coalesceWindowLocked();
+    if (window == NULL) {
+        pthread_mutex_unlock(&s_coalesceMutex);
+        return false;
+    }
+
+    CoalescedUnsol *entry = &s_coalesced[soc_id][i];
+
+    if (entry->pending) {
+        if (entry->datalen == datalen
+                && (datalen == 0 || memcmp(entry->data, data, datalen) == 0)) {
+            s_coalesceRepeatsDropped++;
+            pthread_mutex_unlock(&s_coalesceMutex);
+            return true;
+        }
+    } else if (s_coalescedUnsols[i].dropRepeats && entry->delivered
+            && entry->lastDataLen == datalen
+            && (datalen == 0 || memcmp(entry->lastData, data, datalen) == 0)) {
+        s_coalesceRepeatsDropped++;
+        pthread_mutex_unlock(&s_coalesceMutex);
+        return true;
+    }
+
+    if (datalen > 0) {
+        void *copy = (entry->pending && entry->datalen >= datalen)
+                ? entry->data : realloc(entry->data, datalen);
+        if (copy == NULL) {
+            RLOGE("Memory allocation failed in holdCoalescedUnsol");
+            pthread_mutex_unlock(&s_coalesceMutex);
+            return false;
+        }
+        memcpy(copy, data, datalen);
+        entry->data = copy;
+    }
+    entry->datalen = datalen;
+
+    if (entry->pending) {
+        s_coalesceSuperseded++;
     } else {
-        release_wake_lock(ANDROID_WAKE_LOCK_NAME);
+        entry->pending = true;
+        s_coalesceHeld++;
+    }
+
+    // The flush timer doesn't run while suspended, so don't let the device
+    // suspend on an indication that was meant to wake it
+    if (s_unsolResponses[unsolResponse - RIL_UNSOL_RESPONSE_BASE].wakeType == WAKE_PARTIAL
+            && !s_coalesceWakeLockHeld) {
+        acquire_wake_lock(PARTIAL_WAKE_LOCK, ANDROID_COALESCE_WAKE_LOCK_NAME);
+        s_coalesceWakeLockHeld = true;
+    }
+
+    if (s_coalesce_flush_info == NULL) {
+        s_coalesce_flush_info = internalRequestTimedCallback(coalesceFlushCallback,
+                (void *) ++s_coalesceFlushGeneration, window);
     }
+
+    pthread_mutex_unlock(&s_coalesceMutex);
+    return true;
 }
 
 /**
- * Timer callback to put us back to sleep before the default timeout
+ * Timer callback delivering every held indication.
  */
 static void
-wakeTimeoutCallback (void *param) {
-    // We're using "param != NULL" as a cancellation mechanism
-    if (s_callbacks.version >= 13) {
-        if (param == NULL) {
-            int ret;
-            ret = pthread_mutex_lock(&s_wakeLockCountMutex);
-            assert(ret == 0);
-            s_wakelock_count = 0;
-            release_wake_lock(ANDROID_WAKE_LOCK_NAME);
-            ret = pthread_mutex_unlock(&s_wakeLockCountMutex);
-            assert(ret == 0);
+coalesceFlushCallback(void *param) {
+    pthread_mutex_lock(&s_coalesceMutex);
+    // a flush rescheduled by onScreenStateChanged() may have replaced this one
+    if ((uintptr_t) param == s_coalesceFlushGeneration) {
+        s_coalesce_flush_info = NULL;
+    }
+    pthread_mutex_unlock(&s_coalesceMutex);
+
+    for (int slotId = 0; slotId < SIM_COUNT; slotId++) {
+        for (size_t i = 0; i < NUM_ELEMS(s_coalescedUnsols); i++) {
+            CoalescedUnsol *entry = &s_coalesced[slotId][i];
+
+            pthread_mutex_lock(&s_coalesceMutex);
+            if (!entry->pending) {
+                pthread_mutex_unlock(&s_coalesceMutex);
+                continue;
+            }
+            void *data = entry->data;
+            size_t datalen = entry->datalen;
+            entry->data = NULL;
+            entry->datalen = 0;
+            entry->pending = false;
+            s_coalesceFlushed++;
+            pthread_mutex_unlock(&s_coalesceMutex);
+
+            int ret = deliverUnsolResponse(
+                    s_coalescedUnsols[i].unsolResponse - RIL_UNSOL_RESPONSE_BASE,
+                    data, datalen, (RIL_SOCKET_ID) slotId);
+
+            if (ret == 0 && s_coalescedUnsols[i].dropRepeats) {
+                pthread_mutex_lock(&s_coalesceMutex);
+                free(entry->lastData);
+                entry->lastData = data;
+                entry->lastDataLen = datalen;
+                entry->delivered = true;
+                data = NULL;
+                pthread_mutex_unlock(&s_coalesceMutex);
+            }
+            free(data);
         }
-    } else {
-        if (param == NULL) {
-            releaseWakeLock();
+    }
+
+    // Indications held again while flushing keep the wake lock until the next flush
+    pthread_mutex_lock(&s_coalesceMutex);
+    bool wakePending = false;
+    for (int slotId = 0; slotId < SIM_COUNT; slotId++) {
+        for (size_t i = 0; i < NUM_ELEMS(s_coalescedUnsols); i++) {
+            int unsolResponseIndex = s_coalescedUnsols[i].unsolResponse
+                    - RIL_UNSOL_RESPONSE_BASE;
+            if (s_coalesced[slotId][i].pending
+                    && s_unsolResponses[unsolResponseIndex].wakeType == WAKE_PARTIAL) {
+                wakePending = true;
+            }
         }
     }
+    if (s_coalesceWakeLockHeld && !wakePending) {
+        release_wake_lock(ANDROID_COALESCE_WAKE_LOCK_NAME);
+        s_coalesceWakeLockHeld = false;
+    }
+    pthread_mutex_unlock(&s_coalesceMutex);
+}
+
+/**
+ * Called when the framework reports the screen state, flushes held
+ * indications as soon as the screen comes on.
+ */
+void
+onScreenStateChanged(bool screenOn) {
+    pthread_mutex_lock(&s_coalesceMutex);
+
+    bool wasOn = s_screenOn;
+    s_screenOn = screenOn;
+
+    if (screenOn && !wasOn && s_coalesce_flush_info != NULL) {
+        cancelTimedCallback(s_coalesce_flush_info);
+        s_coalesce_flush_info = internalRequestTimedCallback(coalesceFlushCallback,
+                (void *) ++s_coalesceFlushGeneration, NULL);
+    }
+
+    pthread_mutex_unlock(&s_coalesceMutex);
+}
+
+/**
+ * Write the indication coalescing counters to fd.
+ */
+void
+dumpUnsolCoalescing(int fd) {
+    pthread_mutex_lock(&s_coalesceMutex);
+    dprintf(fd, "Indication coalescing: window=%ldms screenOffWindow=%ldms screenOn=%d"
+            " held=%" PRIu64 " superseded=%" PRIu64 " repeatsDropped=%" PRIu64
+            " flushed=%" PRIu64 "\n",
+            (long) (s_coalesceWindow.tv_sec * 1000 + s_coalesceWindow.tv_usec / 1000),
+            (long) (s_coalesceScreenOffWindow.tv_sec * 1000
+                    + s_coalesceScreenOffWindow.tv_usec / 1000),
+            s_screenOn, s_coalesceHeld, s_coalesceSuperseded, s_coalesceRepeatsDropped,
+            s_coalesceFlushed);
+    pthread_mutex_unlock(&s_coalesceMutex);
 }
 
 #if defined(ANDROID_MULTI_SIM)
@@ -743,8 +1125,6 @@ void RIL_onUnsolicitedResponse(int unsolResponse, const void *data,
 #endif
 {
     int unsolResponseIndex;
-    int ret;
-    bool shouldScheduleTimeout = false;
     RIL_SOCKET_ID soc_id = RIL_SOCKET_1;
 
 #if defined(ANDROID_MULTI_SIM)
@@ -758,6 +1138,8 @@ void RIL_onUnsolicitedResponse(int unsolResponse, const void *data,
         return;
     }
 
+    ril_recorder_unsol(unsolResponse, (int) soc_id, data, datalen);
+
     unsolResponseIndex = unsolResponse - RIL_UNSOL_RESPONSE_BASE;
 
     if ((unsolResponseIndex < 0)
@@ -766,6 +1148,25 @@ void RIL_onUnsolicitedResponse(int unsolResponse, const void *data,
         return;
     }
 
+    if (holdCoalescedUnsol(unsolResponse, data, datalen, soc_id)) {
+        return;
+    }
+
+    deliverUnsolResponse(unsolResponseIndex, data, datalen, soc_id);
+}
+
+/**
+ * Hand an unsolicited response to the framework, taking care of wake locks.
+ *
+ * @return 0 if the framework got it
+ */
+static int
+deliverUnsolResponse(int unsolResponseIndex, const void *data, size_t datalen,
+        RIL_SOCKET_ID soc_id) {
+    int unsolResponse = unsolResponseIndex + RIL_UNSOL_RESPONSE_BASE;
+    int ret = 0;
+    bool shouldScheduleTimeout = false;
+
     // Grab a wake lock if needed for this reponse,
     // as we exit we'll either release it immediately
     // or set a timer to release it later.
@@ -792,19 +1193,15 @@ void RIL_onUnsolicitedResponse(int unsolResponse, const void *data,
         responseType = RESPONSE_UNSOLICITED;
     }
 
-    pthread_rwlock_t *radioServiceRwlockPtr = radio::getRadioServiceRwlock((int) soc_id);
-    int rwlockRet;
-
     if (unsolResponse == RIL_UNSOL_NITZ_TIME_RECEIVED) {
-        // get a write lock in caes of NITZ since setNitzTimeReceived() is called
-        rwlockRet = pthread_rwlock_wrlock(radioServiceRwlockPtr);
-        assert(rwlockRet == 0);
+        // atomic store, so a read lock is enough for NITZ as well
         radio::setNitzTimeReceived((int) soc_id, android::elapsedRealtime());
-    } else {
-        rwlockRet = pthread_rwlock_rdlock(radioServiceRwlockPtr);
-        assert(rwlockRet == 0);
     }
 
+    pthread_rwlock_t *radioServiceRwlockPtr = radio::getRadioServiceRwlock((int) soc_id);
+    int rwlockRet = pthread_rwlock_rdlock(radioServiceRwlockPtr);
+    assert(rwlockRet == 0);
+
     if (s_unsolResponses[unsolResponseIndex].responseFunction) {
         ret = s_unsolResponses[unsolResponseIndex].responseFunction(
                 (int) soc_id, responseType, 0, RIL_E_SUCCESS, const_cast<void*>(data),
@@ -816,18 +1213,10 @@ void RIL_onUnsolicitedResponse(int unsolResponse, const void *data,
 
     if (s_callbacks.version < 13) {
         if (shouldScheduleTimeout) {
-            UserCallbackInfo *p_info = internalRequestTimedCallback(wakeTimeoutCallback, NULL,
-                    &TIMEVAL_WAKE_TIMEOUT);
-
-            if (p_info == NULL) {
-                goto error_exit;
-            } else {
-                // Cancel the previous request
-                if (s_last_wake_timeout_info != NULL) {
-                    s_last_wake_timeout_info->userParam = (void *)1;
-                }
-                s_last_wake_timeout_info = p_info;
-            }
+            // Supersedes the previous timeout
+            pthread_mutex_lock(&s_wakeLockCountMutex);
+            extendWakeTimeoutLocked();
+            pthread_mutex_unlock(&s_wakeLockCountMutex);
         }
     }
 
@@ -857,12 +1246,13 @@ void RIL_onUnsolicitedResponse(int unsolResponse, const void *data,
     }
 
     // Normal exit
-    return;
+    return ret;
 
 error_exit:
     if (shouldScheduleTimeout) {
         releaseWakeLock();
     }
+    return ret;
 }
 
 /** FIXME generalize this if you track UserCAllbackInfo, clear it
@@ -875,7 +1265,7 @@ internalRequestTimedCallback (RIL_TimedCallback callback, void *param,
     struct timeval myRelativeTime;
     UserCallbackInfo *p_info;
 
-    p_info = (UserCallbackInfo *) calloc(1, sizeof(UserCallbackInfo));
+    p_info = s_userCallbackInfoPool.alloc();
     if (p_info == NULL) {
         RLOGE("Memory allocation failed in internalRequestTimedCallback");
         return p_info;
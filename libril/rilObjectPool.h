@@ -0,0 +1,187 @@
+/*
+* Copyright (C) 2018 The LineageOS Project
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef RIL_OBJECT_POOL_H_INCLUDED
+#define RIL_OBJECT_POOL_H_INCLUDED
+
+#include <atomic>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Usage counters of a Ril_pool.
+ */
+typedef struct RilPoolStats {
+    uint32_t capacity;
+    uint32_t inUse;
+    uint32_t highWater;
+    uint64_t allocations;
+    uint64_t heapFallbacks;
+} RilPoolStats;
+
+/**
+ * Template fixed-size object pool for plain structs allocated on hot paths.
+ * <p>
+ * This class performs the following functions :
+ * <ul>
+ *     <li>Allocate a zeroed object from a lock-free freelist.
+ *     <li>Fall back to the heap once the pool is exhausted.
+ *     <li>Track usage and high-water-mark statistics.
+ * </ul>
+ * Objects must be returned with release(), never free().
+ */
+
+template <typename T, uint32_t N>
+class Ril_pool {
+
+   /**
+     * Freelist terminator.
+     */
+    static const uint32_t EMPTY = UINT32_MAX;
+
+   /**
+     * Pooled objects.
+     */
+    T items[N];
+
+   /**
+     * Next free index for each free object.
+     */
+    std::atomic<uint32_t> next[N];
+
+   /**
+     * Freelist head, index in the low 32 bits and an ABA tag in the high 32 bits.
+     */
+    std::atomic<uint64_t> head;
+
+    std::atomic<uint32_t> inUse;
+    std::atomic<uint32_t> highWater;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> heapFallbacks;
+
+    public:
+
+       /**
+         * Get a zeroed object, from the pool if one is free or else the heap.
+         *
+         * @return object, or NULL if the heap is exhausted as well.
+         */
+        T* alloc(void);
+
+       /**
+         * Return an object obtained from alloc().
+         *
+         * @param Object to be released.
+         */
+        void release(T* item);
+
+       /**
+         * Snapshot the usage counters.
+         *
+         * @param Destination of the counters.
+         */
+        void getStats(RilPoolStats* stats);
+
+       /**
+         * Pool constructor.
+         */
+        Ril_pool(void);
+};
+
+template <typename T, uint32_t N>
+Ril_pool<T, N>::Ril_pool(void) {
+    for (uint32_t i = 0; i < N; i++) {
+        next[i].store(i + 1 < N ? i + 1 : EMPTY, std::memory_order_relaxed);
+    }
+    head.store(0, std::memory_order_relaxed);
+    inUse.store(0, std::memory_order_relaxed);
+    highWater.store(0, std::memory_order_relaxed);
+    allocations.store(0, std::memory_order_relaxed);
+    heapFallbacks.store(0, std::memory_order_relaxed);
+}
+
+template <typename T, uint32_t N>
+T* Ril_pool<T, N>::alloc(void) {
+    T* item = NULL;
+    uint64_t oldHead = head.load(std::memory_order_acquire);
+
+    for (;;) {
+        uint32_t index = (uint32_t) oldHead;
+        if (index == EMPTY) {
+            break;
+        }
+        uint64_t newHead = (((oldHead >> 32) + 1) << 32)
+                | next[index].load(std::memory_order_relaxed);
+        if (head.compare_exchange_weak(oldHead, newHead,
+                std::memory_order_acq_rel, std::memory_order_acquire)) {
+            item = &items[index];
+            memset(item, 0, sizeof(T));
+            break;
+        }
+    }
+
+    if (item == NULL) {
+        item = (T *) calloc(1, sizeof(T));
+        if (item == NULL) {
+            return NULL;
+        }
+        heapFallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    uint32_t used = inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+    uint32_t high = highWater.load(std::memory_order_relaxed);
+    while (used > high && !highWater.compare_exchange_weak(high, used,
+            std::memory_order_relaxed)) {
+    }
+
+    return item;
+}
+
+template <typename T, uint32_t N>
+void Ril_pool<T, N>::release(T* item) {
+    if (item == NULL) {
+        return;
+    }
+
+    inUse.fetch_sub(1, std::memory_order_relaxed);
+
+    if (item < &items[0] || item >= &items[N]) {
+        free(item);
+        return;
+    }
+
+    uint32_t index = (uint32_t) (item - &items[0]);
+    uint64_t oldHead = head.load(std::memory_order_relaxed);
+    uint64_t newHead;
+    do {
+        next[index].store((uint32_t) oldHead, std::memory_order_relaxed);
+        newHead = (((oldHead >> 32) + 1) << 32) | index;
+    } while (!head.compare_exchange_weak(oldHead, newHead,
+            std::memory_order_release, std::memory_order_relaxed));
+}
+
+template <typename T, uint32_t N>
+void Ril_pool<T, N>::getStats(RilPoolStats* stats) {
+    stats->capacity = N;
+    stats->inUse = inUse.load(std::memory_order_relaxed);
+    stats->highWater = highWater.load(std::memory_order_relaxed);
+    stats->allocations = allocations.load(std::memory_order_relaxed);
+    stats->heapFallbacks = heapFallbacks.load(std::memory_order_relaxed);
+}
+
+#endif /* RIL_OBJECT_POOL_H_INCLUDED */
@@ -16,6 +16,10 @@
 
 #include "pb_decode.h"
 #include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <string.h>
 #include <hardware/ril/librilutils/proto/sap-api.pb.h>
 #include <utils/Log.h>
 
@@ -165,3 +169,369 @@ int Ril_queue<T>::empty(void) {
         return 0;
     }
 }
+
+/**
+ * Lock-free multi-producer/single-consumer variant of Ril_queue.
+ * <p>
+ * enqueue() never blocks: producers link requests into an intrusive inbox
+ * with a single atomic exchange. The consumer side (dequeue() and
+ * checkAndDequeue()) is serialized by its own mutex, drains the inbox into
+ * a FIFO list and keeps a (message id, token) index over it, so
+ * checkAndDequeue() does not walk the queue. Unlike Ril_queue, dequeue()
+ * returns requests in the order they were enqueued.
+ * <p>
+ * T must provide token, curr->id and the p_next and p_prev links.
+ */
+
+template <typename T>
+class Ril_mpsc_queue {
+
+   /**
+     * Placeholder node that keeps the inbox non-empty.
+     */
+    T stub;
+
+   /**
+     * Most recently enqueued request, swapped in by producers.
+     */
+    T *inboxHead;
+
+   /**
+     * Oldest request in the inbox, only touched by the consumer.
+     */
+    T *inboxTail;
+
+   /**
+     * Mutex serializing the consumer side.
+     */
+    pthread_mutex_t consumer_mutex;
+
+   /**
+     * Counts enqueued requests, so dequeue() can sleep without producers locking.
+     */
+    sem_t available;
+
+   /**
+     * Drained requests in FIFO order.
+     */
+    T *front;
+    T *back;
+
+   /**
+     * Open addressed (message id, token) index over the drained requests.
+     */
+    T **index;
+    size_t indexCapacity;
+    size_t indexCount;
+
+   /**
+     * Drained requests left out of the index because it could not grow.
+     */
+    size_t indexMisses;
+
+    static uint64_t key(MsgId id, int token);
+    size_t slot(uint64_t k);
+    size_t probeDistance(size_t from, size_t to);
+    T *indexFind(MsgId id, int token, bool remove);
+    void indexInsert(T *request);
+    void indexRemove(size_t pos);
+    T *inboxPop(bool *stalled);
+    bool drain(void);
+    void unlink(T *request);
+
+    public:
+
+       /**
+         * Remove the oldest element of the queue, waiting for one if empty.
+         *
+         * @return oldest element of the queue.
+         */
+        T* dequeue(void);
+
+       /**
+         * Add a request to the back of the queue.
+         *
+         * @param Request to be added.
+         */
+        void enqueue(T* request);
+
+       /**
+         * Check if the queue is empty.
+         */
+        int empty(void);
+
+       /**
+         * Check and remove an element with a particular message id and token.
+         *
+         * @param Request message id.
+         * @param Request token.
+         */
+        int checkAndDequeue( MsgId id, int token);
+
+       /**
+         * Queue constructor.
+         */
+        Ril_mpsc_queue(void);
+};
+
+template <typename T>
+Ril_mpsc_queue<T>::Ril_mpsc_queue(void) {
+    memset(&stub, 0, sizeof(stub));
+    inboxHead = &stub;
+    inboxTail = &stub;
+    pthread_mutex_init(&consumer_mutex, NULL);
+    sem_init(&available, 0, 0);
+    front = NULL;
+    back = NULL;
+    index = NULL;
+    indexCapacity = 0;
+    indexCount = 0;
+    indexMisses = 0;
+}
+
+template <typename T>
+void Ril_mpsc_queue<T>::enqueue(T* request) {
+    __atomic_store_n(&request->p_next, (T *) NULL, __ATOMIC_RELAXED);
+    T *prev = __atomic_exchange_n(&inboxHead, request, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&prev->p_next, request, __ATOMIC_RELEASE);
+    sem_post(&available);
+}
+
+template <typename T>
+uint64_t Ril_mpsc_queue<T>::key(MsgId id, int token) {
+    return ((uint64_t) (uint32_t) id << 32) | (uint32_t) token;
+}
+
+template <typename T>
+size_t Ril_mpsc_queue<T>::slot(uint64_t k) {
+    // multiply 32 bit halves in 64 bits so nothing wraps: libril is built
+    // with the integer sanitizer
+    uint64_t h = (uint64_t) (uint32_t) k * 2654435761u
+            + (uint64_t) (uint32_t) (k >> 32) * 40503u;
+    return (size_t) (h >> 16) & (indexCapacity - 1);
+}
+
+template <typename T>
+size_t Ril_mpsc_queue<T>::probeDistance(size_t from, size_t to) {
+    return to >= from ? to - from : to + indexCapacity - from;
+}
+
+template <typename T>
+void Ril_mpsc_queue<T>::indexInsert(T *request) {
+    if ((indexCount + 1) * 2 > indexCapacity) {
+        size_t oldCapacity = indexCapacity;
+        T **oldIndex = index;
+        size_t capacity = oldCapacity > 0 ? oldCapacity * 2 : 16;
+        T **newIndex = (T **) calloc(capacity, sizeof(T *));
+        if (newIndex == NULL) {
+            RLOGE("Ril_mpsc_queue: OOM growing index");
+            if (indexCount + 1 >= indexCapacity) {
+                // leave it to the linear fallback in indexFind()
+                indexMisses++;
+                return;
+            }
+        } else {
+            index = newIndex;
+            indexCapacity = capacity;
+            indexCount = 0;
+            for (size_t i = 0; i < oldCapacity; i++) {
+                if (oldIndex[i] != NULL) {
+                    indexInsert(oldIndex[i]);
+                }
+            }
+            free(oldIndex);
+        }
+    }
+
+    size_t pos = slot(key(request->curr->id, request->token));
+    while (index[pos] != NULL) {
+        pos = (pos + 1) & (indexCapacity - 1);
+    }
+    index[pos] = request;
+    indexCount++;
+}
+
+template <typename T>
+void Ril_mpsc_queue<T>::indexRemove(size_t pos) {
+    // backward shift deletion keeps linear probe chains intact
+    size_t mask = indexCapacity - 1;
+    size_t next = (pos + 1) & mask;
+    while (index[next] != NULL) {
+        size_t home = slot(key(index[next]->curr->id, index[next]->token));
+        if (probeDistance(home, next) >= probeDistance(pos, next)) {
+            index[pos] = index[next];
+            pos = next;
+        }
+        next = (next + 1) & mask;
+    }
+    index[pos] = NULL;
+    indexCount--;
+}
+
+template <typename T>
+T *Ril_mpsc_queue<T>::indexFind(MsgId id, int token, bool remove) {
+    if (indexCapacity > 0) {
+        for (size_t pos = slot(key(id, token)); index[pos] != NULL;
+                pos = (pos + 1) & (indexCapacity - 1)) {
+            T *temp = index[pos];
+            if (token == temp->token && id == temp->curr->id) {
+                if (remove) {
+                    indexRemove(pos);
+                }
+                return temp;
+            }
+        }
+    }
+    if (indexMisses > 0) {
+        for (T *temp = front; temp != NULL; temp = temp->p_next) {
+            if (token == temp->token && id == temp->curr->id) {
+                if (remove) {
+                    indexMisses--;
+                }
+                return temp;
+            }
+        }
+    }
+    return NULL;
+}
+
+template <typename T>
+T *Ril_mpsc_queue<T>::inboxPop(bool *stalled) {
+    T *tail = inboxTail;
+    T *next = __atomic_load_n(&tail->p_next, __ATOMIC_ACQUIRE);
+
+    if (tail == &stub) {
+        if (next == NULL) {
+            return NULL;
+        }
+        inboxTail = next;
+        tail = next;
+        next = __atomic_load_n(&next->p_next, __ATOMIC_ACQUIRE);
+    }
+    if (next != NULL) {
+        inboxTail = next;
+        return tail;
+    }
+    if (tail != __atomic_load_n(&inboxHead, __ATOMIC_ACQUIRE)) {
+        // a producer swapped the head but has not linked it yet
+        *stalled = true;
+        return NULL;
+    }
+    enqueue(&stub);
+    // the stub does not count as available
+    sem_trywait(&available);
+    next = __atomic_load_n(&tail->p_next, __ATOMIC_ACQUIRE);
+    if (next != NULL) {
+        inboxTail = next;
+        return tail;
+    }
+    *stalled = true;
+    return NULL;
+}
+
+template <typename T>
+bool Ril_mpsc_queue<T>::drain(void) {
+    bool stalled = false;
+    T *request;
+
+    while ((request = inboxPop(&stalled)) != NULL) {
+        request->p_next = NULL;
+        request->p_prev = back;
+        if (back != NULL) {
+            back->p_next = request;
+        } else {
+            front = request;
+        }
+        back = request;
+        indexInsert(request);
+    }
+    return !stalled;
+}
+
+template <typename T>
+void Ril_mpsc_queue<T>::unlink(T *request) {
+    if (request->p_prev != NULL) {
+        request->p_prev->p_next = request->p_next;
+    } else {
+        front = request->p_next;
+    }
+    if (request->p_next != NULL) {
+        request->p_next->p_prev = request->p_prev;
+    } else {
+        back = request->p_prev;
+    }
+    request->p_next = NULL;
+    request->p_prev = NULL;
+}
+
+template <typename T>
+T* Ril_mpsc_queue<T>::dequeue(void) {
+    T* temp = NULL;
+
+    while (temp == NULL) {
+        while (sem_wait(&available) != 0) {
+        }
+
+        pthread_mutex_lock(&consumer_mutex);
+        drain();
+        if (front != NULL) {
+            temp = front;
+            bool indexed = false;
+            if (indexCapacity > 0) {
+                for (size_t pos = slot(key(temp->curr->id, temp->token)); index[pos] != NULL;
+                        pos = (pos + 1) & (indexCapacity - 1)) {
+                    if (index[pos] == temp) {
+                        indexRemove(pos);
+                        indexed = true;
+                        break;
+                    }
+                }
+            }
+            if (!indexed) {
+                indexMisses--;
+            }
+            unlink(temp);
+        }
+        pthread_mutex_unlock(&consumer_mutex);
+    }
+
+    return temp;
+}
+
+template <typename T>
+int Ril_mpsc_queue<T>::checkAndDequeue(MsgId id, int token) {
+    int ret = 0;
+
+    pthread_mutex_lock(&consumer_mutex);
+
+    for (;;) {
+        bool complete = drain();
+        T *temp = indexFind(id, token, true);
+        if (temp != NULL) {
+            ret = 1;
+            unlink(temp);
+            free(temp);
+        }
+        if (ret || complete) {
+            break;
+        }
+        // the request may be behind a producer that is mid-enqueue
+        sched_yield();
+    }
+
+    pthread_mutex_unlock(&consumer_mutex);
+
+    return ret;
+}
+
+template <typename T>
+int Ril_mpsc_queue<T>::empty(void) {
+    int ret;
+
+    pthread_mutex_lock(&consumer_mutex);
+    drain();
+    ret = (front == NULL) ? 1 : 0;
+    pthread_mutex_unlock(&consumer_mutex);
+
+    return ret;
+}
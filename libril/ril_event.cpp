@@ -26,6 +26,9 @@
 #include <string.h>
 #include <sys/time.h>
 #include <time.h>
+#ifdef RIL_EVENT_USE_EPOLL
+#include <sys/epoll.h>
+#endif
 
 #include <pthread.h>
 static pthread_mutex_t listMutex;
@@ -65,11 +68,27 @@ static pthread_mutex_t listMutex;
     } while(0);
 #endif
 
+#ifdef RIL_EVENT_USE_EPOLL
+// Max number of ready events harvested by a single epoll_wait()
+#define EPOLL_MAX_EVENTS 16
+
+static int epollFd = -1;
+
+// Watched events indexed by fd, grown on demand. An fd whose slot is NULL
+// is no longer watched, so stale epoll results for it are dropped.
+static struct ril_event ** watch_table = NULL;
+static int watch_table_size = 0;
+#else
 static fd_set readFds;
 static int nfds = 0;
 
 static struct ril_event * watch_table[MAX_FD_EVENTS];
-static struct ril_event timer_list;
+#endif
+// Binary min-heap of armed timers ordered by timeout. Each event records
+// its slot in heap_index so it can be re-armed or cancelled in O(log n).
+static struct ril_event ** timer_heap = NULL;
+static int timer_count = 0;
+static int timer_capacity = 0;
 static struct ril_event pending_list;
 
 #define DEBUG 0
@@ -82,6 +101,7 @@ static void dump_event(struct ril_event * ev)
     dlog("     next    = %x", (unsigned int)ev->next);
     dlog("     prev    = %x", (unsigned int)ev->prev);
     dlog("     fd      = %d", ev->fd);
+    dlog("     heap    = %d", ev->heap_index);
     dlog("     pers    = %d", ev->persist);
     dlog("     timeout = %ds + %dus", (int)ev->timeout.tv_sec, (int)ev->timeout.tv_usec);
     dlog("     func    = %x", (unsigned int)ev->func);
@@ -131,6 +151,39 @@ static void removeFromList(struct ril_event * ev)
 }
 
 
+#ifdef RIL_EVENT_USE_EPOLL
+static bool growWatchTable(int fd)
+{
+    int size = watch_table_size > 0 ? watch_table_size : MAX_FD_EVENTS;
+    while (size <= fd) {
+        size *= 2;
+    }
+
+    struct ril_event ** table = (struct ril_event **)
+            realloc(watch_table, size * sizeof(struct ril_event *));
+    if (table == NULL) {
+        return false;
+    }
+    memset(table + watch_table_size, 0,
+            (size - watch_table_size) * sizeof(struct ril_event *));
+    watch_table = table;
+    watch_table_size = size;
+    dlog("~~~~ watch table grown to %d ~~~~", size);
+    return true;
+}
+
+static void removeWatch(struct ril_event * ev, int index)
+{
+    dlog("~~~~ +removeWatch ~~~~");
+    watch_table[index] = NULL;
+    ev->index = -1;
+
+    if (epoll_ctl(epollFd, EPOLL_CTL_DEL, ev->fd, NULL) < 0) {
+        RLOGE("ril_event: epoll_ctl(DEL) of fd %d failed (%d)", ev->fd, errno);
+    }
+    dlog("~~~~ -removeWatch ~~~~");
+}
+#else
 static void removeWatch(struct ril_event * ev, int index)
 {
     dlog("~~~~ +removeWatch ~~~~");
@@ -155,30 +208,122 @@ static void removeWatch(struct ril_event * ev, int index)
     dlog("~~~~ -removeWatch ~~~~");
 }
 
+#endif
+
+static void heapSet(int i, struct ril_event * ev)
+{
+    timer_heap[i] = ev;
+    ev->heap_index = i;
+}
+
+static void heapSiftUp(int i)
+{
+    struct ril_event * ev = timer_heap[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!timercmp(&ev->timeout, &timer_heap[parent]->timeout, <)) {
+            break;
+        }
+        heapSet(i, timer_heap[parent]);
+        i = parent;
+    }
+    heapSet(i, ev);
+}
+
+static void heapSiftDown(int i)
+{
+    struct ril_event * ev = timer_heap[i];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= timer_count) {
+            break;
+        }
+        if (child + 1 < timer_count
+                && timercmp(&timer_heap[child + 1]->timeout, &timer_heap[child]->timeout, <)) {
+            child++;
+        }
+        if (!timercmp(&timer_heap[child]->timeout, &ev->timeout, <)) {
+            break;
+        }
+        heapSet(i, timer_heap[child]);
+        i = child;
+    }
+    heapSet(i, ev);
+}
+
+static bool heapInsert(struct ril_event * ev)
+{
+    if (timer_count == timer_capacity) {
+        int capacity = timer_capacity > 0 ? timer_capacity * 2 : MAX_FD_EVENTS;
+        struct ril_event ** heap = (struct ril_event **)
+                realloc(timer_heap, capacity * sizeof(struct ril_event *));
+        if (heap == NULL) {
+            return false;
+        }
+        timer_heap = heap;
+        timer_capacity = capacity;
+    }
+    heapSet(timer_count++, ev);
+    heapSiftUp(ev->heap_index);
+    return true;
+}
+
+static void heapRemove(struct ril_event * ev)
+{
+    int i = ev->heap_index;
+    ev->heap_index = -1;
+    timer_count--;
+    if (i != timer_count) {
+        heapSet(i, timer_heap[timer_count]);
+        heapSiftDown(i);
+        heapSiftUp(i);
+    }
+    timer_heap[timer_count] = NULL;
+}
+
 static void processTimeouts()
 {
     dlog("~~~~ +processTimeouts ~~~~");
     MUTEX_ACQUIRE();
     struct timeval now;
-    struct ril_event * tev = timer_list.next;
-    struct ril_event * next;
 
     getNow(&now);
-    // walk list, see if now >= ev->timeout for any events
+    // pop every timer with now >= ev->timeout off the top of the heap
 
     dlog("~~~~ Looking for timers <= %ds + %dus ~~~~", (int)now.tv_sec, (int)now.tv_usec);
-    while ((tev != &timer_list) && (timercmp(&now, &tev->timeout, >))) {
+    while ((timer_count > 0) && (timercmp(&now, &timer_heap[0]->timeout, >))) {
         // Timer expired
         dlog("~~~~ firing timer ~~~~");
-        next = tev->next;
-        removeFromList(tev);
+        struct ril_event * tev = timer_heap[0];
+        heapRemove(tev);
         addToList(tev, &pending_list);
-        tev = next;
     }
     MUTEX_RELEASE();
     dlog("~~~~ -processTimeouts ~~~~");
 }
 
+#ifdef RIL_EVENT_USE_EPOLL
+static void processReadReadies(struct epoll_event * events, int n)
+{
+    dlog("~~~~ +processReadReadies (%d) ~~~~", n);
+    MUTEX_ACQUIRE();
+
+    for (int i = 0; i < n; i++) {
+        int fd = events[i].data.fd;
+        struct ril_event * rev = (fd < watch_table_size) ? watch_table[fd] : NULL;
+        // event may have been removed since epoll_wait() returned
+        if (rev != NULL) {
+            addToList(rev, &pending_list);
+            if (rev->persist == false) {
+                removeWatch(rev, fd);
+            }
+        }
+    }
+
+    MUTEX_RELEASE();
+    dlog("~~~~ -processReadReadies (%d) ~~~~", n);
+}
+#else
 static void processReadReadies(fd_set * rfds, int n)
 {
     dlog("~~~~ +processReadReadies (%d) ~~~~", n);
@@ -199,37 +344,47 @@ static void processReadReadies(fd_set * rfds, int n)
     dlog("~~~~ -processReadReadies (%d) ~~~~", n);
 }
 
+#endif
+
 static void firePending()
 {
     dlog("~~~~ +firePending ~~~~");
-    struct ril_event * ev = pending_list.next;
-    while (ev != &pending_list) {
-        struct ril_event * next = ev->next;
+    // Events are unlinked under the lock so ril_timer_del() can still pull a
+    // timer out of pending_list up until the moment it is fired.
+    MUTEX_ACQUIRE();
+    while (pending_list.next != &pending_list) {
+        struct ril_event * ev = pending_list.next;
         removeFromList(ev);
+        MUTEX_RELEASE();
         ev->func(ev->fd, 0, ev->param);
-        ev = next;
+        MUTEX_ACQUIRE();
     }
+    MUTEX_RELEASE();
     dlog("~~~~ -firePending ~~~~");
 }
 
 static int calcNextTimeout(struct timeval * tv)
 {
-    struct ril_event * tev = timer_list.next;
     struct timeval now;
+    struct timeval next;
 
-    getNow(&now);
-
-    // Sorted list, so calc based on first node
-    if (tev == &timer_list) {
+    MUTEX_ACQUIRE();
+    // Heap, so calc based on the root
+    if (timer_count == 0) {
         // no pending timers
+        MUTEX_RELEASE();
         return -1;
     }
+    next = timer_heap[0]->timeout;
+    MUTEX_RELEASE();
+
+    getNow(&now);
 
     dlog("~~~~ now = %ds + %dus ~~~~", (int)now.tv_sec, (int)now.tv_usec);
     dlog("~~~~ next = %ds + %dus ~~~~",
-            (int)tev->timeout.tv_sec, (int)tev->timeout.tv_usec);
-    if (timercmp(&tev->timeout, &now, >)) {
-        timersub(&tev->timeout, &now, tv);
+            (int)next.tv_sec, (int)next.tv_usec);
+    if (timercmp(&next, &now, >)) {
+        timersub(&next, &now, tv);
     } else {
         // timer already expired.
         tv->tv_sec = tv->tv_usec = 0;
@@ -242,10 +397,17 @@ void ril_event_init()
 {
     MUTEX_INIT();
 
+#ifdef RIL_EVENT_USE_EPOLL
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        RLOGE("ril_event: epoll_create1 error (%d)", errno);
+    }
+    growWatchTable(0);
+#else
     FD_ZERO(&readFds);
-    init_list(&timer_list);
-    init_list(&pending_list);
     memset(watch_table, 0, sizeof(watch_table));
+#endif
+    init_list(&pending_list);
 }
 
 // Initialize an event
@@ -255,6 +417,7 @@ void ril_event_set(struct ril_event * ev, int fd, bool persist, ril_event_cb fun
     memset(ev, 0, sizeof(struct ril_event));
     ev->fd = fd;
     ev->index = -1;
+    ev->heap_index = -1;
     ev->persist = persist;
     ev->func = func;
     ev->param = param;
@@ -262,6 +425,33 @@ void ril_event_set(struct ril_event * ev, int fd, bool persist, ril_event_cb fun
 }
 
 // Add event to watch list
+#ifdef RIL_EVENT_USE_EPOLL
+void ril_event_add(struct ril_event * ev)
+{
+    dlog("~~~~ +ril_event_add ~~~~");
+    MUTEX_ACQUIRE();
+    if (ev->fd < 0 || (ev->fd >= watch_table_size && !growWatchTable(ev->fd))) {
+        RLOGE("ril_event: cannot watch fd %d", ev->fd);
+    } else if (watch_table[ev->fd] != NULL) {
+        RLOGE("ril_event: fd %d is already watched", ev->fd);
+    } else {
+        struct epoll_event eev;
+        memset(&eev, 0, sizeof(eev));
+        eev.events = EPOLLIN;
+        eev.data.fd = ev->fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, ev->fd, &eev) < 0) {
+            RLOGE("ril_event: epoll_ctl(ADD) of fd %d failed (%d)", ev->fd, errno);
+        } else {
+            watch_table[ev->fd] = ev;
+            ev->index = ev->fd;
+            dlog("~~~~ added fd %d ~~~~", ev->fd);
+            dump_event(ev);
+        }
+    }
+    MUTEX_RELEASE();
+    dlog("~~~~ -ril_event_add ~~~~");
+}
+#else
 void ril_event_add(struct ril_event * ev)
 {
     dlog("~~~~ +ril_event_add ~~~~");
@@ -281,43 +471,67 @@ void ril_event_add(struct ril_event * ev)
     MUTEX_RELEASE();
     dlog("~~~~ -ril_event_add ~~~~");
 }
+#endif
 
-// Add timer event
+// Add timer event, or re-arm it if it is already pending
 void ril_timer_add(struct ril_event * ev, struct timeval * tv)
 {
     dlog("~~~~ +ril_timer_add ~~~~");
     MUTEX_ACQUIRE();
 
-    struct ril_event * list;
     if (tv != NULL) {
-        // add to timer list
-        list = timer_list.next;
         ev->fd = -1; // make sure fd is invalid
 
         struct timeval now;
         getNow(&now);
         timeradd(&now, tv, &ev->timeout);
 
-        // keep list sorted
-        while (timercmp(&list->timeout, &ev->timeout, < )
-                && (list != &timer_list)) {
-            list = list->next;
+        if (ev->heap_index >= 0) {
+            heapSiftDown(ev->heap_index);
+            heapSiftUp(ev->heap_index);
+        } else if (!heapInsert(ev)) {
+            RLOGE("ril_event: no memory to add timer");
         }
-        // list now points to the first event older than ev
-        addToList(ev, list);
+        dump_event(ev);
     }
 
     MUTEX_RELEASE();
     dlog("~~~~ -ril_timer_add ~~~~");
 }
 
+// Cancel a timer event
+bool ril_timer_del(struct ril_event * ev)
+{
+    bool cancelled = false;
+
+    dlog("~~~~ +ril_timer_del ~~~~");
+    MUTEX_ACQUIRE();
+
+    if (ev->heap_index >= 0) {
+        heapRemove(ev);
+        cancelled = true;
+    } else if (ev->next != NULL) {
+        // expired, but not yet fired
+        removeFromList(ev);
+        cancelled = true;
+    }
+
+    MUTEX_RELEASE();
+    dlog("~~~~ -ril_timer_del (%d) ~~~~", cancelled);
+    return cancelled;
+}
+
 // Remove event from watch or timer list
 void ril_event_del(struct ril_event * ev)
 {
     dlog("~~~~ +ril_event_del ~~~~");
     MUTEX_ACQUIRE();
 
+#ifdef RIL_EVENT_USE_EPOLL
+    if (ev->index < 0 || ev->index >= watch_table_size || watch_table[ev->index] != ev) {
+#else
     if (ev->index < 0 || ev->index >= MAX_FD_EVENTS) {
+#endif
         MUTEX_RELEASE();
         return;
     }
@@ -328,6 +542,44 @@ void ril_event_del(struct ril_event * ev)
     dlog("~~~~ -ril_event_del ~~~~");
 }
 
+#ifdef RIL_EVENT_USE_EPOLL
+void ril_event_loop()
+{
+    int n;
+    int timeoutMs;
+    struct timeval tv;
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+
+    for (;;) {
+
+        if (-1 == calcNextTimeout(&tv)) {
+            // no pending timers; block indefinitely
+            dlog("~~~~ no timers; blocking indefinitely ~~~~");
+            timeoutMs = -1;
+        } else {
+            dlog("~~~~ blocking for %ds + %dus ~~~~", (int)tv.tv_sec, (int)tv.tv_usec);
+            // round up so a timer that is about to expire doesn't spin
+            timeoutMs = tv.tv_sec * 1000 + (tv.tv_usec + 999) / 1000;
+        }
+        n = epoll_wait(epollFd, events, EPOLL_MAX_EVENTS, timeoutMs);
+        dlog("~~~~ %d events fired ~~~~", n);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+
+            RLOGE("ril_event: epoll_wait error (%d)", errno);
+            // bail?
+            return;
+        }
+
+        // Check for timeouts
+        processTimeouts();
+        // Check for read-ready
+        processReadReadies(events, n);
+        // Fire away
+        firePending();
+    }
+}
+#else
 #if DEBUG
 static void printReadies(fd_set * rfds)
 {
@@ -382,3 +634,4 @@ void ril_event_loop()
         firePending();
     }
 }
+#endif
@@ -16,6 +16,8 @@
 */
 
 // Max number of fd's we watch at any one time.  Increase if necessary.
+// With RIL_EVENT_USE_EPOLL this is only the initial size of the fd table,
+// which grows as needed.
 #define MAX_FD_EVENTS 8
 
 typedef void (*ril_event_cb)(int fd, short events, void *userdata);
@@ -26,6 +28,7 @@ struct ril_event {
 
     int fd;
     int index;
+    int heap_index;
     bool persist;
     struct timeval timeout;
     ril_event_cb func;
@@ -41,9 +44,12 @@ void ril_event_set(struct ril_event * ev, int fd, bool persist, ril_event_cb fun
 // Add event to watch list
 void ril_event_add(struct ril_event * ev);
 
-// Add timer event
+// Add timer event, or re-arm it if it is already pending
 void ril_timer_add(struct ril_event * ev, struct timeval * tv);
 
+// Cancel timer event. Returns false if it already fired or is firing.
+bool ril_timer_del(struct ril_event * ev);
+
 // Remove event from watch list
 void ril_event_del(struct ril_event * ev);
 
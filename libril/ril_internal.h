@@ -77,6 +77,7 @@ typedef struct RequestInfo {
     char local;         // responses to local commands do not go back to command process
     RIL_SOCKET_ID socket_id;
     int wasAckSent;    // Indicates whether an ack was sent earlier
+    uint64_t startTime; // ril_nano_time() when the request was queued
 } RequestInfo;
 
 typedef struct CommandInfo {
@@ -87,6 +88,16 @@ typedef struct CommandInfo {
 
 RequestInfo * addRequestToList(int serial, int slotId, int request);
 
+void dumpPendingRequests(int fd);
+
+void dumpObjectPools(int fd);
+
+void dumpUnsolCoalescing(int fd);
+
+void dumpWakeLockStats(int fd);
+
+void onScreenStateChanged(bool screenOn);
+
 char * RIL_getServiceName();
 
 void releaseWakeLock();
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "RILC"
+#define ATRACE_TAG ATRACE_TAG_RIL
+
+#include <cutils/trace.h>
+#include <hardware/ril/librilutils/proto/sap-api.pb.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <telephony/librilutils.h>
+#include <telephony/ril.h>
+#include <utils/Log.h>
+#include <ril_internal.h>
+#include <ril_latency.h>
+
+namespace android {
+
+/*
+ * Latencies are kept in microseconds in log-linear (HDR style) buckets:
+ * values below 2^SUB_BUCKET_BITS get a bucket each, every power of two
+ * above that is split into 2^SUB_BUCKET_BITS buckets, so a bucket is
+ * within 12.5% of the values it holds.
+ */
+#define SUB_BUCKET_BITS 3
+#define SUB_BUCKETS (1 << SUB_BUCKET_BITS)
+#define HISTOGRAM_BUCKETS (SUB_BUCKETS + (32 - SUB_BUCKET_BITS) * SUB_BUCKETS)
+
+typedef struct LatencyHistogram {
+    uint32_t count[HISTOGRAM_BUCKETS];
+    uint64_t total;
+    uint64_t sumUs;
+    uint64_t maxUs;
+} LatencyHistogram;
+
+typedef struct RequestLatency {
+    int32_t inFlight;
+    LatencyHistogram ack;
+    LatencyHistogram complete;
+} RequestLatency;
+
+/** Index == requestNumber, allocated on first use */
+static RequestLatency *s_requestLatency[RIL_LATENCY_MAX_REQUESTS];
+
+/** Index == SAP MsgId, allocated on first use */
+static RequestLatency *s_sapLatency[RIL_LATENCY_MAX_SAP_MESSAGES];
+
+/** Totals over all requests, including untracked request numbers */
+static uint64_t s_requestsStarted;
+static uint64_t s_requestsCompleted;
+
+/** Completions and ril_nano_time() at the previous dump, for the rate since then */
+static uint64_t s_lastDumpCompleted;
+static uint64_t s_lastDumpTime;
+
+static RequestLatency *getLatency(RequestLatency **table, int size, int index) {
+    if (index < 0 || index >= size) {
+        return NULL;
+    }
+
+    RequestLatency *latency = __atomic_load_n(&table[index], __ATOMIC_ACQUIRE);
+    if (latency == NULL) {
+        RequestLatency *created = (RequestLatency *) calloc(1, sizeof(RequestLatency));
+        if (created == NULL) {
+            return NULL;
+        }
+        if (__atomic_compare_exchange_n(&table[index], &latency, created,
+                false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            latency = created;
+        } else {
+            // lost the race, latency now holds the winner
+            free(created);
+        }
+    }
+    return latency;
+}
+
+static RequestLatency *getRequestLatency(int request) {
+    return getLatency(s_requestLatency, RIL_LATENCY_MAX_REQUESTS, request);
+}
+
+static RequestLatency *getSapLatency(int msgId) {
+    return getLatency(s_sapLatency, RIL_LATENCY_MAX_SAP_MESSAGES, msgId);
+}
+
+static const char *sapMessageToString(int msgId) {
+    switch (msgId) {
+        case MsgId_RIL_SIM_SAP_CONNECT: return "SAP_CONNECT";
+        case MsgId_RIL_SIM_SAP_DISCONNECT: return "SAP_DISCONNECT";
+        case MsgId_RIL_SIM_SAP_APDU: return "SAP_APDU";
+        case MsgId_RIL_SIM_SAP_TRANSFER_ATR: return "SAP_TRANSFER_ATR";
+        case MsgId_RIL_SIM_SAP_POWER: return "SAP_POWER";
+        case MsgId_RIL_SIM_SAP_RESET_SIM: return "SAP_RESET_SIM";
+        case MsgId_RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS:
+                return "SAP_TRANSFER_CARD_READER_STATUS";
+        case MsgId_RIL_SIM_SAP_SET_TRANSFER_PROTOCOL: return "SAP_SET_TRANSFER_PROTOCOL";
+        default: return "<unknown SAP message>";
+    }
+}
+
+static int bucketOf(uint64_t us) {
+    if (us < SUB_BUCKETS) {
+        return (int) us;
+    }
+    if (us > UINT32_MAX) {
+        us = UINT32_MAX;
+    }
+    int exponent = 31 - __builtin_clz((uint32_t) us);
+    int sub = (int) (us >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return SUB_BUCKETS + (exponent - SUB_BUCKET_BITS) * SUB_BUCKETS + sub;
+}
+
+static uint64_t bucketLowerBound(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    int exponent = (bucket - SUB_BUCKETS) / SUB_BUCKETS + SUB_BUCKET_BITS;
+    uint64_t sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS);
+}
+
+static void record(LatencyHistogram *histogram, uint64_t startTime) {
+    uint64_t us = (ril_nano_time() - startTime) / 1000;
+
+    __atomic_fetch_add(&histogram->count[bucketOf(us)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->total, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->sumUs, us, __ATOMIC_RELAXED);
+
+    uint64_t max = __atomic_load_n(&histogram->maxUs, __ATOMIC_RELAXED);
+    while (us > max && !__atomic_compare_exchange_n(&histogram->maxUs, &max, us,
+            true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static uint64_t percentile(const uint32_t *count, uint64_t total, int pct) {
+    uint64_t rank = (total * pct + 99) / 100;
+    uint64_t seen = 0;
+
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += count[i];
+        if (seen >= rank) {
+            return bucketLowerBound(i);
+        }
+    }
+    return bucketLowerBound(HISTOGRAM_BUCKETS - 1);
+}
+
+static void dumpHistogram(int fd, const char *name, LatencyHistogram *histogram) {
+    uint32_t count[HISTOGRAM_BUCKETS];
+    uint64_t total = 0;
+
+    // snapshot so the percentiles are consistent with each other
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        count[i] = __atomic_load_n(&histogram->count[i], __ATOMIC_RELAXED);
+        total += count[i];
+    }
+    if (total == 0) {
+        return;
+    }
+
+    dprintf(fd, "    %-8s n=%" PRIu64 " avg=%" PRIu64 "us p50=%" PRIu64 "us p90=%" PRIu64
+            "us p99=%" PRIu64 "us max=%" PRIu64 "us\n", name, total,
+            __atomic_load_n(&histogram->sumUs, __ATOMIC_RELAXED) / total,
+            percentile(count, total, 50), percentile(count, total, 90),
+            percentile(count, total, 99),
+            __atomic_load_n(&histogram->maxUs, __ATOMIC_RELAXED));
+}
+
+void ril_latency_request_start(int request, int32_t token) {
+    __atomic_fetch_add(&s_requestsStarted, 1, __ATOMIC_RELAXED);
+
+    RequestLatency *latency = getRequestLatency(request);
+    if (latency != NULL) {
+        __atomic_fetch_add(&latency->inFlight, 1, __ATOMIC_RELAXED);
+    }
+    if (ATRACE_ENABLED()) {
+        atrace_async_begin(ATRACE_TAG, requestToString(request), token);
+    }
+}
+
+void ril_latency_request_ack(int request, uint64_t startTime) {
+    RequestLatency *latency = getRequestLatency(request);
+    if (latency != NULL) {
+        record(&latency->ack, startTime);
+    }
+}
+
+void ril_latency_request_complete(int request, int32_t token, uint64_t startTime) {
+    __atomic_fetch_add(&s_requestsCompleted, 1, __ATOMIC_RELAXED);
+
+    RequestLatency *latency = getRequestLatency(request);
+    if (latency != NULL) {
+        __atomic_fetch_sub(&latency->inFlight, 1, __ATOMIC_RELAXED);
+        record(&latency->complete, startTime);
+    }
+    if (ATRACE_ENABLED()) {
+        atrace_async_end(ATRACE_TAG, requestToString(request), token);
+    }
+}
+
+void ril_latency_sap_start(int msgId) {
+    RequestLatency *latency = getSapLatency(msgId);
+    if (latency != NULL) {
+        __atomic_fetch_add(&latency->inFlight, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void ril_latency_sap_complete(int msgId, uint64_t startTime) {
+    RequestLatency *latency = getSapLatency(msgId);
+    if (latency != NULL) {
+        __atomic_fetch_sub(&latency->inFlight, 1, __ATOMIC_RELAXED);
+        record(&latency->complete, startTime);
+    }
+}
+
+static void dumpThroughput(int fd) {
+    uint64_t now = ril_nano_time();
+    uint64_t started = __atomic_load_n(&s_requestsStarted, __ATOMIC_RELAXED);
+    uint64_t completed = __atomic_load_n(&s_requestsCompleted, __ATOMIC_RELAXED);
+    uint64_t lastCompleted = __atomic_exchange_n(&s_lastDumpCompleted, completed,
+            __ATOMIC_RELAXED);
+    uint64_t lastTime = __atomic_exchange_n(&s_lastDumpTime, now, __ATOMIC_RELAXED);
+
+    dprintf(fd, "Request throughput: started=%" PRIu64 " completed=%" PRIu64, started,
+            completed);
+    if (lastTime != 0 && now > lastTime) {
+        uint64_t elapsedMs = (now - lastTime) / 1000000;
+        uint64_t perSecond = (completed - lastCompleted) * 1000000000ULL / (now - lastTime);
+        dprintf(fd, " rate=%" PRIu64 "/s over the last %" PRIu64 "ms", perSecond, elapsedMs);
+    }
+    dprintf(fd, "\n");
+}
+
+void ril_latency_dump(int fd) {
+    dumpThroughput(fd);
+    dprintf(fd, "Request latency:\n");
+    for (int request = 0; request < RIL_LATENCY_MAX_REQUESTS; request++) {
+        RequestLatency *latency = __atomic_load_n(&s_requestLatency[request], __ATOMIC_ACQUIRE);
+        if (latency == NULL) {
+            continue;
+        }
+        dprintf(fd, "  %s in-flight=%d\n", requestToString(request),
+                __atomic_load_n(&latency->inFlight, __ATOMIC_RELAXED));
+        dumpHistogram(fd, "ack", &latency->ack);
+        dumpHistogram(fd, "complete", &latency->complete);
+    }
+
+    dprintf(fd, "SAP latency:\n");
+    for (int msgId = 0; msgId < RIL_LATENCY_MAX_SAP_MESSAGES; msgId++) {
+        RequestLatency *latency = __atomic_load_n(&s_sapLatency[msgId], __ATOMIC_ACQUIRE);
+        if (latency == NULL) {
+            continue;
+        }
+        dprintf(fd, "  %s in-flight=%d\n", sapMessageToString(msgId),
+                __atomic_load_n(&latency->inFlight, __ATOMIC_RELAXED));
+        dumpHistogram(fd, "complete", &latency->complete);
+    }
+}
+
+}   // namespace android
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_RIL_LATENCY_H
+#define ANDROID_RIL_LATENCY_H
+
+#include <stdint.h>
+
+namespace android {
+
+// Request numbers at or above this are not tracked
+#define RIL_LATENCY_MAX_REQUESTS 256
+
+// SAP message ids at or above this are not tracked
+#define RIL_LATENCY_MAX_SAP_MESSAGES 16
+
+// A request was handed to the vendor RIL. token names its async trace slice; the caller keeps the
+// ril_nano_time() start time and passes it to the ack and completion calls below
+void ril_latency_request_start(int request, int32_t token);
+
+// The vendor RIL acknowledged a request queued at startTime
+void ril_latency_request_ack(int request, uint64_t startTime);
+
+// The vendor RIL completed a request queued at startTime
+void ril_latency_request_complete(int request, int32_t token, uint64_t startTime);
+
+// A SAP request with message id msgId was handed to the vendor RIL
+void ril_latency_sap_start(int msgId);
+
+// The vendor RIL completed a SAP request with message id msgId queued at startTime
+void ril_latency_sap_complete(int msgId, uint64_t startTime);
+
+// Write request throughput since the previous dump, then in-flight counts and ack/completion
+// latency percentiles per request and SAP message to fd
+void ril_latency_dump(int fd);
+
+}   // namespace android
+
+#endif // ANDROID_RIL_LATENCY_H
@@ -0,0 +1,1029 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "RILC"
+
+#include <cutils/properties.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <telephony/librilutils.h>
+#include <unistd.h>
+#include <utils/Log.h>
+#include <ril_recorder.h>
+
+namespace android {
+
+// Size of the ring in KiB, 0 leaves the recorder off
+#define PROPERTY_RECORDER_KB "ro.ril.recorder_kb"
+
+#define RIL_RECORDER_PATH "/data/vendor/radio/ril_trace.bin"
+#define RIL_RECORDER_PREVIOUS_PATH "/data/vendor/radio/ril_trace.prev.bin"
+
+// Payloads are kept up to this many bytes, and a quarter of the ring. Longer raw payloads
+// are cut short, longer flattened ones are left out.
+#define RIL_RECORDER_MAX_PAYLOAD 4096
+
+#define RECORD_ALIGN(x) (((x) + 7) & ~((uint64_t) 7))
+
+#ifndef NUM_ELEMS
+#define NUM_ELEMS(a) (sizeof (a) / sizeof (a)[0])
+#endif
+
+static pthread_mutex_t s_recorderMutex = PTHREAD_MUTEX_INITIALIZER;
+static RilRecorderHeader *s_recorderHeader;
+static uint8_t *s_recorderRing;
+static size_t s_recorderMaxPayload;
+static bool s_recorderDisabled;
+
+/*
+ * How to follow the pointers of a payload. Layouts come from the types ril.h
+ * documents for each request, response and unsolicited response, and from
+ * the length checks the functions in ril_service.cpp make to tell versions
+ * of a type apart: when a payload does not fit a layout, its fallback is
+ * tried next.
+ */
+typedef enum {
+    PAYLOAD_RAW,                // plain bytes, of exactly size bytes if size is set
+    PAYLOAD_STRING,             // char *
+    PAYLOAD_STRINGS,            // char *[datalen / sizeof(char *)]
+    PAYLOAD_STRUCTS,            // array of datalen / size structs
+    PAYLOAD_STRUCT_POINTERS,    // array of datalen / sizeof(void *) pointers to one struct each
+    PAYLOAD_OPAQUE,             // cannot be followed, only the length is recorded
+} PayloadKind;
+
+typedef enum {
+    FIELD_STRING,               // char *
+    FIELD_BYTES,                // pointer to count bytes
+    FIELD_STRUCTS,              // pointer to count structs, or to one without a count
+    FIELD_INLINE_STRUCTS,       // array of count structs inside the parent, at most maxCount
+} FieldKind;
+
+struct PayloadLayout;
+
+typedef struct PayloadField {
+    FieldKind kind;
+    size_t offset;
+    ssize_t countOffset;        // int32_t holding the count, -1 if there is none
+    size_t maxCount;
+    const struct PayloadLayout *target;
+} PayloadField;
+
+typedef struct PayloadLayout {
+    PayloadKind kind;
+    size_t size;
+    bool exact;                 // datalen must be size rather than a multiple of it
+    const PayloadField *fields;
+    size_t fieldCount;
+    const struct PayloadLayout *fallback;
+} PayloadLayout;
+
+#define STRING_FIELD(type, member) \
+    { FIELD_STRING, offsetof(type, member), -1, 0, NULL }
+#define BYTES_FIELD(type, member, count) \
+    { FIELD_BYTES, offsetof(type, member), offsetof(type, count), 0, NULL }
+#define STRUCT_FIELD(type, member, target) \
+    { FIELD_STRUCTS, offsetof(type, member), -1, 0, &(target) }
+#define STRUCTS_FIELD(type, member, count, target) \
+    { FIELD_STRUCTS, offsetof(type, member), offsetof(type, count), 0, &(target) }
+#define INLINE_STRUCTS_FIELD(type, member, count, maxCount, target) \
+    { FIELD_INLINE_STRUCTS, offsetof(type, member), offsetof(type, count), maxCount, &(target) }
+
+#define LAYOUT(kind, type, fields, exact, fallback) \
+    { kind, sizeof(type), exact, fields, NUM_ELEMS(fields), fallback }
+#define PLAIN_LAYOUT(kind, type, exact, fallback) \
+    { kind, sizeof(type), exact, NULL, 0, fallback }
+
+static const PayloadLayout s_rawLayout = { PAYLOAD_RAW, 0, false, NULL, 0, NULL };
+static const PayloadLayout s_opaqueLayout = { PAYLOAD_OPAQUE, 0, false, NULL, 0, NULL };
+static const PayloadLayout s_stringLayout = { PAYLOAD_STRING, 0, false, NULL, 0, NULL };
+static const PayloadLayout s_stringsLayout = { PAYLOAD_STRINGS, 0, false, NULL, 0, NULL };
+
+static const PayloadField s_uusInfoFields[] = {
+    BYTES_FIELD(RIL_UUS_Info, uusData, uusLength),
+};
+static const PayloadLayout s_uusInfoLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_UUS_Info, s_uusInfoFields, true, NULL);
+
+static const PayloadField s_dialFields[] = {
+    STRING_FIELD(RIL_Dial, address),
+    STRUCT_FIELD(RIL_Dial, uusInfo, s_uusInfoLayout),
+};
+static const PayloadLayout s_dialLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_Dial, s_dialFields, true, NULL);
+
+static const PayloadField s_callFields[] = {
+    STRING_FIELD(RIL_Call, number),
+    STRING_FIELD(RIL_Call, name),
+    STRUCT_FIELD(RIL_Call, uusInfo, s_uusInfoLayout),
+};
+static const PayloadLayout s_callPointersLayout =
+        LAYOUT(PAYLOAD_STRUCT_POINTERS, RIL_Call, s_callFields, false, NULL);
+
+static const PayloadField s_appStatusFields[] = {
+    STRING_FIELD(RIL_AppStatus, aid_ptr),
+    STRING_FIELD(RIL_AppStatus, app_label_ptr),
+};
+static const PayloadLayout s_appStatusLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_AppStatus, s_appStatusFields, true, NULL);
+
+static const PayloadField s_cardStatusFields[] = {
+    INLINE_STRUCTS_FIELD(RIL_CardStatus_v6, applications, num_applications, RIL_CARD_MAX_APPS,
+            s_appStatusLayout),
+};
+static const PayloadLayout s_cardStatusLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_CardStatus_v6, s_cardStatusFields, true, NULL);
+
+static const PayloadField s_dataCallV6Fields[] = {
+    STRING_FIELD(RIL_Data_Call_Response_v6, type),
+    STRING_FIELD(RIL_Data_Call_Response_v6, ifname),
+    STRING_FIELD(RIL_Data_Call_Response_v6, addresses),
+    STRING_FIELD(RIL_Data_Call_Response_v6, dnses),
+    STRING_FIELD(RIL_Data_Call_Response_v6, gateways),
+};
+static const PayloadLayout s_dataCallV6Layout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_Data_Call_Response_v6, s_dataCallV6Fields, false, NULL);
+
+static const PayloadField s_dataCallV9Fields[] = {
+    STRING_FIELD(RIL_Data_Call_Response_v9, type),
+    STRING_FIELD(RIL_Data_Call_Response_v9, ifname),
+    STRING_FIELD(RIL_Data_Call_Response_v9, addresses),
+    STRING_FIELD(RIL_Data_Call_Response_v9, dnses),
+    STRING_FIELD(RIL_Data_Call_Response_v9, gateways),
+    STRING_FIELD(RIL_Data_Call_Response_v9, pcscf),
+};
+static const PayloadLayout s_dataCallV9Layout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_Data_Call_Response_v9, s_dataCallV9Fields, false,
+                &s_dataCallV6Layout);
+
+static const PayloadField s_dataCallV11Fields[] = {
+    STRING_FIELD(RIL_Data_Call_Response_v11, type),
+    STRING_FIELD(RIL_Data_Call_Response_v11, ifname),
+    STRING_FIELD(RIL_Data_Call_Response_v11, addresses),
+    STRING_FIELD(RIL_Data_Call_Response_v11, dnses),
+    STRING_FIELD(RIL_Data_Call_Response_v11, gateways),
+    STRING_FIELD(RIL_Data_Call_Response_v11, pcscf),
+};
+static const PayloadLayout s_dataCallLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_Data_Call_Response_v11, s_dataCallV11Fields, false,
+                &s_dataCallV9Layout);
+
+static const PayloadField s_simIoFields[] = {
+    STRING_FIELD(RIL_SIM_IO_v6, path),
+    STRING_FIELD(RIL_SIM_IO_v6, data),
+    STRING_FIELD(RIL_SIM_IO_v6, pin2),
+    STRING_FIELD(RIL_SIM_IO_v6, aidPtr),
+};
+static const PayloadLayout s_simIoLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_SIM_IO_v6, s_simIoFields, true, NULL);
+
+static const PayloadField s_simIoResponseFields[] = {
+    STRING_FIELD(RIL_SIM_IO_Response, simResponse),
+};
+static const PayloadLayout s_simIoResponseLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_SIM_IO_Response, s_simIoResponseFields, true, NULL);
+
+static const PayloadField s_simApduFields[] = {
+    STRING_FIELD(RIL_SIM_APDU, data),
+};
+static const PayloadLayout s_simApduLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_SIM_APDU, s_simApduFields, true, NULL);
+
+static const PayloadField s_smsResponseFields[] = {
+    STRING_FIELD(RIL_SMS_Response, ackPDU),
+};
+static const PayloadLayout s_smsResponseLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_SMS_Response, s_smsResponseFields, true, NULL);
+
+static const PayloadField s_smsWriteArgsFields[] = {
+    STRING_FIELD(RIL_SMS_WriteArgs, pdu),
+    STRING_FIELD(RIL_SMS_WriteArgs, smsc),
+};
+static const PayloadLayout s_smsWriteArgsLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_SMS_WriteArgs, s_smsWriteArgsFields, true, NULL);
+
+static const PayloadField s_callForwardInfoFields[] = {
+    STRING_FIELD(RIL_CallForwardInfo, number),
+};
+static const PayloadLayout s_callForwardInfoLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_CallForwardInfo, s_callForwardInfoFields, true, NULL);
+static const PayloadLayout s_callForwardInfoPointersLayout =
+        LAYOUT(PAYLOAD_STRUCT_POINTERS, RIL_CallForwardInfo, s_callForwardInfoFields, false,
+                NULL);
+
+static const PayloadField s_neighboringCellFields[] = {
+    STRING_FIELD(RIL_NeighboringCell, cid),
+};
+static const PayloadLayout s_neighboringCellPointersLayout =
+        LAYOUT(PAYLOAD_STRUCT_POINTERS, RIL_NeighboringCell, s_neighboringCellFields, false,
+                NULL);
+
+static const PayloadLayout s_gsmBroadcastConfigPointersLayout =
+        PLAIN_LAYOUT(PAYLOAD_STRUCT_POINTERS, RIL_GSM_BroadcastSmsConfigInfo, false, NULL);
+static const PayloadLayout s_cdmaBroadcastConfigPointersLayout =
+        PLAIN_LAYOUT(PAYLOAD_STRUCT_POINTERS, RIL_CDMA_BroadcastSmsConfigInfo, false, NULL);
+
+static const PayloadField s_carrierFields[] = {
+    STRING_FIELD(RIL_Carrier, mcc),
+    STRING_FIELD(RIL_Carrier, mnc),
+    STRING_FIELD(RIL_Carrier, match_data),
+};
+static const PayloadLayout s_carrierLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_Carrier, s_carrierFields, false, NULL);
+
+static const PayloadField s_carrierRestrictionsFields[] = {
+    STRUCTS_FIELD(RIL_CarrierRestrictions, allowed_carriers, len_allowed_carriers,
+            s_carrierLayout),
+    STRUCTS_FIELD(RIL_CarrierRestrictions, excluded_carriers, len_excluded_carriers,
+            s_carrierLayout),
+};
+static const PayloadLayout s_carrierRestrictionsLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_CarrierRestrictions, s_carrierRestrictionsFields, true,
+                NULL);
+
+static const PayloadField s_carrierInfoFields[] = {
+    STRING_FIELD(RIL_CarrierInfoForImsiEncryption, mcc),
+    STRING_FIELD(RIL_CarrierInfoForImsiEncryption, mnc),
+    BYTES_FIELD(RIL_CarrierInfoForImsiEncryption, carrierKey, carrierKeyLength),
+    STRING_FIELD(RIL_CarrierInfoForImsiEncryption, keyIdentifier),
+};
+static const PayloadLayout s_carrierInfoLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_CarrierInfoForImsiEncryption, s_carrierInfoFields, true,
+                NULL);
+
+static const PayloadField s_lastCallFailCauseFields[] = {
+    STRING_FIELD(RIL_LastCallFailCauseInfo, vendor_cause),
+};
+static const PayloadLayout s_lastCallFailCauseLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_LastCallFailCauseInfo, s_lastCallFailCauseFields, true,
+                &s_rawLayout);
+
+static const PayloadLayout s_voiceRegistrationStateLayout =
+        PLAIN_LAYOUT(PAYLOAD_RAW, RIL_VoiceRegistrationStateResponse, true, &s_stringsLayout);
+static const PayloadLayout s_dataRegistrationStateLayout =
+        PLAIN_LAYOUT(PAYLOAD_RAW, RIL_DataRegistrationStateResponse, true, &s_stringsLayout);
+
+static const PayloadField s_suppSvcNotificationFields[] = {
+    STRING_FIELD(RIL_SuppSvcNotification, number),
+};
+static const PayloadLayout s_suppSvcNotificationLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_SuppSvcNotification, s_suppSvcNotificationFields, true,
+                NULL);
+
+static const PayloadField s_simRefreshFields[] = {
+    STRING_FIELD(RIL_SimRefreshResponse_v7, aid),
+};
+static const PayloadLayout s_simRefreshLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_SimRefreshResponse_v7, s_simRefreshFields, true,
+                &s_rawLayout);
+
+static const PayloadField s_cdmaCallWaitingFields[] = {
+    STRING_FIELD(RIL_CDMA_CallWaiting_v6, number),
+    STRING_FIELD(RIL_CDMA_CallWaiting_v6, name),
+};
+static const PayloadLayout s_cdmaCallWaitingLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_CDMA_CallWaiting_v6, s_cdmaCallWaitingFields, true, NULL);
+
+static const PayloadField s_nvWriteItemFields[] = {
+    STRING_FIELD(RIL_NV_WriteItem, value),
+};
+static const PayloadLayout s_nvWriteItemLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_NV_WriteItem, s_nvWriteItemFields, true, NULL);
+
+static const PayloadField s_openChannelFields[] = {
+    STRING_FIELD(RIL_OpenChannelParams, aidPtr),
+};
+static const PayloadLayout s_openChannelLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_OpenChannelParams, s_openChannelFields, true,
+                &s_stringLayout);
+
+static const PayloadField s_simAuthenticationFields[] = {
+    STRING_FIELD(RIL_SimAuthentication, authData),
+    STRING_FIELD(RIL_SimAuthentication, aid),
+};
+static const PayloadLayout s_simAuthenticationLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_SimAuthentication, s_simAuthenticationFields, true, NULL);
+
+static const PayloadField s_dataProfileFields[] = {
+    STRING_FIELD(RIL_DataProfileInfo, apn),
+    STRING_FIELD(RIL_DataProfileInfo, protocol),
+    STRING_FIELD(RIL_DataProfileInfo, user),
+    STRING_FIELD(RIL_DataProfileInfo, password),
+};
+static const PayloadLayout s_dataProfilePointersLayout =
+        LAYOUT(PAYLOAD_STRUCT_POINTERS, RIL_DataProfileInfo, s_dataProfileFields, false, NULL);
+
+static const PayloadField s_dataProfileV15Fields[] = {
+    STRING_FIELD(RIL_DataProfileInfo_v15, apn),
+    STRING_FIELD(RIL_DataProfileInfo_v15, protocol),
+    STRING_FIELD(RIL_DataProfileInfo_v15, roamingProtocol),
+    STRING_FIELD(RIL_DataProfileInfo_v15, user),
+    STRING_FIELD(RIL_DataProfileInfo_v15, password),
+    STRING_FIELD(RIL_DataProfileInfo_v15, mvnoType),
+    STRING_FIELD(RIL_DataProfileInfo_v15, mvnoMatchData),
+};
+static const PayloadLayout s_dataProfileV15PointersLayout =
+        LAYOUT(PAYLOAD_STRUCT_POINTERS, RIL_DataProfileInfo_v15, s_dataProfileV15Fields, false,
+                NULL);
+
+static const PayloadField s_initialAttachApnFields[] = {
+    STRING_FIELD(RIL_InitialAttachApn, apn),
+    STRING_FIELD(RIL_InitialAttachApn, protocol),
+    STRING_FIELD(RIL_InitialAttachApn, username),
+    STRING_FIELD(RIL_InitialAttachApn, password),
+};
+static const PayloadLayout s_initialAttachApnV14Layout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_InitialAttachApn, s_initialAttachApnFields, true, NULL);
+
+static const PayloadField s_initialAttachApnV15Fields[] = {
+    STRING_FIELD(RIL_InitialAttachApn_v15, apn),
+    STRING_FIELD(RIL_InitialAttachApn_v15, protocol),
+    STRING_FIELD(RIL_InitialAttachApn_v15, roamingProtocol),
+    STRING_FIELD(RIL_InitialAttachApn_v15, username),
+    STRING_FIELD(RIL_InitialAttachApn_v15, password),
+    STRING_FIELD(RIL_InitialAttachApn_v15, mvnoType),
+    STRING_FIELD(RIL_InitialAttachApn_v15, mvnoMatchData),
+};
+static const PayloadLayout s_initialAttachApnLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_InitialAttachApn_v15, s_initialAttachApnV15Fields, true,
+                &s_initialAttachApnV14Layout);
+
+static const PayloadField s_pcoDataFields[] = {
+    STRING_FIELD(RIL_PCO_Data, bearer_proto),
+    BYTES_FIELD(RIL_PCO_Data, contents, contents_length),
+};
+static const PayloadLayout s_pcoDataLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_PCO_Data, s_pcoDataFields, true, NULL);
+
+static const PayloadLayout s_cellInfoLayout =
+        PLAIN_LAYOUT(PAYLOAD_STRUCTS, RIL_CellInfo_v12, false, NULL);
+
+static const PayloadField s_networkScanResultFields[] = {
+    STRUCTS_FIELD(RIL_NetworkScanResult, network_infos, network_infos_length, s_cellInfoLayout),
+};
+static const PayloadLayout s_networkScanResultLayout =
+        LAYOUT(PAYLOAD_STRUCTS, RIL_NetworkScanResult, s_networkScanResultFields, true, NULL);
+
+static const PayloadLayout *requestLayout(int request, int rilVersion) {
+    switch (request) {
+        case RIL_REQUEST_ENTER_SIM_PIN:
+        case RIL_REQUEST_ENTER_SIM_PUK:
+        case RIL_REQUEST_ENTER_SIM_PIN2:
+        case RIL_REQUEST_ENTER_SIM_PUK2:
+        case RIL_REQUEST_CHANGE_SIM_PIN:
+        case RIL_REQUEST_CHANGE_SIM_PIN2:
+        case RIL_REQUEST_ENTER_NETWORK_DEPERSONALIZATION:
+        case RIL_REQUEST_GET_IMSI:
+        case RIL_REQUEST_SEND_SMS:
+        case RIL_REQUEST_SEND_SMS_EXPECT_MORE:
+        case RIL_REQUEST_SETUP_DATA_CALL:
+        case RIL_REQUEST_DEACTIVATE_DATA_CALL:
+        case RIL_REQUEST_QUERY_FACILITY_LOCK:
+        case RIL_REQUEST_SET_FACILITY_LOCK:
+        case RIL_REQUEST_CHANGE_BARRING_PASSWORD:
+        case RIL_REQUEST_SET_NETWORK_SELECTION_AUTOMATIC:
+        case RIL_REQUEST_SET_NETWORK_SELECTION_MANUAL:
+        case RIL_REQUEST_OEM_HOOK_STRINGS:
+        case RIL_REQUEST_CDMA_BURST_DTMF:
+        case RIL_REQUEST_ACKNOWLEDGE_INCOMING_GSM_SMS_WITH_PDU:
+            return &s_stringsLayout;
+        case RIL_REQUEST_DTMF:
+        case RIL_REQUEST_DTMF_START:
+        case RIL_REQUEST_SEND_USSD:
+        case RIL_REQUEST_STK_SEND_ENVELOPE_COMMAND:
+        case RIL_REQUEST_STK_SEND_TERMINAL_RESPONSE:
+        case RIL_REQUEST_CDMA_FLASH:
+        case RIL_REQUEST_SET_SMSC_ADDRESS:
+        case RIL_REQUEST_ISIM_AUTHENTICATION:
+        case RIL_REQUEST_STK_SEND_ENVELOPE_WITH_STATUS:
+            return &s_stringLayout;
+        case RIL_REQUEST_DIAL:
+            return &s_dialLayout;
+        case RIL_REQUEST_SIM_IO:
+            return &s_simIoLayout;
+        case RIL_REQUEST_QUERY_CALL_FORWARD_STATUS:
+        case RIL_REQUEST_SET_CALL_FORWARD:
+            return &s_callForwardInfoLayout;
+        case RIL_REQUEST_WRITE_SMS_TO_SIM:
+            return &s_smsWriteArgsLayout;
+        case RIL_REQUEST_GSM_SET_BROADCAST_SMS_CONFIG:
+            return &s_gsmBroadcastConfigPointersLayout;
+        case RIL_REQUEST_CDMA_SET_BROADCAST_SMS_CONFIG:
+            return &s_cdmaBroadcastConfigPointersLayout;
+        case RIL_REQUEST_SET_INITIAL_ATTACH_APN:
+            return &s_initialAttachApnLayout;
+        case RIL_REQUEST_SIM_TRANSMIT_APDU_BASIC:
+        case RIL_REQUEST_SIM_TRANSMIT_APDU_CHANNEL:
+            return &s_simApduLayout;
+        case RIL_REQUEST_SIM_OPEN_CHANNEL:
+            return &s_openChannelLayout;
+        case RIL_REQUEST_NV_WRITE_ITEM:
+            return &s_nvWriteItemLayout;
+        case RIL_REQUEST_SIM_AUTHENTICATION:
+            return &s_simAuthenticationLayout;
+        case RIL_REQUEST_SET_DATA_PROFILE:
+            return rilVersion <= 14 ? &s_dataProfilePointersLayout
+                    : &s_dataProfileV15PointersLayout;
+        case RIL_REQUEST_SET_CARRIER_RESTRICTIONS:
+            return &s_carrierRestrictionsLayout;
+        case RIL_REQUEST_SET_CARRIER_INFO_IMSI_ENCRYPTION:
+            return &s_carrierInfoLayout;
+        case RIL_REQUEST_IMS_SEND_SMS:
+            // RIL_IMS_SMS_Message points at a different type for each technology
+            return &s_opaqueLayout;
+        default:
+            return request > 0 && request <= RIL_REQUEST_STOP_KEEPALIVE ? &s_rawLayout
+                    : &s_opaqueLayout;
+    }
+}
+
+static const PayloadLayout *responseLayout(int request) {
+    switch (request) {
+        case RIL_REQUEST_GET_SIM_STATUS:
+            return &s_cardStatusLayout;
+        case RIL_REQUEST_GET_CURRENT_CALLS:
+            return &s_callPointersLayout;
+        case RIL_REQUEST_LAST_CALL_FAIL_CAUSE:
+            return &s_lastCallFailCauseLayout;
+        case RIL_REQUEST_VOICE_REGISTRATION_STATE:
+            return &s_voiceRegistrationStateLayout;
+        case RIL_REQUEST_DATA_REGISTRATION_STATE:
+            return &s_dataRegistrationStateLayout;
+        case RIL_REQUEST_OPERATOR:
+        case RIL_REQUEST_QUERY_AVAILABLE_NETWORKS:
+        case RIL_REQUEST_OEM_HOOK_STRINGS:
+        case RIL_REQUEST_CDMA_SUBSCRIPTION:
+        case RIL_REQUEST_DEVICE_IDENTITY:
+            return &s_stringsLayout;
+        case RIL_REQUEST_GET_IMSI:
+        case RIL_REQUEST_GET_IMEI:
+        case RIL_REQUEST_GET_IMEISV:
+        case RIL_REQUEST_BASEBAND_VERSION:
+        case RIL_REQUEST_STK_SEND_ENVELOPE_COMMAND:
+        case RIL_REQUEST_GET_SMSC_ADDRESS:
+        case RIL_REQUEST_ISIM_AUTHENTICATION:
+        case RIL_REQUEST_NV_READ_ITEM:
+            return &s_stringLayout;
+        case RIL_REQUEST_SEND_SMS:
+        case RIL_REQUEST_SEND_SMS_EXPECT_MORE:
+        case RIL_REQUEST_CDMA_SEND_SMS:
+        case RIL_REQUEST_IMS_SEND_SMS:
+            return &s_smsResponseLayout;
+        case RIL_REQUEST_SETUP_DATA_CALL:
+        case RIL_REQUEST_DATA_CALL_LIST:
+            return &s_dataCallLayout;
+        case RIL_REQUEST_SIM_IO:
+        case RIL_REQUEST_STK_SEND_ENVELOPE_WITH_STATUS:
+        case RIL_REQUEST_SIM_TRANSMIT_APDU_BASIC:
+        case RIL_REQUEST_SIM_TRANSMIT_APDU_CHANNEL:
+        case RIL_REQUEST_SIM_AUTHENTICATION:
+            return &s_simIoResponseLayout;
+        case RIL_REQUEST_QUERY_CALL_FORWARD_STATUS:
+            return &s_callForwardInfoPointersLayout;
+        case RIL_REQUEST_GET_NEIGHBORING_CELL_IDS:
+            return &s_neighboringCellPointersLayout;
+        case RIL_REQUEST_GSM_GET_BROADCAST_SMS_CONFIG:
+            return &s_gsmBroadcastConfigPointersLayout;
+        case RIL_REQUEST_CDMA_GET_BROADCAST_SMS_CONFIG:
+            return &s_cdmaBroadcastConfigPointersLayout;
+        case RIL_REQUEST_GET_CARRIER_RESTRICTIONS:
+            return &s_carrierRestrictionsLayout;
+        default:
+            return request > 0 && request <= RIL_REQUEST_STOP_KEEPALIVE ? &s_rawLayout
+                    : &s_opaqueLayout;
+    }
+}
+
+static const PayloadLayout *unsolLayout(int unsolResponse) {
+    switch (unsolResponse) {
+        case RIL_UNSOL_RESPONSE_NEW_SMS:
+        case RIL_UNSOL_RESPONSE_NEW_SMS_STATUS_REPORT:
+        case RIL_UNSOL_NITZ_TIME_RECEIVED:
+        case RIL_UNSOL_STK_PROACTIVE_COMMAND:
+        case RIL_UNSOL_STK_EVENT_NOTIFY:
+        case RIL_UNSOL_STK_CC_ALPHA_NOTIFY:
+        case RIL_UNSOL_MODEM_RESTART:
+            return &s_stringLayout;
+        case RIL_UNSOL_ON_USSD:
+        case RIL_UNSOL_ON_USSD_REQUEST:
+            return &s_stringsLayout;
+        case RIL_UNSOL_DATA_CALL_LIST_CHANGED:
+            return &s_dataCallLayout;
+        case RIL_UNSOL_SUPP_SVC_NOTIFICATION:
+            return &s_suppSvcNotificationLayout;
+        case RIL_UNSOL_SIM_REFRESH:
+            return &s_simRefreshLayout;
+        case RIL_UNSOL_CDMA_CALL_WAITING:
+            return &s_cdmaCallWaitingLayout;
+        case RIL_UNSOL_PCO_DATA:
+            return &s_pcoDataLayout;
+        case RIL_UNSOL_NETWORK_SCAN_RESULT:
+            return &s_networkScanResultLayout;
+        default:
+            return unsolResponse >= RIL_UNSOL_RESPONSE_BASE
+                    && unsolResponse <= RIL_UNSOL_KEEPALIVE_STATUS ? &s_rawLayout
+                    : &s_opaqueLayout;
+    }
+}
+
+static bool layoutFits(const PayloadLayout *layout, size_t datalen) {
+    switch (layout->kind) {
+        case PAYLOAD_STRINGS:
+        case PAYLOAD_STRUCT_POINTERS:
+            return datalen % sizeof(void *) == 0;
+        case PAYLOAD_RAW:
+        case PAYLOAD_STRUCTS:
+            if (layout->exact) {
+                return datalen == layout->size;
+            }
+            return layout->size == 0 || (datalen > 0 && datalen % layout->size == 0);
+        default:
+            return true;
+    }
+}
+
+static const PayloadLayout *payloadLayout(int type, int id, int rilVersion, size_t datalen) {
+    const PayloadLayout *layout;
+
+    switch (type) {
+        case RIL_RECORD_REQUEST:
+            layout = requestLayout(id, rilVersion);
+            break;
+        case RIL_RECORD_COMPLETE:
+            layout = responseLayout(id);
+            break;
+        default:
+            layout = unsolLayout(id);
+            break;
+    }
+    while (layout != NULL && !layoutFits(layout, datalen)) {
+        layout = layout->fallback;
+    }
+    return layout != NULL ? layout : &s_opaqueLayout;
+}
+
+static size_t fieldCount(const PayloadField *field, const uint8_t *parent) {
+    if (field->countOffset < 0) {
+        return 1;
+    }
+    int32_t count;
+    memcpy(&count, parent + field->countOffset, sizeof(count));
+    return count > 0 ? count : 0;
+}
+
+typedef struct PayloadWriter {
+    uint8_t *buf;
+    size_t capacity;
+    size_t used;
+    bool full;
+} PayloadWriter;
+
+/**
+ * Make room for len bytes at the next multiple of align. Once anything did not fit the
+ * writer stays full, and the payload is dropped.
+ */
+static bool reserve(PayloadWriter *w, size_t len, size_t align, size_t *offset) {
+    size_t start = (w->used + align - 1) & ~(align - 1);
+    if (w->full || start > w->capacity || len > w->capacity - start) {
+        w->full = true;
+        return false;
+    }
+    *offset = start;
+    w->used = start + len;
+    return true;
+}
+
+static void storeOffset(PayloadWriter *w, size_t slot, size_t offset) {
+    uintptr_t value = offset;
+    memcpy(w->buf + slot, &value, sizeof(value));
+}
+
+static size_t flattenBytes(PayloadWriter *w, const void *p, size_t len, size_t align) {
+    size_t offset = 0;
+    if (reserve(w, len, align, &offset)) {
+        memcpy(w->buf + offset, p, len);
+    }
+    return offset;
+}
+
+static size_t flattenString(PayloadWriter *w, const char *s) {
+    return flattenBytes(w, s, strlen(s) + 1, 1);
+}
+
+static void flattenFields(PayloadWriter *w, const PayloadLayout *layout, size_t at,
+        const uint8_t *src);
+
+static size_t flattenStructs(PayloadWriter *w, const PayloadLayout *layout, const void *src,
+        size_t count) {
+    size_t len;
+    if (__builtin_mul_overflow(count, layout->size, &len)) {
+        w->full = true;
+        return 0;
+    }
+    size_t offset = flattenBytes(w, src, len, sizeof(uint64_t));
+    for (size_t i = 0; i < count && !w->full; i++) {
+        flattenFields(w, layout, offset + i * layout->size,
+                (const uint8_t *) src + i * layout->size);
+    }
+    return offset;
+}
+
+/**
+ * Rewrite the pointers of the struct copied to offset at, whose original is src, into
+ * payload offsets, copying what they point to into the payload first.
+ */
+static void flattenFields(PayloadWriter *w, const PayloadLayout *layout, size_t at,
+        const uint8_t *src) {
+    for (size_t i = 0; i < layout->fieldCount && !w->full; i++) {
+        const PayloadField *field = &layout->fields[i];
+        size_t count = fieldCount(field, src);
+
+        if (field->kind == FIELD_INLINE_STRUCTS) {
+            const PayloadLayout *target = field->target;
+            if (count > field->maxCount) {
+                count = field->maxCount;
+            }
+            for (size_t j = 0; j < count; j++) {
+                flattenFields(w, target, at + field->offset + j * target->size,
+                        src + field->offset + j * target->size);
+            }
+            // pointers of the unused entries are left over from the vendor RIL
+            for (size_t j = count; j < field->maxCount; j++) {
+                for (size_t k = 0; k < target->fieldCount; k++) {
+                    storeOffset(w, at + field->offset + j * target->size
+                            + target->fields[k].offset, 0);
+                }
+            }
+            continue;
+        }
+
+        const void *p;
+        memcpy(&p, src + field->offset, sizeof(p));
+        size_t offset = 0;
+        if (p != NULL) {
+            switch (field->kind) {
+                case FIELD_STRING:
+                    offset = flattenString(w, (const char *) p);
+                    break;
+                case FIELD_BYTES:
+                    offset = flattenBytes(w, p, count, 1);
+                    break;
+                default:
+                    offset = flattenStructs(w, field->target, p, count);
+                    break;
+            }
+        }
+        storeOffset(w, at + field->offset, offset);
+    }
+}
+
+/**
+ * Flatten data into buf, see RilRecorderHeader. Returns false if the payload cannot be
+ * followed or does not fit in capacity bytes.
+ */
+static bool flattenPayload(const PayloadLayout *layout, const void *data, size_t datalen,
+        uint8_t *buf, size_t capacity, size_t *payloadLen) {
+    PayloadWriter w = { buf, capacity, 0, false };
+    size_t root;
+
+    switch (layout->kind) {
+        case PAYLOAD_STRING:
+            flattenString(&w, (const char *) data);
+            break;
+        case PAYLOAD_STRINGS: {
+            size_t count = datalen / sizeof(char *);
+            if (!reserve(&w, datalen, sizeof(uint64_t), &root)) {
+                break;
+            }
+            for (size_t i = 0; i < count && !w.full; i++) {
+                const char *s = ((const char * const *) data)[i];
+                storeOffset(&w, i * sizeof(char *), s != NULL ? flattenString(&w, s) : 0);
+            }
+            break;
+        }
+        case PAYLOAD_STRUCTS:
+            flattenStructs(&w, layout, data, datalen / layout->size);
+            break;
+        case PAYLOAD_STRUCT_POINTERS: {
+            size_t count = datalen / sizeof(void *);
+            if (!reserve(&w, datalen, sizeof(uint64_t), &root)) {
+                break;
+            }
+            for (size_t i = 0; i < count && !w.full; i++) {
+                const void *p = ((const void * const *) data)[i];
+                storeOffset(&w, i * sizeof(void *),
+                        p != NULL ? flattenStructs(&w, layout, p, 1) : 0);
+            }
+            break;
+        }
+        default:
+            return false;
+    }
+
+    *payloadLen = w.used;
+    return !w.full;
+}
+
+typedef struct PayloadReader {
+    uint8_t *buf;
+    size_t len;
+} PayloadReader;
+
+/**
+ * Check that the pointer slot at `slot` holds the offset of count * size bytes inside the
+ * payload, or of a terminated string if size is 0, and return that offset.
+ */
+static bool readOffset(const PayloadReader *r, size_t slot, size_t count, size_t size,
+        size_t *offset) {
+    uintptr_t value;
+    if (slot > r->len || sizeof(value) > r->len - slot) {
+        return false;
+    }
+    memcpy(&value, r->buf + slot, sizeof(value));
+    *offset = value;
+    if (value == 0) {
+        return true;
+    }
+    if (value >= r->len) {
+        return false;
+    }
+    if (size == 0) {
+        return memchr(r->buf + value, '\0', r->len - value) != NULL;
+    }
+    size_t len;
+    return !__builtin_mul_overflow(count, size, &len) && len <= r->len - value;
+}
+
+static void storePointer(const PayloadReader *r, size_t slot, size_t offset) {
+    void *p = offset != 0 ? r->buf + offset : NULL;
+    memcpy(r->buf + slot, &p, sizeof(p));
+}
+
+static bool unflattenFields(const PayloadReader *r, const PayloadLayout *layout, size_t at) {
+    if (at > r->len || layout->size > r->len - at) {
+        return false;
+    }
+
+    for (size_t i = 0; i < layout->fieldCount; i++) {
+        const PayloadField *field = &layout->fields[i];
+        size_t count = fieldCount(field, r->buf + at);
+        size_t offset;
+
+        switch (field->kind) {
+            case FIELD_INLINE_STRUCTS:
+                if (count > field->maxCount) {
+                    count = field->maxCount;
+                }
+                for (size_t j = 0; j < count; j++) {
+                    if (!unflattenFields(r, field->target,
+                            at + field->offset + j * field->target->size)) {
+                        return false;
+                    }
+                }
+                continue;
+            case FIELD_STRING:
+                if (!readOffset(r, at + field->offset, 1, 0, &offset)) {
+                    return false;
+                }
+                break;
+            case FIELD_BYTES:
+                if (!readOffset(r, at + field->offset, count, 1, &offset)) {
+                    return false;
+                }
+                break;
+            default:
+                if (!readOffset(r, at + field->offset, count, field->target->size, &offset)) {
+                    return false;
+                }
+                for (size_t j = 0; offset != 0 && j < count; j++) {
+                    if (!unflattenFields(r, field->target,
+                            offset + j * field->target->size)) {
+                        return false;
+                    }
+                }
+                break;
+        }
+        storePointer(r, at + field->offset, offset);
+    }
+    return true;
+}
+
+static RilRecord *recordAt(uint64_t offset) {
+    return (RilRecord *) (s_recorderRing + offset % s_recorderHeader->capacity);
+}
+
+/**
+ * Drop the oldest records until [head, end) no longer overlaps them.
+ */
+static void evictLocked(uint64_t end) {
+    uint64_t capacity = s_recorderHeader->capacity;
+    uint64_t tail = s_recorderHeader->tail;
+
+    while (tail < s_recorderHeader->head && end - tail > capacity) {
+        tail += recordAt(tail)->length;
+    }
+    __atomic_store_n(&s_recorderHeader->tail, tail, __ATOMIC_RELEASE);
+}
+
+static void append(RilRecordType type, int slotId, int id, int32_t token, int error,
+        const void *data, size_t datalen) {
+    RilRecorderHeader *header = __atomic_load_n(&s_recorderHeader, __ATOMIC_ACQUIRE);
+    if (header == NULL) {
+        return;
+    }
+
+    uint8_t flattened[RIL_RECORDER_MAX_PAYLOAD] __attribute__((aligned(8)));
+    const void *payload = NULL;
+    size_t payloadLen = 0;
+    uint32_t flags = 0;
+
+    if (data != NULL) {
+        const PayloadLayout *layout = payloadLayout(type, id, header->rilVersion, datalen);
+        if (layout->kind == PAYLOAD_RAW) {
+            payload = data;
+            payloadLen = datalen;
+            if (payloadLen > s_recorderMaxPayload) {
+                payloadLen = s_recorderMaxPayload;
+                flags |= RIL_RECORD_PAYLOAD_PARTIAL;
+            }
+        } else if (flattenPayload(layout, data, datalen, flattened, s_recorderMaxPayload,
+                &payloadLen)) {
+            payload = flattened;
+        } else {
+            payloadLen = 0;
+            flags |= RIL_RECORD_PAYLOAD_PARTIAL;
+        }
+    }
+
+    uint32_t length = RECORD_ALIGN(sizeof(RilRecord) + payloadLen);
+    uint64_t timestampNs = ril_nano_time();
+
+    pthread_mutex_lock(&s_recorderMutex);
+
+    uint64_t capacity = s_recorderHeader->capacity;
+    uint64_t head = s_recorderHeader->head;
+    uint64_t room = capacity - head % capacity;
+    if (room < length) {
+        // pad out to the end of the ring so the record stays contiguous
+        evictLocked(head + room);
+        RilRecord *pad = recordAt(head);
+        pad->length = room;
+        pad->type = RIL_RECORD_PAD;
+        head += room;
+        __atomic_store_n(&s_recorderHeader->head, head, __ATOMIC_RELEASE);
+    }
+
+    evictLocked(head + length);
+    RilRecord *record = recordAt(head);
+    record->length = length;
+    record->type = type;
+    record->slot = slotId;
+    record->id = id;
+    record->token = token;
+    record->error = error;
+    record->payloadLen = payloadLen;
+    record->originalLen = datalen;
+    record->flags = flags;
+    record->timestampNs = timestampNs;
+    if (payloadLen > 0) {
+        memcpy(record + 1, payload, payloadLen);
+    }
+    __atomic_store_n(&s_recorderHeader->head, head + length, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&s_recorderMutex);
+}
+
+void ril_recorder_init(int rilVersion) {
+    int kb = property_get_int32(PROPERTY_RECORDER_KB, 0);
+    if (kb <= 0 || s_recorderDisabled || s_recorderHeader != NULL) {
+        return;
+    }
+
+    uint64_t capacity = (uint64_t) kb * 1024;
+    size_t size = sizeof(RilRecorderHeader) + capacity;
+
+    // keep the trace of the previous run, it is usually the interesting one
+    rename(RIL_RECORDER_PATH, RIL_RECORDER_PREVIOUS_PATH);
+
+    int fd = open(RIL_RECORDER_PATH, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0660);
+    if (fd < 0) {
+        RLOGE("ril_recorder_init: failed to open %s: %s", RIL_RECORDER_PATH, strerror(errno));
+        return;
+    }
+    if (ftruncate(fd, size) < 0) {
+        RLOGE("ril_recorder_init: failed to size %s: %s", RIL_RECORDER_PATH, strerror(errno));
+        close(fd);
+        return;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        RLOGE("ril_recorder_init: failed to map %s: %s", RIL_RECORDER_PATH, strerror(errno));
+        return;
+    }
+
+    RilRecorderHeader *header = (RilRecorderHeader *) map;
+    header->magic = RIL_RECORDER_MAGIC;
+    header->version = RIL_RECORDER_VERSION;
+    header->pointerSize = sizeof(void *);
+    header->rilVersion = rilVersion;
+    header->capacity = capacity;
+    header->head = 0;
+    header->tail = 0;
+
+    s_recorderRing = (uint8_t *) map + sizeof(RilRecorderHeader);
+    s_recorderMaxPayload = capacity / 4 < RIL_RECORDER_MAX_PAYLOAD ?
+            capacity / 4 : RIL_RECORDER_MAX_PAYLOAD;
+    __atomic_store_n(&s_recorderHeader, header, __ATOMIC_RELEASE);
+
+    RLOGI("ril_recorder_init: recording %d KiB of vendor RIL traffic to %s", kb,
+            RIL_RECORDER_PATH);
+}
+
+void ril_recorder_disable(void) {
+    s_recorderDisabled = true;
+}
+
+void ril_recorder_request(int request, int32_t token, int slotId, const void *data,
+        size_t datalen) {
+    append(RIL_RECORD_REQUEST, slotId, request, token, 0, data, datalen);
+}
+
+void ril_recorder_complete(int request, int32_t token, int slotId, RIL_Errno e,
+        const void *response, size_t responselen) {
+    append(RIL_RECORD_COMPLETE, slotId, request, token, e, response, responselen);
+}
+
+void ril_recorder_unsol(int unsolResponse, int slotId, const void *data, size_t datalen) {
+    append(RIL_RECORD_UNSOL, slotId, unsolResponse, 0, 0, data, datalen);
+}
+
+bool ril_recorder_unflatten(const RilRecorderHeader *header, const RilRecord *record,
+        void *payload) {
+    if (header->pointerSize != sizeof(void *) || (record->flags & RIL_RECORD_PAYLOAD_PARTIAL)
+            || record->payloadLen == 0) {
+        return false;
+    }
+
+    const PayloadLayout *layout = payloadLayout(record->type, record->id, header->rilVersion,
+            record->originalLen);
+    PayloadReader r = { (uint8_t *) payload, record->payloadLen };
+    size_t count;
+    size_t offset;
+
+    switch (layout->kind) {
+        case PAYLOAD_RAW:
+            return true;
+        case PAYLOAD_STRING:
+            return memchr(r.buf, '\0', r.len) != NULL;
+        case PAYLOAD_STRINGS:
+            count = record->originalLen / sizeof(char *);
+            for (size_t i = 0; i < count; i++) {
+                if (!readOffset(&r, i * sizeof(char *), 1, 0, &offset)) {
+                    return false;
+                }
+                storePointer(&r, i * sizeof(char *), offset);
+            }
+            return true;
+        case PAYLOAD_STRUCTS:
+            count = record->originalLen / layout->size;
+            for (size_t i = 0; i < count; i++) {
+                if (!unflattenFields(&r, layout, i * layout->size)) {
+                    return false;
+                }
+            }
+            return true;
+        case PAYLOAD_STRUCT_POINTERS:
+            count = record->originalLen / sizeof(void *);
+            for (size_t i = 0; i < count; i++) {
+                if (!readOffset(&r, i * sizeof(void *), 1, layout->size, &offset)
+                        || (offset != 0 && !unflattenFields(&r, layout, offset))) {
+                    return false;
+                }
+                storePointer(&r, i * sizeof(void *), offset);
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+}   // namespace android
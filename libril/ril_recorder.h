@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_RIL_RECORDER_H
+#define ANDROID_RIL_RECORDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <telephony/ril.h>
+
+namespace android {
+
+/*
+ * The trace file is a RilRecorderHeader followed by a ring of `capacity`
+ * bytes. head and tail are byte counts since the file was created; the
+ * oldest complete record starts at tail % capacity and the next one is
+ * written at head % capacity. Records are 8 byte aligned and never wrap:
+ * the space left before the end of the ring is filled with a
+ * RIL_RECORD_PAD record whose length covers it.
+ *
+ * Payloads are stored flattened: the object the vendor RIL handed over sits
+ * at offset 0 of the payload and everything it points to follows it, with
+ * each pointer replaced by the payload offset of its target, or 0 for NULL.
+ * Pointers are pointerSize bytes wide, so a trace only replays on the ABI
+ * it was recorded on.
+ */
+#define RIL_RECORDER_MAGIC 0x524c4952 /* "RILR" */
+#define RIL_RECORDER_VERSION 2
+
+typedef struct RilRecorderHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t pointerSize;       // sizeof(void *) of the recording rild
+    int32_t rilVersion;         // RIL_RadioFunctions version of the vendor RIL
+    uint64_t capacity;
+    uint64_t head;
+    uint64_t tail;
+} RilRecorderHeader;
+
+typedef enum {
+    RIL_RECORD_PAD = 0,
+    RIL_RECORD_REQUEST = 1,     // onRequest handed to the vendor RIL
+    RIL_RECORD_COMPLETE = 2,    // RIL_onRequestComplete from the vendor RIL
+    RIL_RECORD_UNSOL = 3,       // RIL_onUnsolicitedResponse from the vendor RIL
+} RilRecordType;
+
+// The payload is missing or cut short, so it cannot be handed back to libril
+#define RIL_RECORD_PAYLOAD_PARTIAL 0x1
+
+typedef struct RilRecord {
+    uint32_t length;            // whole record including payload and padding
+    uint16_t type;              // RilRecordType
+    uint16_t slot;
+    int32_t id;                 // request or unsolicited response number
+    int32_t token;              // request serial, 0 for unsolicited responses
+    int32_t error;              // RIL_Errno of completions, 0 otherwise
+    uint32_t payloadLen;        // payload bytes stored after the record
+    uint32_t originalLen;       // payload length the vendor RIL saw, may exceed payloadLen
+    uint32_t flags;             // RIL_RECORD_PAYLOAD_* bits
+    uint64_t timestampNs;       // ril_nano_time()
+} RilRecord;
+
+// Map the trace file if ro.ril.recorder_kb is set; every other call is a no-op until then
+void ril_recorder_init(int rilVersion);
+
+// Keep ril_recorder_init() from touching the trace files, for tools that run libril beside
+// the real rild and must not rotate or overwrite its trace
+void ril_recorder_disable(void);
+
+// A request and its arguments were handed to the vendor RIL
+void ril_recorder_request(int request, int32_t token, int slotId, const void *data,
+        size_t datalen);
+
+// The vendor RIL completed a request with the given response
+void ril_recorder_complete(int request, int32_t token, int slotId, RIL_Errno e,
+        const void *response, size_t responselen);
+
+// The vendor RIL sent an unsolicited response
+void ril_recorder_unsol(int unsolResponse, int slotId, const void *data, size_t datalen);
+
+/**
+ * Turn the flattened payload of a record back into the pointers the vendor RIL handed
+ * over. payload is a writable, 8 byte aligned copy of the record's payloadLen bytes and
+ * is updated in place; afterwards it can be passed on with the record's originalLen.
+ * Returns false if the record has no payload that can be handed back.
+ */
+bool ril_recorder_unflatten(const RilRecorderHeader *header, const RilRecord *record,
+        void *payload);
+
+}   // namespace android
+
+#endif // ANDROID_RIL_RECORDER_H
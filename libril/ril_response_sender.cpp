@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "RILC"
+
+#include <deque>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <telephony/ril.h>
+#include <utils/Log.h>
+#include <ril_response_sender.h>
+
+namespace android {
+
+using hardware::Return;
+
+/**
+ * A radio response or indication that has been converted on the vendor RIL thread and
+ * waits for the sender thread of its slot. The closure holds its own reference to the
+ * callback object, so delivering it needs no radio service lock, and counter tells a
+ * failure whether the callbacks have been replaced since.
+ */
+typedef struct QueuedCall {
+    int32_t counter;
+    std::function<Return<void>()> send;
+} QueuedCall;
+
+typedef struct ResponseSender {
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+    std::deque<QueuedCall> queue;
+    bool started = false;
+    uint64_t delivered = 0;
+    size_t maxBatch = 0;
+} ResponseSender;
+
+static ResponseSender s_responseSenders[SIM_COUNT];
+static RilSendFailedCallback s_onSendFailed;
+
+static void *responseSenderLoop(void *param) {
+    int slotId = (int) (intptr_t) param;
+    ResponseSender *sender = &s_responseSenders[slotId];
+    std::deque<QueuedCall> batch;
+
+    for (;;) {
+        pthread_mutex_lock(&sender->mutex);
+        while (sender->queue.empty()) {
+            pthread_cond_wait(&sender->cond, &sender->mutex);
+        }
+        batch.swap(sender->queue);
+        if (batch.size() > sender->maxBatch) {
+            sender->maxBatch = batch.size();
+        }
+        pthread_mutex_unlock(&sender->mutex);
+
+        for (QueuedCall& call : batch) {
+            Return<void> retStatus = call.send();
+            if (!retStatus.isOk()) {
+                s_onSendFailed(slotId, call.counter);
+            }
+        }
+
+        pthread_mutex_lock(&sender->mutex);
+        sender->delivered += batch.size();
+        pthread_mutex_unlock(&sender->mutex);
+        batch.clear();
+    }
+
+    return NULL;
+}
+
+void ril_response_sender_start(int simCount, RilSendFailedCallback onFailed) {
+    s_onSendFailed = onFailed;
+
+    for (int i = 0; i < simCount && i < SIM_COUNT; i++) {
+        pthread_attr_t attr;
+        pthread_t tid;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&tid, &attr, responseSenderLoop, (void *) (intptr_t) i) != 0) {
+            RLOGE("ril_response_sender_start: failed to start sender for slot %d", i);
+        } else {
+            s_responseSenders[i].started = true;
+        }
+        pthread_attr_destroy(&attr);
+    }
+}
+
+bool ril_response_sender_started(int slotId) {
+    return s_responseSenders[slotId].started;
+}
+
+void ril_response_sender_queue(int slotId, int32_t counter,
+        std::function<Return<void>()> send) {
+    ResponseSender *sender = &s_responseSenders[slotId];
+
+    QueuedCall call;
+    call.counter = counter;
+    call.send = std::move(send);
+
+    pthread_mutex_lock(&sender->mutex);
+    sender->queue.push_back(std::move(call));
+    pthread_cond_signal(&sender->cond);
+    pthread_mutex_unlock(&sender->mutex);
+}
+
+void ril_response_sender_dump(int fd) {
+    for (int i = 0; i < SIM_COUNT; i++) {
+        ResponseSender *sender = &s_responseSenders[i];
+        pthread_mutex_lock(&sender->mutex);
+        dprintf(fd, "Response sender %d: started=%d queued=%zu delivered=%" PRIu64
+                " maxBatch=%zu\n", i, sender->started, sender->queue.size(), sender->delivered,
+                sender->maxBatch);
+        pthread_mutex_unlock(&sender->mutex);
+    }
+}
+
+}   // namespace android
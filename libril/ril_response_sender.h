@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_RIL_RESPONSE_SENDER_H
+#define ANDROID_RIL_RESPONSE_SENDER_H
+
+#include <functional>
+#include <hidl/Status.h>
+#include <stdint.h>
+
+namespace android {
+
+// A queued call failed; counter is the radio service counter it was queued under
+typedef void (*RilSendFailedCallback)(int slotId, int32_t counter);
+
+// Start one sender thread for each of the first simCount slots
+void ril_response_sender_start(int simCount, RilSendFailedCallback onFailed);
+
+// Whether calls of slotId go through its sender thread rather than inline
+bool ril_response_sender_started(int slotId);
+
+// Hand a call to the sender thread of slotId, behind every call queued before it
+void ril_response_sender_queue(int slotId, int32_t counter,
+        std::function<hardware::Return<void>()> send);
+
+// Write queue depth, delivered count and largest batch of every slot to fd
+void ril_response_sender_dump(int fd);
+
+}   // namespace android
+
+#endif // ANDROID_RIL_RESPONSE_SENDER_H
@@ -28,10 +28,16 @@
 #include <telephony/ril.h>
 #include <telephony/ril_mnc.h>
 #include <ril_service.h>
+#include <ril_latency.h>
+#include <ril_recorder.h>
+#include <ril_response_sender.h>
 #include <hidl/HidlTransportSupport.h>
 #include <utils/SystemClock.h>
 #include <inttypes.h>
 #include <cutils/properties.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #define INVALID_HEX_CHAR 16
 
@@ -44,6 +50,7 @@ using ::android::hardware::Return;
 using ::android::hardware::hidl_string;
 using ::android::hardware::hidl_vec;
 using ::android::hardware::hidl_array;
+using ::android::hardware::hidl_handle;
 using ::android::hardware::Void;
 using android::CommandInfo;
 using android::RequestInfo;
@@ -54,12 +61,23 @@ using android::sp;
 #define ATOI_NULL_HANDLED(x) (x ? atoi(x) : -1)
 #define ATOI_NULL_HANDLED_DEF(x, defaultVal) (x ? atoi(x) : defaultVal)
 
+// Inline scratch space of a StringArena, enough for the arguments of most requests
+#define STRING_ARENA_INLINE_SIZE 512
+#define STRING_ARENA_CHUNK_SIZE 1024
+
+// Number of networks whose MCC/MNC strings are memoized per slot
+#define CELL_INFO_PLMN_CACHE_SIZE 8
+
+// Deliver radio responses and indications from a per-slot sender thread, not the vendor thread
+#define PROPERTY_ASYNC_RESPONSES "ro.ril.async_responses"
+
+// Size of the hwbinder threadpool serving IRadio and IOemHook
+#define PROPERTY_RPC_THREADS "ro.ril.rpc_threads"
+
+#define CALL_ONREQUEST(a, b, c, d, e) callOnRequest((a), (b), (c), (d), (e))
 #if defined(ANDROID_MULTI_SIM)
-#define CALL_ONREQUEST(a, b, c, d, e) \
-        s_vendorFunctions->onRequest((a), (b), (c), (d), ((RIL_SOCKET_ID)(e)))
 #define CALL_ONSTATEREQUEST(a) s_vendorFunctions->onStateRequest((RIL_SOCKET_ID)(a))
 #else
-#define CALL_ONREQUEST(a, b, c, d, e) s_vendorFunctions->onRequest((a), (b), (c), (d))
 #define CALL_ONSTATEREQUEST(a) s_vendorFunctions->onStateRequest()
 #endif
 
@@ -72,6 +90,30 @@ constexpr bool kOemHookEnabled = true;
 RIL_RadioFunctions *s_vendorFunctions = NULL;
 static CommandInfo *s_commands;
 
+/**
+ * One strand per slot, so the vendor RIL never sees two onRequest() calls for the same socket
+ * at once when the threadpool has more than one thread. Slots still make progress in
+ * parallel. Ordering within each service needs nothing extra: all IRadio and IOemHook
+ * requests are oneway, and hwbinder hands oneway calls to one node one at a time.
+ */
+typedef struct RequestStrand {
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+} RequestStrand;
+
+static RequestStrand s_requestStrands[SIM_COUNT];
+
+static void callOnRequest(int request, void *data, size_t datalen, RequestInfo *pRI,
+        int slotId) {
+    pthread_mutex_lock(&s_requestStrands[slotId].mutex);
+    android::ril_recorder_request(request, pRI->token, slotId, data, datalen);
+#if defined(ANDROID_MULTI_SIM)
+    s_vendorFunctions->onRequest(request, data, datalen, pRI, (RIL_SOCKET_ID) slotId);
+#else
+    s_vendorFunctions->onRequest(request, data, datalen, pRI);
+#endif
+    pthread_mutex_unlock(&s_requestStrands[slotId].mutex);
+}
+
 struct RadioImpl;
 struct OemHookImpl;
 
@@ -468,6 +510,8 @@ struct RadioImpl : public V1_1::IRadio {
     Return<void> setCarrierInfoForImsiEncryption(int32_t serial,
             const V1_1::ImsiEncryptionInfo& message);
 
+    Return<void> debug(const hidl_handle& fd, const hidl_vec<hidl_string>& options);
+
     void checkReturnStatus(Return<void>& ret);
 };
 
@@ -508,6 +552,64 @@ void sendErrorResponse(RequestInfo *pRI, RIL_Errno err) {
             (int) RadioResponseType::SOLICITED, pRI->token, err, NULL, 0);
 }
 
+/**
+ * Scratch memory for the arguments of a single request. Allocations are bumped out of an
+ * inline buffer, and out of heap chunks once that is used up. Everything is wiped and freed
+ * at once when the arena goes out of scope, i.e. after the vendor RIL returned from
+ * onRequest(), so the helpers below need no per-string cleanup on any exit path.
+ */
+struct StringArena {
+    struct alignas(max_align_t) Chunk {
+        Chunk *next;
+        size_t size;
+        size_t used;
+    };
+
+    alignas(max_align_t) char inlineData[STRING_ARENA_INLINE_SIZE];
+    size_t inlineUsed;
+    Chunk *chunks;
+
+    StringArena() : inlineUsed(0), chunks(NULL) {}
+
+    ~StringArena() {
+        memset(inlineData, 0, inlineUsed);
+        while (chunks != NULL) {
+            Chunk *chunk = chunks;
+            chunks = chunk->next;
+            memset(chunk + 1, 0, chunk->used);
+            free(chunk);
+        }
+    }
+
+    /**
+     * Returns size zeroed bytes, aligned for pointers, or NULL if out of memory.
+     */
+    void *alloc(size_t size) {
+        size = (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+        if (size <= STRING_ARENA_INLINE_SIZE - inlineUsed) {
+            char *ptr = inlineData + inlineUsed;
+            inlineUsed += size;
+            memset(ptr, 0, size);
+            return ptr;
+        }
+        if (chunks == NULL || size > chunks->size - chunks->used) {
+            size_t chunkSize = size > STRING_ARENA_CHUNK_SIZE ? size : STRING_ARENA_CHUNK_SIZE;
+            Chunk *chunk = (Chunk *) malloc(sizeof(Chunk) + chunkSize);
+            if (chunk == NULL) {
+                return NULL;
+            }
+            chunk->next = chunks;
+            chunk->size = chunkSize;
+            chunk->used = 0;
+            chunks = chunk;
+        }
+        char *ptr = (char *) (chunks + 1) + chunks->used;
+        chunks->used += size;
+        memset(ptr, 0, size);
+        return ptr;
+    }
+};
+
 /**
  * Copies over src to dest. If memory allocation fails, responseFunction() is called for the
  * request with error RIL_E_NO_MEMORY. The size() method is used to determine the size of the
@@ -545,6 +647,38 @@ bool copyHidlStringToRil(char **dest, const hidl_string &src, RequestInfo *pRI)
     return copyHidlStringToRil(dest, src, pRI, false);
 }
 
+/**
+ * Same as copyHidlStringToRil(), but the copy lives in arena and must not be freed.
+ */
+bool copyHidlStringToArena(char **dest, const hidl_string &src, RequestInfo *pRI,
+        StringArena &arena, bool allowEmpty) {
+    size_t len = src.size();
+    if (len == 0 && !allowEmpty) {
+        *dest = NULL;
+        return true;
+    }
+    *dest = (char *) arena.alloc(len + 1);
+    if (*dest == NULL) {
+        RLOGE("Memory allocation failed for request %s", requestToString(pRI->pCI->requestNumber));
+        sendErrorResponse(pRI, RIL_E_NO_MEMORY);
+        return false;
+    }
+    if (strlcpy(*dest, src.c_str(), len + 1) >= (len + 1)) {
+        RLOGE("Copy of the HIDL string has been truncated, as "
+              "the string length reported by size() does not "
+              "match the length of string returned by c_str().");
+        *dest = NULL;
+        sendErrorResponse(pRI, RIL_E_INTERNAL_ERR);
+        return false;
+    }
+    return true;
+}
+
+bool copyHidlStringToArena(char **dest, const hidl_string &src, RequestInfo *pRI,
+        StringArena &arena) {
+    return copyHidlStringToArena(dest, src, pRI, arena, false);
+}
+
 hidl_string convertCharPtrToHidlString(const char *ptr) {
     hidl_string ret;
     if (ptr != NULL) {
@@ -569,14 +703,13 @@ bool dispatchString(int serial, int slotId, int request, const char * str) {
         return false;
     }
 
+    StringArena arena;
     char *pString;
-    if (!copyHidlStringToRil(&pString, str, pRI)) {
+    if (!copyHidlStringToArena(&pString, str, pRI, arena)) {
         return false;
     }
 
     CALL_ONREQUEST(request, pString, sizeof(char *), pRI, slotId);
-
-    memsetAndFreeStrings(1, pString);
     return true;
 }
 
@@ -586,8 +719,9 @@ bool dispatchStrings(int serial, int slotId, int request, bool allowEmpty, int c
         return false;
     }
 
+    StringArena arena;
     char **pStrings;
-    pStrings = (char **)calloc(countStrings, sizeof(char *));
+    pStrings = (char **) arena.alloc(countStrings * sizeof(char *));
     if (pStrings == NULL) {
         RLOGE("Memory allocation failed for request %s", requestToString(request));
         sendErrorResponse(pRI, RIL_E_NO_MEMORY);
@@ -597,12 +731,8 @@ bool dispatchStrings(int serial, int slotId, int request, bool allowEmpty, int c
     va_start(ap, countStrings);
     for (int i = 0; i < countStrings; i++) {
         const char* str = va_arg(ap, const char *);
-        if (!copyHidlStringToRil(&pStrings[i], hidl_string(str), pRI, allowEmpty)) {
+        if (!copyHidlStringToArena(&pStrings[i], hidl_string(str), pRI, arena, allowEmpty)) {
             va_end(ap);
-            for (int j = 0; j < i; j++) {
-                memsetAndFreeStrings(1, pStrings[j]);
-            }
-            free(pStrings);
             return false;
         }
     }
@@ -610,17 +740,6 @@ bool dispatchStrings(int serial, int slotId, int request, bool allowEmpty, int c
 
     CALL_ONREQUEST(request, pStrings, countStrings * sizeof(char *), pRI, slotId);
 
-    if (pStrings != NULL) {
-        for (int i = 0 ; i < countStrings ; i++) {
-            memsetAndFreeStrings(1, pStrings[i]);
-        }
-
-#ifdef MEMSET_FREED
-        memset(pStrings, 0, countStrings * sizeof(char *));
-#endif
-        free(pStrings);
-    }
-
     /**
       * Sony 8960 RIL stack compatibility
       * Qualcomm's RIL doesn't seem to issue any callbacks for opcode 47
@@ -644,8 +763,9 @@ bool dispatchStrings(int serial, int slotId, int request, const hidl_vec<hidl_st
     }
 
     int countStrings = data.size();
+    StringArena arena;
     char **pStrings;
-    pStrings = (char **)calloc(countStrings, sizeof(char *));
+    pStrings = (char **) arena.alloc(countStrings * sizeof(char *));
     if (pStrings == NULL) {
         RLOGE("Memory allocation failed for request %s", requestToString(request));
         sendErrorResponse(pRI, RIL_E_NO_MEMORY);
@@ -653,27 +773,12 @@ bool dispatchStrings(int serial, int slotId, int request, const hidl_vec<hidl_st
     }
 
     for (int i = 0; i < countStrings; i++) {
-        if (!copyHidlStringToRil(&pStrings[i], data[i], pRI)) {
-            for (int j = 0; j < i; j++) {
-                memsetAndFreeStrings(1, pStrings[j]);
-            }
-            free(pStrings);
+        if (!copyHidlStringToArena(&pStrings[i], data[i], pRI, arena)) {
             return false;
         }
     }
 
     CALL_ONREQUEST(request, pStrings, countStrings * sizeof(char *), pRI, slotId);
-
-    if (pStrings != NULL) {
-        for (int i = 0 ; i < countStrings ; i++) {
-            memsetAndFreeStrings(1, pStrings[i]);
-        }
-
-#ifdef MEMSET_FREED
-        memset(pStrings, 0, countStrings * sizeof(char *));
-#endif
-        free(pStrings);
-    }
     return true;
 }
 
@@ -722,14 +827,13 @@ bool dispatchCallForwardStatus(int serial, int slotId, int request,
     cf.toa = callInfo.toa;
     cf.timeSeconds = callInfo.timeSeconds;
 
-    if (!copyHidlStringToRil(&cf.number, callInfo.number, pRI)) {
+    StringArena arena;
+    if (!copyHidlStringToArena(&cf.number, callInfo.number, pRI, arena)) {
         return false;
     }
 
     CALL_ONREQUEST(request, &cf, sizeof(cf), pRI, slotId);
 
-    memsetAndFreeStrings(1, cf.number);
-
     return true;
 }
 
@@ -761,14 +865,13 @@ bool dispatchIccApdu(int serial, int slotId, int request, const SimApdu& message
     apdu.p2 = message.p2;
     apdu.p3 = message.p3;
 
-    if (!copyHidlStringToRil(&apdu.data, message.data, pRI)) {
+    StringArena arena;
+    if (!copyHidlStringToArena(&apdu.data, message.data, pRI, arena)) {
         return false;
     }
 
     CALL_ONREQUEST(request, &apdu, sizeof(apdu), pRI, slotId);
 
-    memsetAndFreeStrings(1, apdu.data);
-
     return true;
 }
 
@@ -822,23 +925,92 @@ void RadioImpl::checkReturnStatus(Return<void>& ret) {
     ::checkReturnStatus(mSlotId, ret, true);
 }
 
+/**
+ * Same as checkReturnStatus() for a radio call sent by the sender thread of the slot, which
+ * holds no rdlock.
+ */
+static void resetRadioResponseFunctions(int slotId, int32_t counter) {
+    RLOGE("resetRadioResponseFunctions: unable to call response/indication callback");
+
+    pthread_rwlock_t *radioServiceRwlockPtr = radio::getRadioServiceRwlock(slotId);
+    int ret = pthread_rwlock_wrlock(radioServiceRwlockPtr);
+    assert(ret == 0);
+
+    if (counter == mCounterRadio[slotId]) {
+        radioService[slotId]->mRadioResponse = NULL;
+        radioService[slotId]->mRadioIndication = NULL;
+        radioService[slotId]->mRadioResponseV1_1 = NULL;
+        radioService[slotId]->mRadioIndicationV1_1 = NULL;
+        mCounterRadio[slotId]++;
+    }
+
+    ret = pthread_rwlock_unlock(radioServiceRwlockPtr);
+    assert(ret == 0);
+}
+
+static void startResponseSenders(int simCount) {
+    if (!property_get_bool(PROPERTY_ASYNC_RESPONSES, false)) {
+        return;
+    }
+    android::ril_response_sender_start(simCount, resetRadioResponseFunctions);
+}
+
+template <typename T, typename Method, typename Tuple, size_t... N>
+static Return<void> invokeRadioCall(const sp<T>& target, Method method, const Tuple& values,
+        std::index_sequence<N...>) {
+    return (target.get()->*method)(std::get<N>(values)...);
+}
+
+/**
+ * Call method of an IRadioResponse or IRadioIndication of slotId. Once the sender thread of
+ * the slot runs, every response and indication of the slot goes through it, in the order
+ * they are made here; the arguments are copied now, so they may point into the vendor
+ * payload, and the call itself reports Void(). Must be called with the rdlock of the slot
+ * held, as all response and indication functions are.
+ */
+template <typename T, typename I, typename... Params, typename... Args>
+static Return<void> sendRadioCall(int slotId, const sp<T>& target,
+        Return<void> (I::*method)(Params...), Args&&... args) {
+    if (!android::ril_response_sender_started(slotId)) {
+        return (target.get()->*method)(std::forward<Args>(args)...);
+    }
+
+    std::tuple<typename std::decay<Params>::type...> values(std::forward<Args>(args)...);
+    android::ril_response_sender_queue(slotId, mCounterRadio[slotId],
+            [target, method, values]() {
+                return invokeRadioCall(target, method, values,
+                        std::index_sequence_for<Params...>());
+            });
+    return Void();
+}
+
 Return<void> RadioImpl::setResponseFunctions(
         const ::android::sp<IRadioResponse>& radioResponseParam,
         const ::android::sp<IRadioIndication>& radioIndicationParam) {
     RLOGD("setResponseFunctions");
 
+    // castFrom() is a binder transaction, so resolve the 1.1 interfaces before taking the
+    // write lock; the lock then only covers the pointer swaps.
+    sp<IRadioResponse> radioResponse = radioResponseParam;
+    sp<IRadioIndication> radioIndication = radioIndicationParam;
+    sp<V1_1::IRadioResponse> radioResponseV1_1 =
+            V1_1::IRadioResponse::castFrom(radioResponse).withDefault(nullptr);
+    sp<V1_1::IRadioIndication> radioIndicationV1_1 =
+            V1_1::IRadioIndication::castFrom(radioIndication).withDefault(nullptr);
+    if (radioResponseV1_1 == nullptr || radioIndicationV1_1 == nullptr) {
+        radioResponseV1_1 = nullptr;
+        radioIndicationV1_1 = nullptr;
+    }
+
     pthread_rwlock_t *radioServiceRwlockPtr = radio::getRadioServiceRwlock(mSlotId);
     int ret = pthread_rwlock_wrlock(radioServiceRwlockPtr);
     assert(ret == 0);
 
-    mRadioResponse = radioResponseParam;
-    mRadioIndication = radioIndicationParam;
-    mRadioResponseV1_1 = V1_1::IRadioResponse::castFrom(mRadioResponse).withDefault(nullptr);
-    mRadioIndicationV1_1 = V1_1::IRadioIndication::castFrom(mRadioIndication).withDefault(nullptr);
-    if (mRadioResponseV1_1 == nullptr || mRadioIndicationV1_1 == nullptr) {
-        mRadioResponseV1_1 = nullptr;
-        mRadioIndicationV1_1 = nullptr;
-    }
+    // swap rather than assign so the old callbacks are released after unlocking
+    mRadioResponse.swap(radioResponse);
+    mRadioIndication.swap(radioIndication);
+    mRadioResponseV1_1.swap(radioResponseV1_1);
+    mRadioIndicationV1_1.swap(radioIndicationV1_1);
 
     mCounterRadio[mSlotId]++;
 
@@ -948,8 +1120,9 @@ Return<void> RadioImpl::dial(int32_t serial, const Dial& dialInfo) {
     RIL_Dial dial = {};
     RIL_UUS_Info uusInfo = {};
     int32_t sizeOfDial = sizeof(dial);
+    StringArena arena;
 
-    if (!copyHidlStringToRil(&dial.address, dialInfo.address, pRI)) {
+    if (!copyHidlStringToArena(&dial.address, dialInfo.address, pRI, arena)) {
         return Void();
     }
     dial.clir = (int) dialInfo.clir;
@@ -962,8 +1135,8 @@ Return<void> RadioImpl::dial(int32_t serial, const Dial& dialInfo) {
             uusInfo.uusData = NULL;
             uusInfo.uusLength = 0;
         } else {
-            if (!copyHidlStringToRil(&uusInfo.uusData, dialInfo.uusInfo[0].uusData, pRI)) {
-                memsetAndFreeStrings(1, dial.address);
+            if (!copyHidlStringToArena(&uusInfo.uusData, dialInfo.uusInfo[0].uusData, pRI,
+                    arena)) {
                 return Void();
             }
             uusInfo.uusLength = dialInfo.uusInfo[0].uusData.size();
@@ -974,8 +1147,6 @@ Return<void> RadioImpl::dial(int32_t serial, const Dial& dialInfo) {
 
     CALL_ONREQUEST(RIL_REQUEST_DIAL, &dial, sizeOfDial, pRI, mSlotId);
 
-    memsetAndFreeStrings(2, dial.address, uusInfo.uusData);
-
     return Void();
 }
 
@@ -1191,10 +1362,11 @@ Return<void> RadioImpl::iccIOForApp(int32_t serial, const IccIo& iccIo) {
         return Void();
     }
 
+    StringArena arena;
     RIL_SIM_IO_v6 rilIccIo = {};
     rilIccIo.command = iccIo.command;
     rilIccIo.fileid = iccIo.fileId;
-    if (!copyHidlStringToRil(&rilIccIo.path, iccIo.path, pRI)) {
+    if (!copyHidlStringToArena(&rilIccIo.path, iccIo.path, pRI, arena)) {
         return Void();
     }
 
@@ -1202,25 +1374,14 @@ Return<void> RadioImpl::iccIOForApp(int32_t serial, const IccIo& iccIo) {
     rilIccIo.p2 = iccIo.p2;
     rilIccIo.p3 = iccIo.p3;
 
-    if (!copyHidlStringToRil(&rilIccIo.data, iccIo.data, pRI)) {
-        memsetAndFreeStrings(1, rilIccIo.path);
-        return Void();
-    }
-
-    if (!copyHidlStringToRil(&rilIccIo.pin2, iccIo.pin2, pRI)) {
-        memsetAndFreeStrings(2, rilIccIo.path, rilIccIo.data);
-        return Void();
-    }
-
-    if (!copyHidlStringToRil(&rilIccIo.aidPtr, iccIo.aid, pRI)) {
-        memsetAndFreeStrings(3, rilIccIo.path, rilIccIo.data, rilIccIo.pin2);
+    if (!copyHidlStringToArena(&rilIccIo.data, iccIo.data, pRI, arena)
+            || !copyHidlStringToArena(&rilIccIo.pin2, iccIo.pin2, pRI, arena)
+            || !copyHidlStringToArena(&rilIccIo.aidPtr, iccIo.aid, pRI, arena)) {
         return Void();
     }
 
     CALL_ONREQUEST(RIL_REQUEST_SIM_IO, &rilIccIo, sizeof(rilIccIo), pRI, mSlotId);
 
-    memsetAndFreeStrings(4, rilIccIo.path, rilIccIo.data, rilIccIo.pin2, rilIccIo.aidPtr);
-
     return Void();
 }
 
@@ -1552,22 +1713,17 @@ Return<void> RadioImpl::writeSmsToSim(int32_t serial, const SmsWriteArgs& smsWri
         return Void();
     }
 
+    StringArena arena;
     RIL_SMS_WriteArgs args;
     args.status = (int) smsWriteArgs.status;
 
-    if (!copyHidlStringToRil(&args.pdu, smsWriteArgs.pdu, pRI)) {
-        return Void();
-    }
-
-    if (!copyHidlStringToRil(&args.smsc, smsWriteArgs.smsc, pRI)) {
-        memsetAndFreeStrings(1, args.pdu);
+    if (!copyHidlStringToArena(&args.pdu, smsWriteArgs.pdu, pRI, arena)
+            || !copyHidlStringToArena(&args.smsc, smsWriteArgs.smsc, pRI, arena)) {
         return Void();
     }
 
     CALL_ONREQUEST(RIL_REQUEST_WRITE_SMS_TO_SIM, &args, sizeof(args), pRI, mSlotId);
 
-    memsetAndFreeStrings(2, args.smsc, args.pdu);
-
     return Void();
 }
 
@@ -2052,55 +2208,37 @@ Return<void> RadioImpl::setInitialAttachApn(int32_t serial, const DataProfileInf
         return Void();
     }
 
+    StringArena arena;
+
     if (s_vendorFunctions->version <= 14) {
         RIL_InitialAttachApn iaa = {};
 
-        if (!copyHidlStringToRil(&iaa.apn, dataProfileInfo.apn, pRI, true)) {
-            return Void();
-        }
-
         const hidl_string &protocol =
                 (isRoaming ? dataProfileInfo.roamingProtocol : dataProfileInfo.protocol);
 
-        if (!copyHidlStringToRil(&iaa.protocol, protocol, pRI)) {
-            memsetAndFreeStrings(1, iaa.apn);
+        if (!copyHidlStringToArena(&iaa.apn, dataProfileInfo.apn, pRI, arena, true)
+                || !copyHidlStringToArena(&iaa.protocol, protocol, pRI, arena)) {
             return Void();
         }
         iaa.authtype = (int) dataProfileInfo.authType;
-        if (!copyHidlStringToRil(&iaa.username, dataProfileInfo.user, pRI)) {
-            memsetAndFreeStrings(2, iaa.apn, iaa.protocol);
-            return Void();
-        }
-        if (!copyHidlStringToRil(&iaa.password, dataProfileInfo.password, pRI)) {
-            memsetAndFreeStrings(3, iaa.apn, iaa.protocol, iaa.username);
+        if (!copyHidlStringToArena(&iaa.username, dataProfileInfo.user, pRI, arena)
+                || !copyHidlStringToArena(&iaa.password, dataProfileInfo.password, pRI, arena)) {
             return Void();
         }
 
         CALL_ONREQUEST(RIL_REQUEST_SET_INITIAL_ATTACH_APN, &iaa, sizeof(iaa), pRI, mSlotId);
-
-        memsetAndFreeStrings(4, iaa.apn, iaa.protocol, iaa.username, iaa.password);
     } else {
         RIL_InitialAttachApn_v15 iaa = {};
 
-        if (!copyHidlStringToRil(&iaa.apn, dataProfileInfo.apn, pRI, true)) {
-            return Void();
-        }
-
-        if (!copyHidlStringToRil(&iaa.protocol, dataProfileInfo.protocol, pRI)) {
-            memsetAndFreeStrings(1, iaa.apn);
-            return Void();
-        }
-        if (!copyHidlStringToRil(&iaa.roamingProtocol, dataProfileInfo.roamingProtocol, pRI)) {
-            memsetAndFreeStrings(2, iaa.apn, iaa.protocol);
+        if (!copyHidlStringToArena(&iaa.apn, dataProfileInfo.apn, pRI, arena, true)
+                || !copyHidlStringToArena(&iaa.protocol, dataProfileInfo.protocol, pRI, arena)
+                || !copyHidlStringToArena(&iaa.roamingProtocol, dataProfileInfo.roamingProtocol,
+                        pRI, arena)) {
             return Void();
         }
         iaa.authtype = (int) dataProfileInfo.authType;
-        if (!copyHidlStringToRil(&iaa.username, dataProfileInfo.user, pRI)) {
-            memsetAndFreeStrings(3, iaa.apn, iaa.protocol, iaa.roamingProtocol);
-            return Void();
-        }
-        if (!copyHidlStringToRil(&iaa.password, dataProfileInfo.password, pRI)) {
-            memsetAndFreeStrings(4, iaa.apn, iaa.protocol, iaa.roamingProtocol, iaa.username);
+        if (!copyHidlStringToArena(&iaa.username, dataProfileInfo.user, pRI, arena)
+                || !copyHidlStringToArena(&iaa.password, dataProfileInfo.password, pRI, arena)) {
             return Void();
         }
         iaa.supportedTypesBitmask = dataProfileInfo.supportedApnTypesBitmap;
@@ -2110,21 +2248,15 @@ Return<void> RadioImpl::setInitialAttachApn(int32_t serial, const DataProfileInf
 
         if (!convertMvnoTypeToString(dataProfileInfo.mvnoType, iaa.mvnoType)) {
             sendErrorResponse(pRI, RIL_E_INVALID_ARGUMENTS);
-            memsetAndFreeStrings(5, iaa.apn, iaa.protocol, iaa.roamingProtocol, iaa.username,
-                    iaa.password);
             return Void();
         }
 
-        if (!copyHidlStringToRil(&iaa.mvnoMatchData, dataProfileInfo.mvnoMatchData, pRI)) {
-            memsetAndFreeStrings(5, iaa.apn, iaa.protocol, iaa.roamingProtocol, iaa.username,
-                    iaa.password);
+        if (!copyHidlStringToArena(&iaa.mvnoMatchData, dataProfileInfo.mvnoMatchData, pRI,
+                arena)) {
             return Void();
         }
 
         CALL_ONREQUEST(RIL_REQUEST_SET_INITIAL_ATTACH_APN, &iaa, sizeof(iaa), pRI, mSlotId);
-
-        memsetAndFreeStrings(6, iaa.apn, iaa.protocol, iaa.roamingProtocol, iaa.username,
-                iaa.password, iaa.mvnoMatchData);
     }
 
     return Void();
@@ -2154,7 +2286,8 @@ bool dispatchImsGsmSms(const ImsSmsMessage& message, RequestInfo *pRI) {
         return false;
     }
 
-    pStrings = (char **)calloc(countStrings, sizeof(char *));
+    StringArena arena;
+    pStrings = (char **) arena.alloc(dataLen);
     if (pStrings == NULL) {
         RLOGE("dispatchImsGsmSms: Memory allocation failed for request %s",
                 requestToString(pRI->pCI->requestNumber));
@@ -2162,20 +2295,8 @@ bool dispatchImsGsmSms(const ImsSmsMessage& message, RequestInfo *pRI) {
         return false;
     }
 
-    if (!copyHidlStringToRil(&pStrings[0], message.gsmMessage[0].smscPdu, pRI)) {
-#ifdef MEMSET_FREED
-        memset(pStrings, 0, dataLen);
-#endif
-        free(pStrings);
-        return false;
-    }
-
-    if (!copyHidlStringToRil(&pStrings[1], message.gsmMessage[0].pdu, pRI)) {
-        memsetAndFreeStrings(1, pStrings[0]);
-#ifdef MEMSET_FREED
-        memset(pStrings, 0, dataLen);
-#endif
-        free(pStrings);
+    if (!copyHidlStringToArena(&pStrings[0], message.gsmMessage[0].smscPdu, pRI, arena)
+            || !copyHidlStringToArena(&pStrings[1], message.gsmMessage[0].pdu, pRI, arena)) {
         return false;
     }
 
@@ -2183,15 +2304,6 @@ bool dispatchImsGsmSms(const ImsSmsMessage& message, RequestInfo *pRI) {
     CALL_ONREQUEST(pRI->pCI->requestNumber, &rism, sizeof(RIL_RadioTechnologyFamily) +
             sizeof(uint8_t) + sizeof(int32_t) + dataLen, pRI, pRI->socket_id);
 
-    for (int i = 0 ; i < countStrings ; i++) {
-        memsetAndFreeStrings(1, pStrings[i]);
-    }
-
-#ifdef MEMSET_FREED
-    memset(pStrings, 0, dataLen);
-#endif
-    free(pStrings);
-
     return true;
 }
 
@@ -2786,6 +2898,9 @@ Return<void> RadioImpl::sendDeviceState(int32_t serial, DeviceStateType deviceSt
 #if VDBG
     RLOGD("sendDeviceState: serial %d", serial);
 #endif
+    if (deviceStateType == DeviceStateType::LOW_DATA_EXPECTED) {
+        android::onScreenStateChanged(!state);
+    }
     if (s_vendorFunctions->version < 15) {
         if (deviceStateType ==  DeviceStateType::LOW_DATA_EXPECTED) {
             RLOGD("sendDeviceState: calling screen state %d", BOOL_TO_INT(!state));
@@ -2933,6 +3048,20 @@ Return<void> RadioImpl::responseAcknowledgement() {
     return Void();
 }
 
+Return<void> RadioImpl::debug(const hidl_handle& fd, const hidl_vec<hidl_string>& options) {
+    if (fd.getNativeHandle() == NULL || fd->numFds < 1) {
+        RLOGE("debug: invalid fd handle");
+        return Void();
+    }
+    android::dumpPendingRequests(fd->data[0]);
+    android::dumpObjectPools(fd->data[0]);
+    android::dumpUnsolCoalescing(fd->data[0]);
+    android::dumpWakeLockStats(fd->data[0]);
+    android::ril_response_sender_dump(fd->data[0]);
+    android::ril_latency_dump(fd->data[0]);
+    return Void();
+}
+
 Return<void> OemHookImpl::setResponseFunctions(
         const ::android::sp<IOemHookResponse>& oemHookResponseParam,
         const ::android::sp<IOemHookIndication>& oemHookIndicationParam) {
@@ -2940,12 +3069,16 @@ Return<void> OemHookImpl::setResponseFunctions(
     RLOGD("OemHookImpl::setResponseFunctions");
 #endif
 
+    sp<IOemHookResponse> oemHookResponse = oemHookResponseParam;
+    sp<IOemHookIndication> oemHookIndication = oemHookIndicationParam;
+
     pthread_rwlock_t *radioServiceRwlockPtr = radio::getRadioServiceRwlock(mSlotId);
     int ret = pthread_rwlock_wrlock(radioServiceRwlockPtr);
     assert(ret == 0);
 
-    mOemHookResponse = oemHookResponseParam;
-    mOemHookIndication = oemHookIndicationParam;
+    // swap rather than assign so the old callbacks are released after unlocking
+    mOemHookResponse.swap(oemHookResponse);
+    mOemHookIndication.swap(oemHookIndication);
     mCounterOemHook[mSlotId]++;
 
     ret = pthread_rwlock_unlock(radioServiceRwlockPtr);
@@ -2979,7 +3112,8 @@ Return<void> OemHookImpl::sendRequestStrings(int32_t serial,
 
 void radio::acknowledgeRequest(int slotId, int serial) {
     if (radioService[slotId]->mRadioResponse != NULL) {
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->acknowledgeRequest(serial);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::acknowledgeRequest, serial);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("acknowledgeRequest: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -3034,6 +3168,70 @@ int responseInt(RadioResponseInfo& responseInfo, int serial, int responseType, R
     return ret;
 }
 
+/**
+ * Response descriptors: the method to call on IRadioResponse and its name for logging.
+ * Responses that carry nothing but RadioResponseInfo, or a single fixed size value, go
+ * through the senders below rather than a hand written body each, so their marshalling,
+ * logging and error handling live in one place.
+ */
+#define RADIO_RESPONSE(name) #name, &IRadioResponse::name
+
+int sendResponseInfo(const char *name,
+        Return<void> (IRadioResponse::*method)(const RadioResponseInfo&),
+        int slotId, int responseType, int serial, RIL_Errno e) {
+#if VDBG
+    RLOGD("%s: serial %d", name, serial);
+#endif
+
+    if (radioService[slotId]->mRadioResponse != NULL) {
+        RadioResponseInfo responseInfo = {};
+        populateResponseInfo(responseInfo, serial, responseType, e);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                method, responseInfo);
+        radioService[slotId]->checkReturnStatus(retStatus);
+    } else {
+        RLOGE("%s: radioService[%d]->mRadioResponse == NULL", name, slotId);
+    }
+
+    return 0;
+}
+
+/**
+ * The vendor RIL must report exactly sizeof(T) bytes; anything else is an invalid response
+ * and the HAL gets -1.
+ */
+template <typename T>
+int sendScalarResponse(const char *name,
+        Return<void> (IRadioResponse::*method)(const RadioResponseInfo&, T),
+        int slotId, int responseType, int serial, RIL_Errno e, void *response,
+        size_t responseLen) {
+    static_assert(std::is_arithmetic<T>::value, "scalar responses carry a single number");
+    constexpr size_t expectedLen = sizeof(T);
+
+#if VDBG
+    RLOGD("%s: serial %d", name, serial);
+#endif
+
+    if (radioService[slotId]->mRadioResponse != NULL) {
+        RadioResponseInfo responseInfo = {};
+        populateResponseInfo(responseInfo, serial, responseType, e);
+        T ret = (T) -1;
+        if (response == NULL || responseLen != expectedLen) {
+            RLOGE("%s: Invalid response", name);
+            if (e == RIL_E_SUCCESS) responseInfo.error = RadioError::INVALID_RESPONSE;
+        } else {
+            memcpy(&ret, response, expectedLen);
+        }
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                method, responseInfo, ret);
+        radioService[slotId]->checkReturnStatus(retStatus);
+    } else {
+        RLOGE("%s: radioService[%d]->mRadioResponse == NULL", name, slotId);
+    }
+
+    return 0;
+}
+
 int radio::getIccCardStatusResponse(int slotId,
                                    int responseType, int serial, RIL_Errno e,
                                    void *response, size_t responseLen) {
@@ -3074,8 +3272,8 @@ int radio::getIccCardStatusResponse(int slotId,
             }
         }
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->
-                getIccCardStatusResponse(responseInfo, cardStatus);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getIccCardStatusResponse, responseInfo, cardStatus);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getIccCardStatusResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -3094,8 +3292,8 @@ int radio::supplyIccPinForAppResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseIntOrEmpty(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->
-                supplyIccPinForAppResponse(responseInfo, ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::supplyIccPinForAppResponse, responseInfo, ret);
         RLOGE("supplyIccPinForAppResponse: amit ret %d", ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -3116,8 +3314,8 @@ int radio::supplyIccPukForAppResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseIntOrEmpty(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->supplyIccPukForAppResponse(
-                responseInfo, ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::supplyIccPukForAppResponse, responseInfo, ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("supplyIccPukForAppResponse: radioService[%d]->mRadioResponse == NULL",
@@ -3137,8 +3335,8 @@ int radio::supplyIccPin2ForAppResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseIntOrEmpty(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->
-                supplyIccPin2ForAppResponse(responseInfo, ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::supplyIccPin2ForAppResponse, responseInfo, ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("supplyIccPin2ForAppResponse: radioService[%d]->mRadioResponse == NULL",
@@ -3158,8 +3356,8 @@ int radio::supplyIccPuk2ForAppResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseIntOrEmpty(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->
-                supplyIccPuk2ForAppResponse(responseInfo, ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::supplyIccPuk2ForAppResponse, responseInfo, ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("supplyIccPuk2ForAppResponse: radioService[%d]->mRadioResponse == NULL",
@@ -3179,8 +3377,8 @@ int radio::changeIccPinForAppResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseIntOrEmpty(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->
-                changeIccPinForAppResponse(responseInfo, ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::changeIccPinForAppResponse, responseInfo, ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("changeIccPinForAppResponse: radioService[%d]->mRadioResponse == NULL",
@@ -3200,8 +3398,8 @@ int radio::changeIccPin2ForAppResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseIntOrEmpty(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->
-                changeIccPin2ForAppResponse(responseInfo, ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::changeIccPin2ForAppResponse, responseInfo, ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("changeIccPin2ForAppResponse: radioService[%d]->mRadioResponse == NULL",
@@ -3221,8 +3419,8 @@ int radio::supplyNetworkDepersonalizationResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseIntOrEmpty(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->
-                supplyNetworkDepersonalizationResponse(responseInfo, ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::supplyNetworkDepersonalizationResponse, responseInfo, ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("supplyNetworkDepersonalizationResponse: radioService[%d]->mRadioResponse == "
@@ -3280,8 +3478,8 @@ int radio::getCurrentCallsResponse(int slotId,
             }
         }
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->
-                getCurrentCallsResponse(responseInfo, calls);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getCurrentCallsResponse, responseInfo, calls);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getCurrentCallsResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -3293,20 +3491,7 @@ int radio::getCurrentCallsResponse(int slotId,
 int radio::dialResponse(int slotId,
                        int responseType, int serial, RIL_Errno e, void *response,
                        size_t responseLen) {
-#if VDBG
-    RLOGD("dialResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->dialResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("dialResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(dialResponse), slotId, responseType, serial, e);
 }
 
 int radio::getIMSIForAppResponse(int slotId,
@@ -3319,8 +3504,9 @@ int radio::getIMSIForAppResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getIMSIForAppResponse(
-                responseInfo, convertCharPtrToHidlString((char *) response));
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getIMSIForAppResponse, responseInfo,
+                convertCharPtrToHidlString((char *) response));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getIMSIForAppResponse: radioService[%d]->mRadioResponse == NULL",
@@ -3333,44 +3519,15 @@ int radio::getIMSIForAppResponse(int slotId,
 int radio::hangupConnectionResponse(int slotId,
                                    int responseType, int serial, RIL_Errno e,
                                    void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("hangupConnectionResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->hangupConnectionResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("hangupConnectionResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(hangupConnectionResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::hangupWaitingOrBackgroundResponse(int slotId,
                                             int responseType, int serial, RIL_Errno e,
                                             void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("hangupWaitingOrBackgroundResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus =
-                radioService[slotId]->mRadioResponse->hangupWaitingOrBackgroundResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("hangupWaitingOrBackgroundResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(hangupWaitingOrBackgroundResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::hangupForegroundResumeBackgroundResponse(int slotId, int responseType, int serial,
@@ -3383,9 +3540,8 @@ int radio::hangupForegroundResumeBackgroundResponse(int slotId, int responseType
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus =
-                radioService[slotId]->mRadioResponse->hangupWaitingOrBackgroundResponse(
-                responseInfo);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::hangupWaitingOrBackgroundResponse, responseInfo);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("hangupWaitingOrBackgroundResponse: radioService[%d]->mRadioResponse == NULL",
@@ -3398,63 +3554,18 @@ int radio::hangupForegroundResumeBackgroundResponse(int slotId, int responseType
 int radio::switchWaitingOrHoldingAndActiveResponse(int slotId, int responseType, int serial,
                                                    RIL_Errno e, void *response,
                                                    size_t responseLen) {
-#if VDBG
-    RLOGD("switchWaitingOrHoldingAndActiveResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus =
-                radioService[slotId]->mRadioResponse->switchWaitingOrHoldingAndActiveResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("switchWaitingOrHoldingAndActiveResponse: radioService[%d]->mRadioResponse "
-                "== NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(switchWaitingOrHoldingAndActiveResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::conferenceResponse(int slotId, int responseType,
                              int serial, RIL_Errno e, void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("conferenceResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->conferenceResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("conferenceResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(conferenceResponse), slotId, responseType, serial, e);
 }
 
 int radio::rejectCallResponse(int slotId, int responseType,
                              int serial, RIL_Errno e, void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("rejectCallResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->rejectCallResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("rejectCallResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(rejectCallResponse), slotId, responseType, serial, e);
 }
 
 int radio::getLastCallFailCauseResponse(int slotId,
@@ -3485,8 +3596,8 @@ int radio::getLastCallFailCauseResponse(int slotId,
             if (e == RIL_E_SUCCESS) responseInfo.error = RadioError::INVALID_RESPONSE;
         }
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getLastCallFailCauseResponse(
-                responseInfo, info);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getLastCallFailCauseResponse, responseInfo, info);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getLastCallFailCauseResponse: radioService[%d]->mRadioResponse == NULL",
@@ -3515,8 +3626,8 @@ int radio::getSignalStrengthResponse(int slotId,
             convertRilSignalStrengthToHal(response, responseLen, signalStrength);
         }
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getSignalStrengthResponse(
-                responseInfo, signalStrength);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getSignalStrengthResponse, responseInfo, signalStrength);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getSignalStrengthResponse: radioService[%d]->mRadioResponse == NULL",
@@ -3919,9 +4030,8 @@ int radio::getVoiceRegistrationStateResponse(int slotId,
             }
         }
 
-        Return<void> retStatus =
-                radioService[slotId]->mRadioResponse->getVoiceRegistrationStateResponse(
-                responseInfo, voiceRegResponse);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getVoiceRegistrationStateResponse, responseInfo, voiceRegResponse);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getVoiceRegistrationStateResponse: radioService[%d]->mRadioResponse == NULL",
@@ -3975,9 +4085,8 @@ int radio::getDataRegistrationStateResponse(int slotId,
             }
         }
 
-        Return<void> retStatus =
-                radioService[slotId]->mRadioResponse->getDataRegistrationStateResponse(responseInfo,
-                dataRegResponse);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getDataRegistrationStateResponse, responseInfo, dataRegResponse);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getDataRegistrationStateResponse: radioService[%d]->mRadioResponse == NULL",
@@ -4011,8 +4120,8 @@ int radio::getOperatorResponse(int slotId,
             shortName = convertCharPtrToHidlString(resp[1]);
             numeric = convertCharPtrToHidlString(resp[2]);
         }
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getOperatorResponse(
-                responseInfo, longName, shortName, numeric);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getOperatorResponse, responseInfo, longName, shortName, numeric);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getOperatorResponse: radioService[%d]->mRadioResponse == NULL",
@@ -4030,8 +4139,8 @@ int radio::setRadioPowerResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->setRadioPowerResponse(
-                responseInfo);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::setRadioPowerResponse, responseInfo);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("setRadioPowerResponse: radioService[%d]->mRadioResponse == NULL",
@@ -4044,22 +4153,7 @@ int radio::setRadioPowerResponse(int slotId,
 int radio::sendDtmfResponse(int slotId,
                            int responseType, int serial, RIL_Errno e, void *response,
                            size_t responseLen) {
-#if VDBG
-    RLOGD("sendDtmfResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->sendDtmfResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("sendDtmfResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(sendDtmfResponse), slotId, responseType, serial, e);
 }
 
 SendSmsResult makeSendSmsResult(RadioResponseInfo& responseInfo, int serial, int responseType,
@@ -4092,8 +4186,8 @@ int radio::sendSmsResponse(int slotId,
         SendSmsResult result = makeSendSmsResult(responseInfo, serial, responseType, e, response,
                 responseLen);
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->sendSmsResponse(responseInfo,
-                result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::sendSmsResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("sendSmsResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -4114,8 +4208,8 @@ int radio::sendSMSExpectMoreResponse(int slotId,
         SendSmsResult result = makeSendSmsResult(responseInfo, serial, responseType, e, response,
                 responseLen);
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->sendSMSExpectMoreResponse(
-                responseInfo, result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::sendSMSExpectMoreResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("sendSMSExpectMoreResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -4159,8 +4253,8 @@ int radio::setupDataCallResponse(int slotId,
             convertRilDataCallToHal((RIL_Data_Call_Response_v6 *) response, result);
         }
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->setupDataCallResponse(
-                responseInfo, result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::setupDataCallResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("setupDataCallResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -4199,8 +4293,8 @@ int radio::iccIOForAppResponse(int slotId,
         IccIoResult result = responseIccIo(responseInfo, serial, responseType, e, response,
                 responseLen);
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->iccIOForAppResponse(
-                responseInfo, result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::iccIOForAppResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("iccIOForAppResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -4212,43 +4306,14 @@ int radio::iccIOForAppResponse(int slotId,
 int radio::sendUssdResponse(int slotId,
                            int responseType, int serial, RIL_Errno e, void *response,
                            size_t responseLen) {
-#if VDBG
-    RLOGD("sendUssdResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->sendUssdResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("sendUssdResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(sendUssdResponse), slotId, responseType, serial, e);
 }
 
 int radio::cancelPendingUssdResponse(int slotId,
                                     int responseType, int serial, RIL_Errno e, void *response,
                                     size_t responseLen) {
-#if VDBG
-    RLOGD("cancelPendingUssdResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->cancelPendingUssdResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("cancelPendingUssdResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(cancelPendingUssdResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getClirResponse(int slotId,
@@ -4271,8 +4336,8 @@ int radio::getClirResponse(int slotId,
             n = pInt[0];
             m = pInt[1];
         }
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getClirResponse(responseInfo,
-                n, m);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getClirResponse, responseInfo, n, m);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getClirResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -4284,21 +4349,7 @@ int radio::getClirResponse(int slotId,
 int radio::setClirResponse(int slotId,
                           int responseType, int serial, RIL_Errno e, void *response,
                           size_t responseLen) {
-#if VDBG
-    RLOGD("setClirResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->setClirResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setClirResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setClirResponse), slotId, responseType, serial, e);
 }
 
 int radio::getCallForwardStatusResponse(int slotId,
@@ -4331,8 +4382,8 @@ int radio::getCallForwardStatusResponse(int slotId,
             }
         }
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getCallForwardStatusResponse(
-                responseInfo, callForwardInfos);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getCallForwardStatusResponse, responseInfo, callForwardInfos);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getCallForwardStatusResponse: radioService[%d]->mRadioResponse == NULL",
@@ -4345,21 +4396,8 @@ int radio::getCallForwardStatusResponse(int slotId,
 int radio::setCallForwardResponse(int slotId,
                                  int responseType, int serial, RIL_Errno e, void *response,
                                  size_t responseLen) {
-#if VDBG
-    RLOGD("setCallForwardResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->setCallForwardResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setCallForwardResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setCallForwardResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getCallWaitingResponse(int slotId,
@@ -4383,8 +4421,8 @@ int radio::getCallWaitingResponse(int slotId,
             enable = pInt[0] == 1 ? true : false;
             serviceClass = pInt[1];
         }
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getCallWaitingResponse(
-                responseInfo, enable, serviceClass);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getCallWaitingResponse, responseInfo, enable, serviceClass);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getCallWaitingResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -4396,106 +4434,35 @@ int radio::getCallWaitingResponse(int slotId,
 int radio::setCallWaitingResponse(int slotId,
                                  int responseType, int serial, RIL_Errno e, void *response,
                                  size_t responseLen) {
-#if VDBG
-    RLOGD("setCallWaitingResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->setCallWaitingResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setCallWaitingResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setCallWaitingResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::acknowledgeLastIncomingGsmSmsResponse(int slotId,
                                                 int responseType, int serial, RIL_Errno e,
                                                 void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("acknowledgeLastIncomingGsmSmsResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus =
-                radioService[slotId]->mRadioResponse->acknowledgeLastIncomingGsmSmsResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("acknowledgeLastIncomingGsmSmsResponse: radioService[%d]->mRadioResponse "
-                "== NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(acknowledgeLastIncomingGsmSmsResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::acceptCallResponse(int slotId,
                              int responseType, int serial, RIL_Errno e,
                              void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("acceptCallResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->acceptCallResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("acceptCallResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(acceptCallResponse), slotId, responseType, serial, e);
 }
 
 int radio::deactivateDataCallResponse(int slotId,
                                                 int responseType, int serial, RIL_Errno e,
                                                 void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("deactivateDataCallResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->deactivateDataCallResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("deactivateDataCallResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(deactivateDataCallResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getFacilityLockForAppResponse(int slotId,
                                         int responseType, int serial, RIL_Errno e,
                                         void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("getFacilityLockForAppResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        int ret = responseInt(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->
-                getFacilityLockForAppResponse(responseInfo, ret);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("getFacilityLockForAppResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendScalarResponse(RADIO_RESPONSE(getFacilityLockForAppResponse),
+            slotId, responseType, serial, e, response, responseLen);
 }
 
 int radio::setFacilityLockForAppResponse(int slotId,
@@ -4508,9 +4475,8 @@ int radio::setFacilityLockForAppResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseIntOrEmpty(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setFacilityLockForAppResponse(responseInfo,
-                ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::setFacilityLockForAppResponse, responseInfo, ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("setFacilityLockForAppResponse: radioService[%d]->mRadioResponse == NULL",
@@ -4530,8 +4496,8 @@ int radio::setBarringPasswordResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setBarringPasswordResponse(responseInfo);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::setBarringPasswordResponse, responseInfo);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("setBarringPasswordResponse: radioService[%d]->mRadioResponse == NULL",
@@ -4559,10 +4525,8 @@ int radio::getNetworkSelectionModeResponse(int slotId,
             int *pInt = (int *) response;
             manual = pInt[0] == 1 ? true : false;
         }
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getNetworkSelectionModeResponse(
-                responseInfo,
-                manual);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getNetworkSelectionModeResponse, responseInfo, manual);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getNetworkSelectionModeResponse: radioService[%d]->mRadioResponse == NULL",
@@ -4575,23 +4539,8 @@ int radio::getNetworkSelectionModeResponse(int slotId,
 int radio::setNetworkSelectionModeAutomaticResponse(int slotId, int responseType, int serial,
                                                     RIL_Errno e, void *response,
                                                     size_t responseLen) {
-#if VDBG
-    RLOGD("setNetworkSelectionModeAutomaticResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setNetworkSelectionModeAutomaticResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setNetworkSelectionModeAutomaticResponse: radioService[%d]->mRadioResponse "
-                "== NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setNetworkSelectionModeAutomaticResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::setNetworkSelectionModeManualResponse(int slotId,
@@ -4604,9 +4553,8 @@ int radio::setNetworkSelectionModeManualResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setNetworkSelectionModeManualResponse(
-                responseInfo);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::setNetworkSelectionModeManualResponse, responseInfo);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("acceptCallResponse: radioService[%d]->setNetworkSelectionModeManualResponse "
@@ -4667,9 +4615,8 @@ int radio::getAvailableNetworksResponse(int slotId,
                 }
             }
         }
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getAvailableNetworksResponse(responseInfo,
-                networks);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getAvailableNetworksResponse, responseInfo, networks);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getAvailableNetworksResponse: radioService[%d]->mRadioResponse == NULL",
@@ -4682,41 +4629,13 @@ int radio::getAvailableNetworksResponse(int slotId,
 int radio::startDtmfResponse(int slotId,
                             int responseType, int serial, RIL_Errno e,
                             void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("startDtmfResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->startDtmfResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("startDtmfResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(startDtmfResponse), slotId, responseType, serial, e);
 }
 
 int radio::stopDtmfResponse(int slotId,
                            int responseType, int serial, RIL_Errno e,
                            void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("stopDtmfResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->stopDtmfResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("stopDtmfResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(stopDtmfResponse), slotId, responseType, serial, e);
 }
 
 int radio::getBasebandVersionResponse(int slotId,
@@ -4729,8 +4648,8 @@ int radio::getBasebandVersionResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getBasebandVersionResponse(responseInfo,
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getBasebandVersionResponse, responseInfo,
                 convertCharPtrToHidlString((char *) response));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -4743,42 +4662,14 @@ int radio::getBasebandVersionResponse(int slotId,
 int radio::separateConnectionResponse(int slotId,
                                      int responseType, int serial, RIL_Errno e,
                                      void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("separateConnectionResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->separateConnectionResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("separateConnectionResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(separateConnectionResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::setMuteResponse(int slotId,
                           int responseType, int serial, RIL_Errno e,
                           void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setMuteResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setMuteResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setMuteResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setMuteResponse), slotId, responseType, serial, e);
 }
 
 int radio::getMuteResponse(int slotId,
@@ -4799,8 +4690,8 @@ int radio::getMuteResponse(int slotId,
             int *pInt = (int *) response;
             enable = pInt[0] == 1 ? true : false;
         }
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getMuteResponse(responseInfo,
-                enable);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getMuteResponse, responseInfo, enable);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getMuteResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -4819,8 +4710,8 @@ int radio::getClipResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseInt(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getClipResponse(responseInfo,
-                (ClipStatus) ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getClipResponse, responseInfo, (ClipStatus) ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getClipResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -4851,8 +4742,8 @@ int radio::getDataCallListResponse(int slotId,
             convertRilDataCallListToHal(response, responseLen, ret);
         }
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getDataCallListResponse(
-                responseInfo, ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getDataCallListResponse, responseInfo, ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getDataCallListResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -4864,83 +4755,28 @@ int radio::getDataCallListResponse(int slotId,
 int radio::setSuppServiceNotificationsResponse(int slotId,
                                               int responseType, int serial, RIL_Errno e,
                                               void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setSuppServiceNotificationsResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setSuppServiceNotificationsResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setSuppServiceNotificationsResponse: radioService[%d]->mRadioResponse "
-                "== NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setSuppServiceNotificationsResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::deleteSmsOnSimResponse(int slotId,
                                  int responseType, int serial, RIL_Errno e,
                                  void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("deleteSmsOnSimResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->deleteSmsOnSimResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("deleteSmsOnSimResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(deleteSmsOnSimResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::setBandModeResponse(int slotId,
                               int responseType, int serial, RIL_Errno e,
                               void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setBandModeResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setBandModeResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setBandModeResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setBandModeResponse), slotId, responseType, serial, e);
 }
 
 int radio::writeSmsToSimResponse(int slotId,
                                 int responseType, int serial, RIL_Errno e,
                                 void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("writeSmsToSimResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        int ret = responseInt(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->writeSmsToSimResponse(responseInfo, ret);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("writeSmsToSimResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendScalarResponse(RADIO_RESPONSE(writeSmsToSimResponse),
+            slotId, responseType, serial, e, response, responseLen);
 }
 
 int radio::getAvailableBandModesResponse(int slotId,
@@ -4965,9 +4801,8 @@ int radio::getAvailableBandModesResponse(int slotId,
                 modes[i] = (RadioBandMode) pInt[i];
             }
         }
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getAvailableBandModesResponse(responseInfo,
-                modes);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getAvailableBandModesResponse, responseInfo, modes);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getAvailableBandModesResponse: radioService[%d]->mRadioResponse == NULL",
@@ -4987,8 +4822,8 @@ int radio::sendEnvelopeResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->sendEnvelopeResponse(responseInfo,
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::sendEnvelopeResponse, responseInfo,
                 convertCharPtrToHidlString((char *) response));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -5001,89 +4836,30 @@ int radio::sendEnvelopeResponse(int slotId,
 int radio::sendTerminalResponseToSimResponse(int slotId,
                                             int responseType, int serial, RIL_Errno e,
                                             void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("sendTerminalResponseToSimResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->sendTerminalResponseToSimResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("sendTerminalResponseToSimResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(sendTerminalResponseToSimResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::handleStkCallSetupRequestFromSimResponse(int slotId,
                                                    int responseType, int serial,
                                                    RIL_Errno e, void *response,
                                                    size_t responseLen) {
-#if VDBG
-    RLOGD("handleStkCallSetupRequestFromSimResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->handleStkCallSetupRequestFromSimResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("handleStkCallSetupRequestFromSimResponse: radioService[%d]->mRadioResponse "
-                "== NULL", slotId);
-    }
-
-    return 0;
-}
+    return sendResponseInfo(RADIO_RESPONSE(handleStkCallSetupRequestFromSimResponse),
+            slotId, responseType, serial, e);
+}
 
 int radio::explicitCallTransferResponse(int slotId,
                                        int responseType, int serial, RIL_Errno e,
                                        void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("explicitCallTransferResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->explicitCallTransferResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("explicitCallTransferResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(explicitCallTransferResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::setPreferredNetworkTypeResponse(int slotId,
                                  int responseType, int serial, RIL_Errno e,
                                  void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setPreferredNetworkTypeResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setPreferredNetworkTypeResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setPreferredNetworkTypeResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setPreferredNetworkTypeResponse),
+            slotId, responseType, serial, e);
 }
 
 
@@ -5097,9 +4873,9 @@ int radio::getPreferredNetworkTypeResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseInt(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getPreferredNetworkTypeResponse(
-                responseInfo, (PreferredNetworkType) ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getPreferredNetworkTypeResponse, responseInfo,
+                (PreferredNetworkType) ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getPreferredNetworkTypeResponse: radioService[%d]->mRadioResponse == NULL",
@@ -5135,9 +4911,8 @@ int radio::getNeighboringCidsResponse(int slotId,
             }
         }
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getNeighboringCidsResponse(responseInfo,
-                cells);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getNeighboringCidsResponse, responseInfo, cells);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getNeighboringCidsResponse: radioService[%d]->mRadioResponse == NULL",
@@ -5150,66 +4925,22 @@ int radio::getNeighboringCidsResponse(int slotId,
 int radio::setLocationUpdatesResponse(int slotId,
                                      int responseType, int serial, RIL_Errno e,
                                      void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setLocationUpdatesResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setLocationUpdatesResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setLocationUpdatesResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setLocationUpdatesResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::setCdmaSubscriptionSourceResponse(int slotId,
                                  int responseType, int serial, RIL_Errno e,
                                  void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setCdmaSubscriptionSourceResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setCdmaSubscriptionSourceResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setCdmaSubscriptionSourceResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setCdmaSubscriptionSourceResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::setCdmaRoamingPreferenceResponse(int slotId,
                                  int responseType, int serial, RIL_Errno e,
                                  void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setCdmaRoamingPreferenceResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setCdmaRoamingPreferenceResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setCdmaRoamingPreferenceResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setCdmaRoamingPreferenceResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getCdmaRoamingPreferenceResponse(int slotId,
@@ -5222,9 +4953,9 @@ int radio::getCdmaRoamingPreferenceResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseInt(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getCdmaRoamingPreferenceResponse(
-                responseInfo, (CdmaRoamingType) ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getCdmaRoamingPreferenceResponse, responseInfo,
+                (CdmaRoamingType) ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getCdmaRoamingPreferenceResponse: radioService[%d]->mRadioResponse == NULL",
@@ -5237,21 +4968,7 @@ int radio::getCdmaRoamingPreferenceResponse(int slotId,
 int radio::setTTYModeResponse(int slotId,
                              int responseType, int serial, RIL_Errno e,
                              void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setTTYModeResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setTTYModeResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setTTYModeResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setTTYModeResponse), slotId, responseType, serial, e);
 }
 
 int radio::getTTYModeResponse(int slotId,
@@ -5264,9 +4981,8 @@ int radio::getTTYModeResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseInt(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getTTYModeResponse(responseInfo,
-                (TtyMode) ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getTTYModeResponse, responseInfo, (TtyMode) ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getTTYModeResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -5278,23 +4994,8 @@ int radio::getTTYModeResponse(int slotId,
 int radio::setPreferredVoicePrivacyResponse(int slotId,
                                  int responseType, int serial, RIL_Errno e,
                                  void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setPreferredVoicePrivacyResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setPreferredVoicePrivacyResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setPreferredVoicePrivacyResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setPreferredVoicePrivacyResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getPreferredVoicePrivacyResponse(int slotId,
@@ -5316,9 +5017,8 @@ int radio::getPreferredVoicePrivacyResponse(int slotId,
             int *pInt = (int *) response;
             enable = pInt[0] == 1 ? true : false;
         }
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getPreferredVoicePrivacyResponse(
-                responseInfo, enable);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getPreferredVoicePrivacyResponse, responseInfo, enable);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getPreferredVoicePrivacyResponse: radioService[%d]->mRadioResponse == NULL",
@@ -5331,42 +5031,14 @@ int radio::getPreferredVoicePrivacyResponse(int slotId,
 int radio::sendCDMAFeatureCodeResponse(int slotId,
                                  int responseType, int serial, RIL_Errno e,
                                  void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("sendCDMAFeatureCodeResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->sendCDMAFeatureCodeResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("sendCDMAFeatureCodeResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(sendCDMAFeatureCodeResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::sendBurstDtmfResponse(int slotId,
                                  int responseType, int serial, RIL_Errno e,
                                  void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("sendBurstDtmfResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->sendBurstDtmfResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("sendBurstDtmfResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(sendBurstDtmfResponse), slotId, responseType, serial, e);
 }
 
 int radio::sendCdmaSmsResponse(int slotId,
@@ -5381,8 +5053,8 @@ int radio::sendCdmaSmsResponse(int slotId,
         SendSmsResult result = makeSendSmsResult(responseInfo, serial, responseType, e, response,
                 responseLen);
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->sendCdmaSmsResponse(responseInfo, result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::sendCdmaSmsResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("sendCdmaSmsResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -5394,23 +5066,8 @@ int radio::sendCdmaSmsResponse(int slotId,
 int radio::acknowledgeLastIncomingCdmaSmsResponse(int slotId,
                                                  int responseType, int serial, RIL_Errno e,
                                                  void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("acknowledgeLastIncomingCdmaSmsResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->acknowledgeLastIncomingCdmaSmsResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("acknowledgeLastIncomingCdmaSmsResponse: radioService[%d]->mRadioResponse "
-                "== NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(acknowledgeLastIncomingCdmaSmsResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getGsmBroadcastConfigResponse(int slotId,
@@ -5443,9 +5100,8 @@ int radio::getGsmBroadcastConfigResponse(int slotId,
             }
         }
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getGsmBroadcastConfigResponse(responseInfo,
-                configs);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getGsmBroadcastConfigResponse, responseInfo, configs);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getGsmBroadcastConfigResponse: radioService[%d]->mRadioResponse == NULL",
@@ -5458,44 +5114,15 @@ int radio::getGsmBroadcastConfigResponse(int slotId,
 int radio::setGsmBroadcastConfigResponse(int slotId,
                                         int responseType, int serial, RIL_Errno e,
                                         void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setGsmBroadcastConfigResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setGsmBroadcastConfigResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setGsmBroadcastConfigResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setGsmBroadcastConfigResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::setGsmBroadcastActivationResponse(int slotId,
                                             int responseType, int serial, RIL_Errno e,
                                             void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setGsmBroadcastActivationResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setGsmBroadcastActivationResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setGsmBroadcastActivationResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setGsmBroadcastActivationResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getCdmaBroadcastConfigResponse(int slotId,
@@ -5526,9 +5153,8 @@ int radio::getCdmaBroadcastConfigResponse(int slotId,
             }
         }
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getCdmaBroadcastConfigResponse(responseInfo,
-                configs);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getCdmaBroadcastConfigResponse, responseInfo, configs);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getCdmaBroadcastConfigResponse: radioService[%d]->mRadioResponse == NULL",
@@ -5541,45 +5167,15 @@ int radio::getCdmaBroadcastConfigResponse(int slotId,
 int radio::setCdmaBroadcastConfigResponse(int slotId,
                                          int responseType, int serial, RIL_Errno e,
                                          void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setCdmaBroadcastConfigResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setCdmaBroadcastConfigResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setCdmaBroadcastConfigResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setCdmaBroadcastConfigResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::setCdmaBroadcastActivationResponse(int slotId,
                                              int responseType, int serial, RIL_Errno e,
                                              void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setCdmaBroadcastActivationResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setCdmaBroadcastActivationResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setCdmaBroadcastActivationResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setCdmaBroadcastActivationResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getCDMASubscriptionResponse(int slotId,
@@ -5598,19 +5194,16 @@ int radio::getCDMASubscriptionResponse(int slotId,
         if (response == NULL || numStrings != 5) {
             RLOGE("getOperatorResponse Invalid response: NULL");
             if (e == RIL_E_SUCCESS) responseInfo.error = RadioError::INVALID_RESPONSE;
-            Return<void> retStatus
-                    = radioService[slotId]->mRadioResponse->getCDMASubscriptionResponse(
-                    responseInfo, emptyString, emptyString, emptyString, emptyString, emptyString);
+            Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                    &IRadioResponse::getCDMASubscriptionResponse, responseInfo, emptyString,
+                    emptyString, emptyString, emptyString, emptyString);
             radioService[slotId]->checkReturnStatus(retStatus);
         } else {
             char **resp = (char **) response;
-            Return<void> retStatus
-                    = radioService[slotId]->mRadioResponse->getCDMASubscriptionResponse(
-                    responseInfo,
-                    convertCharPtrToHidlString(resp[0]),
-                    convertCharPtrToHidlString(resp[1]),
-                    convertCharPtrToHidlString(resp[2]),
-                    convertCharPtrToHidlString(resp[3]),
+            Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                    &IRadioResponse::getCDMASubscriptionResponse, responseInfo,
+                    convertCharPtrToHidlString(resp[0]), convertCharPtrToHidlString(resp[1]),
+                    convertCharPtrToHidlString(resp[2]), convertCharPtrToHidlString(resp[3]),
                     convertCharPtrToHidlString(resp[4]));
             radioService[slotId]->checkReturnStatus(retStatus);
         }
@@ -5625,41 +5218,15 @@ int radio::getCDMASubscriptionResponse(int slotId,
 int radio::writeSmsToRuimResponse(int slotId,
                                  int responseType, int serial, RIL_Errno e,
                                  void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("writeSmsToRuimResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        int ret = responseInt(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->writeSmsToRuimResponse(responseInfo, ret);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("writeSmsToRuimResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendScalarResponse(RADIO_RESPONSE(writeSmsToRuimResponse),
+            slotId, responseType, serial, e, response, responseLen);
 }
 
 int radio::deleteSmsOnRuimResponse(int slotId,
                                   int responseType, int serial, RIL_Errno e,
                                   void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("deleteSmsOnRuimResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->deleteSmsOnRuimResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("deleteSmsOnRuimResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(deleteSmsOnRuimResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getDeviceIdentityResponse(int slotId,
@@ -5678,18 +5245,16 @@ int radio::getDeviceIdentityResponse(int slotId,
         if (response == NULL || numStrings != 4) {
             RLOGE("getDeviceIdentityResponse Invalid response: NULL");
             if (e == RIL_E_SUCCESS) responseInfo.error = RadioError::INVALID_RESPONSE;
-            Return<void> retStatus
-                    = radioService[slotId]->mRadioResponse->getDeviceIdentityResponse(responseInfo,
-                    emptyString, emptyString, emptyString, emptyString);
+            Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                    &IRadioResponse::getDeviceIdentityResponse, responseInfo, emptyString,
+                    emptyString, emptyString, emptyString);
             radioService[slotId]->checkReturnStatus(retStatus);
         } else {
             char **resp = (char **) response;
-            Return<void> retStatus
-                    = radioService[slotId]->mRadioResponse->getDeviceIdentityResponse(responseInfo,
-                    convertCharPtrToHidlString(resp[0]),
-                    convertCharPtrToHidlString(resp[1]),
-                    convertCharPtrToHidlString(resp[2]),
-                    convertCharPtrToHidlString(resp[3]));
+            Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                    &IRadioResponse::getDeviceIdentityResponse, responseInfo,
+                    convertCharPtrToHidlString(resp[0]), convertCharPtrToHidlString(resp[1]),
+                    convertCharPtrToHidlString(resp[2]), convertCharPtrToHidlString(resp[3]));
             radioService[slotId]->checkReturnStatus(retStatus);
         }
     } else {
@@ -5703,23 +5268,8 @@ int radio::getDeviceIdentityResponse(int slotId,
 int radio::exitEmergencyCallbackModeResponse(int slotId,
                                             int responseType, int serial, RIL_Errno e,
                                             void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("exitEmergencyCallbackModeResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->exitEmergencyCallbackModeResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("exitEmergencyCallbackModeResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(exitEmergencyCallbackModeResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getSmscAddressResponse(int slotId,
@@ -5732,8 +5282,8 @@ int radio::getSmscAddressResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getSmscAddressResponse(responseInfo,
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getSmscAddressResponse, responseInfo,
                 convertCharPtrToHidlString((char *) response));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -5746,63 +5296,22 @@ int radio::getSmscAddressResponse(int slotId,
 int radio::setSmscAddressResponse(int slotId,
                                              int responseType, int serial, RIL_Errno e,
                                              void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setSmscAddressResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setSmscAddressResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setSmscAddressResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setSmscAddressResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::reportSmsMemoryStatusResponse(int slotId,
                                         int responseType, int serial, RIL_Errno e,
                                         void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("reportSmsMemoryStatusResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->reportSmsMemoryStatusResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("reportSmsMemoryStatusResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(reportSmsMemoryStatusResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::reportStkServiceIsRunningResponse(int slotId,
-                                             int responseType, int serial, RIL_Errno e,
-                                             void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("reportStkServiceIsRunningResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->
-                reportStkServiceIsRunningResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("reportStkServiceIsRunningResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+                                             int responseType, int serial, RIL_Errno e,
+                                             void *response, size_t responseLen) {
+    return sendResponseInfo(RADIO_RESPONSE(reportStkServiceIsRunningResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getCdmaSubscriptionSourceResponse(int slotId,
@@ -5815,9 +5324,9 @@ int radio::getCdmaSubscriptionSourceResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseInt(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getCdmaSubscriptionSourceResponse(
-                responseInfo, (CdmaSubscriptionSource) ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getCdmaSubscriptionSourceResponse, responseInfo,
+                (CdmaSubscriptionSource) ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getCdmaSubscriptionSourceResponse: radioService[%d]->mRadioResponse == NULL",
@@ -5837,9 +5346,8 @@ int radio::requestIsimAuthenticationResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->requestIsimAuthenticationResponse(
-                responseInfo,
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::requestIsimAuthenticationResponse, responseInfo,
                 convertCharPtrToHidlString((char *) response));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -5854,23 +5362,8 @@ int radio::acknowledgeIncomingGsmSmsWithPduResponse(int slotId,
                                                    int responseType,
                                                    int serial, RIL_Errno e, void *response,
                                                    size_t responseLen) {
-#if VDBG
-    RLOGD("acknowledgeIncomingGsmSmsWithPduResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->acknowledgeIncomingGsmSmsWithPduResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("acknowledgeIncomingGsmSmsWithPduResponse: radioService[%d]->mRadioResponse "
-                "== NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(acknowledgeIncomingGsmSmsWithPduResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::sendEnvelopeWithStatusResponse(int slotId,
@@ -5885,9 +5378,8 @@ int radio::sendEnvelopeWithStatusResponse(int slotId,
         IccIoResult result = responseIccIo(responseInfo, serial, responseType, e,
                 response, responseLen);
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->sendEnvelopeWithStatusResponse(responseInfo,
-                result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::sendEnvelopeWithStatusResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("sendEnvelopeWithStatusResponse: radioService[%d]->mRadioResponse == NULL",
@@ -5907,9 +5399,9 @@ int radio::getVoiceRadioTechnologyResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         int ret = responseInt(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getVoiceRadioTechnologyResponse(
-                responseInfo, (RadioTechnology) ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getVoiceRadioTechnologyResponse, responseInfo,
+                (RadioTechnology) ret);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getVoiceRadioTechnologyResponse: radioService[%d]->mRadioResponse == NULL",
@@ -5932,16 +5424,18 @@ int radio::getCellInfoListResponse(int slotId,
         populateResponseInfo(responseInfo, serial, responseType, e);
 
         hidl_vec<CellInfo> ret;
+        CellInfoCache *cache = NULL;
         if ((response == NULL && responseLen != 0)
                 || responseLen % sizeof(RIL_CellInfo_v12) != 0) {
             RLOGE("getCellInfoListResponse: Invalid response");
             if (e == RIL_E_SUCCESS) responseInfo.error = RadioError::INVALID_RESPONSE;
         } else {
-            convertRilCellInfoListToHal(response, responseLen, ret);
+            cache = convertRilCellInfoListToHalCached(slotId, response, responseLen, ret);
         }
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getCellInfoListResponse(
-                responseInfo, ret);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getCellInfoListResponse, responseInfo, ret);
+        releaseCellInfoCache(cache);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getCellInfoListResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -5954,43 +5448,15 @@ int radio::setCellInfoListRateResponse(int slotId,
                                        int responseType,
                                        int serial, RIL_Errno e, void *response,
                                        size_t responseLen) {
-#if VDBG
-    RLOGD("setCellInfoListRateResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setCellInfoListRateResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setCellInfoListRateResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setCellInfoListRateResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::setInitialAttachApnResponse(int slotId,
                                        int responseType, int serial, RIL_Errno e,
                                        void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setInitialAttachApnResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setInitialAttachApnResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setInitialAttachApnResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setInitialAttachApnResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getImsRegistrationStateResponse(int slotId,
@@ -6014,9 +5480,9 @@ int radio::getImsRegistrationStateResponse(int slotId,
             isRegistered = pInt[0] == 1 ? true : false;
             ratFamily = pInt[1];
         }
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getImsRegistrationStateResponse(
-                responseInfo, isRegistered, (RadioTechnologyFamily) ratFamily);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getImsRegistrationStateResponse, responseInfo, isRegistered,
+                (RadioTechnologyFamily) ratFamily);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getImsRegistrationStateResponse: radioService[%d]->mRadioResponse == NULL",
@@ -6038,8 +5504,8 @@ int radio::sendImsSmsResponse(int slotId,
         SendSmsResult result = makeSendSmsResult(responseInfo, serial, responseType, e, response,
                 responseLen);
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->sendImsSmsResponse(responseInfo, result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::sendImsSmsResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("sendSmsResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -6060,9 +5526,8 @@ int radio::iccTransmitApduBasicChannelResponse(int slotId,
         IccIoResult result = responseIccIo(responseInfo, serial, responseType, e, response,
                 responseLen);
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->iccTransmitApduBasicChannelResponse(
-                responseInfo, result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::iccTransmitApduBasicChannelResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("iccTransmitApduBasicChannelResponse: radioService[%d]->mRadioResponse "
@@ -6098,9 +5563,9 @@ int radio::iccOpenLogicalChannelResponse(int slotId,
                 selectResponse[i - 1] = (int8_t) pInt[i];
             }
         }
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->iccOpenLogicalChannelResponse(responseInfo,
-                channelId, selectResponse);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::iccOpenLogicalChannelResponse, responseInfo, channelId,
+                selectResponse);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("iccOpenLogicalChannelResponse: radioService[%d]->mRadioResponse == NULL",
@@ -6113,23 +5578,8 @@ int radio::iccOpenLogicalChannelResponse(int slotId,
 int radio::iccCloseLogicalChannelResponse(int slotId,
                                           int responseType, int serial, RIL_Errno e,
                                           void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("iccCloseLogicalChannelResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->iccCloseLogicalChannelResponse(
-                responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("iccCloseLogicalChannelResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(iccCloseLogicalChannelResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::iccTransmitApduLogicalChannelResponse(int slotId,
@@ -6144,9 +5594,8 @@ int radio::iccTransmitApduLogicalChannelResponse(int slotId,
         IccIoResult result = responseIccIo(responseInfo, serial, responseType, e, response,
                 responseLen);
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->iccTransmitApduLogicalChannelResponse(
-                responseInfo, result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::iccTransmitApduLogicalChannelResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("iccTransmitApduLogicalChannelResponse: radioService[%d]->mRadioResponse "
@@ -6166,8 +5615,8 @@ int radio::nvReadItemResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->nvReadItemResponse(
-                responseInfo,
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::nvReadItemResponse, responseInfo,
                 convertCharPtrToHidlString((char *) response));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -6180,102 +5629,34 @@ int radio::nvReadItemResponse(int slotId,
 int radio::nvWriteItemResponse(int slotId,
                                int responseType, int serial, RIL_Errno e,
                                void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("nvWriteItemResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->nvWriteItemResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("nvWriteItemResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(nvWriteItemResponse), slotId, responseType, serial, e);
 }
 
 int radio::nvWriteCdmaPrlResponse(int slotId,
                                   int responseType, int serial, RIL_Errno e,
                                   void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("nvWriteCdmaPrlResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->nvWriteCdmaPrlResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("nvWriteCdmaPrlResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(nvWriteCdmaPrlResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::nvResetConfigResponse(int slotId,
                                  int responseType, int serial, RIL_Errno e,
                                  void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("nvResetConfigResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->nvResetConfigResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("nvResetConfigResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(nvResetConfigResponse), slotId, responseType, serial, e);
 }
 
 int radio::setUiccSubscriptionResponse(int slotId,
                                        int responseType, int serial, RIL_Errno e,
                                        void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setUiccSubscriptionResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setUiccSubscriptionResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setUiccSubscriptionResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setUiccSubscriptionResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::setDataAllowedResponse(int slotId,
                                   int responseType, int serial, RIL_Errno e,
                                   void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setDataAllowedResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setDataAllowedResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setDataAllowedResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setDataAllowedResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::getHardwareConfigResponse(int slotId,
@@ -6298,8 +5679,8 @@ int radio::getHardwareConfigResponse(int slotId,
             convertRilHardwareConfigListToHal(response, responseLen, result);
         }
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getHardwareConfigResponse(
-                responseInfo, result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getHardwareConfigResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getHardwareConfigResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -6320,9 +5701,8 @@ int radio::requestIccSimAuthenticationResponse(int slotId,
         IccIoResult result = responseIccIo(responseInfo, serial, responseType, e, response,
                 responseLen);
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->requestIccSimAuthenticationResponse(
-                responseInfo, result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::requestIccSimAuthenticationResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("requestIccSimAuthenticationResponse: radioService[%d]->mRadioResponse "
@@ -6335,41 +5715,15 @@ int radio::requestIccSimAuthenticationResponse(int slotId,
 int radio::setDataProfileResponse(int slotId,
                                   int responseType, int serial, RIL_Errno e,
                                   void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setDataProfileResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setDataProfileResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setDataProfileResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(setDataProfileResponse),
+            slotId, responseType, serial, e);
 }
 
 int radio::requestShutdownResponse(int slotId,
                                   int responseType, int serial, RIL_Errno e,
                                   void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("requestShutdownResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->requestShutdownResponse(responseInfo);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("requestShutdownResponse: radioService[%d]->mRadioResponse == NULL", slotId);
-    }
-
-    return 0;
+    return sendResponseInfo(RADIO_RESPONSE(requestShutdownResponse),
+            slotId, responseType, serial, e);
 }
 
 void responseRadioCapability(RadioResponseInfo& responseInfo, int serial,
@@ -6397,8 +5751,8 @@ int radio::getRadioCapabilityResponse(int slotId,
         RadioCapability result = {};
         responseRadioCapability(responseInfo, serial, responseType, e, response, responseLen,
                 result);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->getRadioCapabilityResponse(
-                responseInfo, result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getRadioCapabilityResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getRadioCapabilityResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -6419,8 +5773,8 @@ int radio::setRadioCapabilityResponse(int slotId,
         RadioCapability result = {};
         responseRadioCapability(responseInfo, serial, responseType, e, response, responseLen,
                 result);
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->setRadioCapabilityResponse(
-                responseInfo, result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::setRadioCapabilityResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("setRadioCapabilityResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -6457,9 +5811,8 @@ int radio::startLceServiceResponse(int slotId,
         LceStatusInfo result = responseLceStatusInfo(responseInfo, serial, responseType, e,
                 response, responseLen);
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->startLceServiceResponse(responseInfo,
-                result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::startLceServiceResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("startLceServiceResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -6480,9 +5833,8 @@ int radio::stopLceServiceResponse(int slotId,
         LceStatusInfo result = responseLceStatusInfo(responseInfo, serial, responseType, e,
                 response, responseLen);
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->stopLceServiceResponse(responseInfo,
-                result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::stopLceServiceResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("stopLceServiceResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -6510,8 +5862,8 @@ int radio::pullLceDataResponse(int slotId,
             convertRilLceDataInfoToHal(response, responseLen, result);
         }
 
-        Return<void> retStatus = radioService[slotId]->mRadioResponse->pullLceDataResponse(
-                responseInfo, result);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::pullLceDataResponse, responseInfo, result);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("pullLceDataResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -6544,9 +5896,8 @@ int radio::getModemActivityInfoResponse(int slotId,
             info.rxModeTimeMs = resp->rx_mode_time_ms;
         }
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getModemActivityInfoResponse(responseInfo,
-                info);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getModemActivityInfoResponse, responseInfo, info);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getModemActivityInfoResponse: radioService[%d]->mRadioResponse == NULL",
@@ -6559,23 +5910,8 @@ int radio::getModemActivityInfoResponse(int slotId,
 int radio::setAllowedCarriersResponse(int slotId,
                                       int responseType, int serial, RIL_Errno e,
                                       void *response, size_t responseLen) {
-#if VDBG
-    RLOGD("setAllowedCarriersResponse: serial %d", serial);
-#endif
-
-    if (radioService[slotId]->mRadioResponse != NULL) {
-        RadioResponseInfo responseInfo = {};
-        int ret = responseInt(responseInfo, serial, responseType, e, response, responseLen);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setAllowedCarriersResponse(responseInfo,
-                ret);
-        radioService[slotId]->checkReturnStatus(retStatus);
-    } else {
-        RLOGE("setAllowedCarriersResponse: radioService[%d]->mRadioResponse == NULL",
-                slotId);
-    }
-
-    return 0;
+    return sendScalarResponse(RADIO_RESPONSE(setAllowedCarriersResponse),
+            slotId, responseType, serial, e, response, responseLen);
 }
 
 int radio::getAllowedCarriersResponse(int slotId,
@@ -6626,9 +5962,8 @@ int radio::getAllowedCarriersResponse(int slotId,
             }
         }
 
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->getAllowedCarriersResponse(responseInfo,
-                allAllowed, carrierInfo);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::getAllowedCarriersResponse, responseInfo, allAllowed, carrierInfo);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("getAllowedCarriersResponse: radioService[%d]->mRadioResponse == NULL",
@@ -6648,8 +5983,8 @@ int radio::sendDeviceStateResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->sendDeviceStateResponse(responseInfo);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::sendDeviceStateResponse, responseInfo);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("sendDeviceStateResponse: radioService[%d]->mRadioResponse == NULL", slotId);
@@ -6665,8 +6000,8 @@ int radio::setCarrierInfoForImsiEncryptionResponse(int slotId,
     if (radioService[slotId]->mRadioResponseV1_1 != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus = radioService[slotId]->mRadioResponseV1_1->
-                setCarrierInfoForImsiEncryptionResponse(responseInfo);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponseV1_1,
+                &V1_1::IRadioResponse::setCarrierInfoForImsiEncryptionResponse, responseInfo);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("setCarrierInfoForImsiEncryptionResponse: radioService[%d]->mRadioResponseV1_1 == "
@@ -6685,8 +6020,8 @@ int radio::setIndicationFilterResponse(int slotId,
     if (radioService[slotId]->mRadioResponse != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponse->setIndicationFilterResponse(responseInfo);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                &IRadioResponse::setIndicationFilterResponse, responseInfo);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("setIndicationFilterResponse: radioService[%d]->mRadioResponse == NULL",
@@ -6708,14 +6043,14 @@ int radio::setSimCardPowerResponse(int slotId,
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
         if (radioService[slotId]->mRadioResponseV1_1 != NULL) {
-            Return<void> retStatus = radioService[slotId]->mRadioResponseV1_1->
-                    setSimCardPowerResponse_1_1(responseInfo);
+            Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponseV1_1,
+                    &V1_1::IRadioResponse::setSimCardPowerResponse_1_1, responseInfo);
             radioService[slotId]->checkReturnStatus(retStatus);
         } else {
             RLOGD("setSimCardPowerResponse: radioService[%d]->mRadioResponseV1_1 == NULL",
                     slotId);
-            Return<void> retStatus
-                    = radioService[slotId]->mRadioResponse->setSimCardPowerResponse(responseInfo);
+            Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponse,
+                    &IRadioResponse::setSimCardPowerResponse, responseInfo);
             radioService[slotId]->checkReturnStatus(retStatus);
         }
     } else {
@@ -6734,8 +6069,8 @@ int radio::startNetworkScanResponse(int slotId, int responseType, int serial, RI
     if (radioService[slotId]->mRadioResponseV1_1 != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponseV1_1->startNetworkScanResponse(responseInfo);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponseV1_1,
+                &V1_1::IRadioResponse::startNetworkScanResponse, responseInfo);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("startNetworkScanResponse: radioService[%d]->mRadioResponseV1_1 == NULL", slotId);
@@ -6753,8 +6088,8 @@ int radio::stopNetworkScanResponse(int slotId, int responseType, int serial, RIL
     if (radioService[slotId]->mRadioResponseV1_1 != NULL) {
         RadioResponseInfo responseInfo = {};
         populateResponseInfo(responseInfo, serial, responseType, e);
-        Return<void> retStatus
-                = radioService[slotId]->mRadioResponseV1_1->stopNetworkScanResponse(responseInfo);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponseV1_1,
+                &V1_1::IRadioResponse::stopNetworkScanResponse, responseInfo);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("stopNetworkScanResponse: radioService[%d]->mRadioResponseV1_1 == NULL", slotId);
@@ -6791,8 +6126,8 @@ int radio::startKeepaliveResponse(int slotId, int responseType, int serial, RIL_
         convertRilKeepaliveStatusToHal(static_cast<RIL_KeepaliveStatus*>(response), ks);
     }
 
-    Return<void> retStatus =
-            radioService[slotId]->mRadioResponseV1_1->startKeepaliveResponse(responseInfo, ks);
+    Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponseV1_1,
+            &V1_1::IRadioResponse::startKeepaliveResponse, responseInfo, ks);
     radioService[slotId]->checkReturnStatus(retStatus);
     return 0;
 }
@@ -6811,8 +6146,8 @@ int radio::stopKeepaliveResponse(int slotId, int responseType, int serial, RIL_E
         return 0;
     }
 
-    Return<void> retStatus =
-            radioService[slotId]->mRadioResponseV1_1->stopKeepaliveResponse(responseInfo);
+    Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioResponseV1_1,
+            &V1_1::IRadioResponse::stopKeepaliveResponse, responseInfo);
     radioService[slotId]->checkReturnStatus(retStatus);
     return 0;
 }
@@ -6903,7 +6238,8 @@ int radio::radioStateChangedInd(int slotId,
         RadioState radioState =
                 (RadioState) CALL_ONSTATEREQUEST(slotId);
         RLOGD("radioStateChangedInd: radioState %d", radioState);
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->radioStateChanged(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::radioStateChanged,
                 convertIntToRadioIndicationType(indicationType), radioState);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -6920,7 +6256,8 @@ int radio::callStateChangedInd(int slotId,
 #if VDBG
         RLOGD("callStateChangedInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->callStateChanged(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::callStateChanged,
                 convertIntToRadioIndicationType(indicationType));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -6937,7 +6274,8 @@ int radio::networkStateChangedInd(int slotId,
 #if VDBG
         RLOGD("networkStateChangedInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->networkStateChanged(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::networkStateChanged,
                 convertIntToRadioIndicationType(indicationType));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7003,8 +6341,8 @@ int radio::newSmsInd(int slotId, int indicationType,
 #if VDBG
         RLOGD("newSmsInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->newSms(
-                convertIntToRadioIndicationType(indicationType), pdu);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::newSms, convertIntToRadioIndicationType(indicationType), pdu);
         radioService[slotId]->checkReturnStatus(retStatus);
         free(bytes);
     } else {
@@ -7034,7 +6372,8 @@ int radio::newSmsStatusReportInd(int slotId,
 #if VDBG
         RLOGD("newSmsStatusReportInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->newSmsStatusReport(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::newSmsStatusReport,
                 convertIntToRadioIndicationType(indicationType), pdu);
         radioService[slotId]->checkReturnStatus(retStatus);
         free(bytes);
@@ -7056,8 +6395,9 @@ int radio::newSmsOnSimInd(int slotId, int indicationType,
 #if VDBG
         RLOGD("newSmsOnSimInd: slotIndex %d", recordNumber);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->newSmsOnSim(
-                convertIntToRadioIndicationType(indicationType), recordNumber);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::newSmsOnSim, convertIntToRadioIndicationType(indicationType),
+                recordNumber);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("newSmsOnSimInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -7080,8 +6420,9 @@ int radio::onUssdInd(int slotId, int indicationType,
 #if VDBG
         RLOGD("onUssdInd: mode %s", mode);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->onUssd(
-                convertIntToRadioIndicationType(indicationType), modeType, msg);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::onUssd, convertIntToRadioIndicationType(indicationType),
+                modeType, msg);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("onUssdInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -7099,13 +6440,14 @@ int radio::nitzTimeReceivedInd(int slotId,
             return 0;
         }
         hidl_string nitzTime = convertCharPtrToHidlString((char *) response);
+        int64_t timeReceived = __atomic_load_n(&nitzTimeReceived[slotId], __ATOMIC_ACQUIRE);
 #if VDBG
         RLOGD("nitzTimeReceivedInd: nitzTime %s receivedTime %" PRId64, nitzTime.c_str(),
-                nitzTimeReceived[slotId]);
+                timeReceived);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->nitzTimeReceived(
-                convertIntToRadioIndicationType(indicationType), nitzTime,
-                nitzTimeReceived[slotId]);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::nitzTimeReceived,
+                convertIntToRadioIndicationType(indicationType), nitzTime, timeReceived);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("nitzTimeReceivedInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -7230,7 +6572,8 @@ int radio::currentSignalStrengthInd(int slotId,
 #if VDBG
         RLOGD("currentSignalStrengthInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->currentSignalStrength(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::currentSignalStrength,
                 convertIntToRadioIndicationType(indicationType), signalStrength);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7330,7 +6673,8 @@ int radio::dataCallListChangedInd(int slotId,
 #if VDBG
         RLOGD("dataCallListChangedInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->dataCallListChanged(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::dataCallListChanged,
                 convertIntToRadioIndicationType(indicationType), dcList);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7360,8 +6704,9 @@ int radio::suppSvcNotifyInd(int slotId, int indicationType,
         RLOGD("suppSvcNotifyInd: isMT %d code %d index %d type %d",
                 suppSvc.isMT, suppSvc.code, suppSvc.index, suppSvc.type);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->suppSvcNotify(
-                convertIntToRadioIndicationType(indicationType), suppSvc);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::suppSvcNotify, convertIntToRadioIndicationType(indicationType),
+                suppSvc);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("suppSvcNotifyInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -7376,8 +6721,8 @@ int radio::stkSessionEndInd(int slotId, int indicationType,
 #if VDBG
         RLOGD("stkSessionEndInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->stkSessionEnd(
-                convertIntToRadioIndicationType(indicationType));
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::stkSessionEnd, convertIntToRadioIndicationType(indicationType));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("stkSessionEndInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -7397,7 +6742,8 @@ int radio::stkProactiveCommandInd(int slotId,
 #if VDBG
         RLOGD("stkProactiveCommandInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->stkProactiveCommand(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::stkProactiveCommand,
                 convertIntToRadioIndicationType(indicationType),
                 convertCharPtrToHidlString((char *) response));
         radioService[slotId]->checkReturnStatus(retStatus);
@@ -7418,8 +6764,8 @@ int radio::stkEventNotifyInd(int slotId, int indicationType,
 #if VDBG
         RLOGD("stkEventNotifyInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->stkEventNotify(
-                convertIntToRadioIndicationType(indicationType),
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::stkEventNotify, convertIntToRadioIndicationType(indicationType),
                 convertCharPtrToHidlString((char *) response));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7440,8 +6786,9 @@ int radio::stkCallSetupInd(int slotId, int indicationType,
 #if VDBG
         RLOGD("stkCallSetupInd: timeout %d", timeout);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->stkCallSetup(
-                convertIntToRadioIndicationType(indicationType), timeout);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::stkCallSetup, convertIntToRadioIndicationType(indicationType),
+                timeout);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("stkCallSetupInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -7457,7 +6804,8 @@ int radio::simSmsStorageFullInd(int slotId,
 #if VDBG
         RLOGD("simSmsStorageFullInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->simSmsStorageFull(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::simSmsStorageFull,
                 convertIntToRadioIndicationType(indicationType));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7485,8 +6833,9 @@ int radio::simRefreshInd(int slotId, int indicationType,
 #if VDBG
         RLOGD("simRefreshInd: type %d efId %d", refreshResult.type, refreshResult.efId);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->simRefresh(
-                convertIntToRadioIndicationType(indicationType), refreshResult);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::simRefresh, convertIntToRadioIndicationType(indicationType),
+                refreshResult);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("simRefreshInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -7522,8 +6871,9 @@ int radio::callRingInd(int slotId, int indicationType,
 #if VDBG
         RLOGD("callRingInd: isGsm %d", isGsm);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->callRing(
-                convertIntToRadioIndicationType(indicationType), isGsm, record);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::callRing, convertIntToRadioIndicationType(indicationType), isGsm,
+                record);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("callRingInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -7539,7 +6889,8 @@ int radio::simStatusChangedInd(int slotId,
 #if VDBG
         RLOGD("simStatusChangedInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->simStatusChanged(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::simStatusChanged,
                 convertIntToRadioIndicationType(indicationType));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7587,8 +6938,9 @@ int radio::cdmaNewSmsInd(int slotId, int indicationType,
 #if VDBG
         RLOGD("cdmaNewSmsInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->cdmaNewSms(
-                convertIntToRadioIndicationType(indicationType), msg);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::cdmaNewSms, convertIntToRadioIndicationType(indicationType),
+                msg);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("cdmaNewSmsInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -7611,8 +6963,9 @@ int radio::newBroadcastSmsInd(int slotId,
 #if VDBG
         RLOGD("newBroadcastSmsInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->newBroadcastSms(
-                convertIntToRadioIndicationType(indicationType), data);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::newBroadcastSms, convertIntToRadioIndicationType(indicationType),
+                data);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("newBroadcastSmsInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -7628,7 +6981,8 @@ int radio::cdmaRuimSmsStorageFullInd(int slotId,
 #if VDBG
         RLOGD("cdmaRuimSmsStorageFullInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->cdmaRuimSmsStorageFull(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::cdmaRuimSmsStorageFull,
                 convertIntToRadioIndicationType(indicationType));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7651,7 +7005,8 @@ int radio::restrictedStateChangedInd(int slotId,
 #if VDBG
         RLOGD("restrictedStateChangedInd: state %d", state);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->restrictedStateChanged(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::restrictedStateChanged,
                 convertIntToRadioIndicationType(indicationType), (PhoneRestrictedState) state);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7669,7 +7024,8 @@ int radio::enterEmergencyCallbackModeInd(int slotId,
 #if VDBG
         RLOGD("enterEmergencyCallbackModeInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->enterEmergencyCallbackMode(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::enterEmergencyCallbackMode,
                 convertIntToRadioIndicationType(indicationType));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7703,8 +7059,9 @@ int radio::cdmaCallWaitingInd(int slotId,
 #if VDBG
         RLOGD("cdmaCallWaitingInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->cdmaCallWaiting(
-                convertIntToRadioIndicationType(indicationType), callWaitingRecord);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::cdmaCallWaiting, convertIntToRadioIndicationType(indicationType),
+                callWaitingRecord);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("cdmaCallWaitingInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -7725,7 +7082,8 @@ int radio::cdmaOtaProvisionStatusInd(int slotId,
 #if VDBG
         RLOGD("cdmaOtaProvisionStatusInd: status %d", status);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->cdmaOtaProvisionStatus(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::cdmaOtaProvisionStatus,
                 convertIntToRadioIndicationType(indicationType), (CdmaOtaProvisionStatus) status);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7904,8 +7262,9 @@ int radio::cdmaInfoRecInd(int slotId,
 #if VDBG
         RLOGD("cdmaInfoRecInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->cdmaInfoRec(
-                convertIntToRadioIndicationType(indicationType), records);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::cdmaInfoRec, convertIntToRadioIndicationType(indicationType),
+                records);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("cdmaInfoRecInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -7926,7 +7285,8 @@ int radio::indicateRingbackToneInd(int slotId,
 #if VDBG
         RLOGD("indicateRingbackToneInd: start %d", start);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->indicateRingbackTone(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::indicateRingbackTone,
                 convertIntToRadioIndicationType(indicationType), start);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7943,7 +7303,8 @@ int radio::resendIncallMuteInd(int slotId,
 #if VDBG
         RLOGD("resendIncallMuteInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->resendIncallMute(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::resendIncallMute,
                 convertIntToRadioIndicationType(indicationType));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7965,8 +7326,9 @@ int radio::cdmaSubscriptionSourceChangedInd(int slotId,
 #if VDBG
         RLOGD("cdmaSubscriptionSourceChangedInd: cdmaSource %d", cdmaSource);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->
-                cdmaSubscriptionSourceChanged(convertIntToRadioIndicationType(indicationType),
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::cdmaSubscriptionSourceChanged,
+                convertIntToRadioIndicationType(indicationType),
                 (CdmaSubscriptionSource) cdmaSource);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -7989,8 +7351,9 @@ int radio::cdmaPrlChangedInd(int slotId,
 #if VDBG
         RLOGD("cdmaPrlChangedInd: version %d", version);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->cdmaPrlChanged(
-                convertIntToRadioIndicationType(indicationType), version);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::cdmaPrlChanged, convertIntToRadioIndicationType(indicationType),
+                version);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("cdmaPrlChangedInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -8006,7 +7369,8 @@ int radio::exitEmergencyCallbackModeInd(int slotId,
 #if VDBG
         RLOGD("exitEmergencyCallbackModeInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->exitEmergencyCallbackMode(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::exitEmergencyCallbackMode,
                 convertIntToRadioIndicationType(indicationType));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -8022,8 +7386,8 @@ int radio::rilConnectedInd(int slotId,
                            size_t responseLen) {
     if (radioService[slotId] != NULL && radioService[slotId]->mRadioIndication != NULL) {
         RLOGD("rilConnectedInd");
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->rilConnected(
-                convertIntToRadioIndicationType(indicationType));
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::rilConnected, convertIntToRadioIndicationType(indicationType));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("rilConnectedInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -8044,7 +7408,8 @@ int radio::voiceRadioTechChangedInd(int slotId,
 #if VDBG
         RLOGD("voiceRadioTechChangedInd: rat %d", rat);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->voiceRadioTechChanged(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::voiceRadioTechChanged,
                 convertIntToRadioIndicationType(indicationType), (RadioTechnology) rat);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -8055,150 +7420,248 @@ int radio::voiceRadioTechChangedInd(int slotId,
     return 0;
 }
 
+/**
+ * Per-slot scratch used to convert cell info lists. records keeps its capacity across calls,
+ * and plmns memoizes the MCC/MNC strings of recently seen networks, replaced round robin.
+ */
+typedef struct PlmnStrings {
+    int mcc;
+    int mnc;
+    hidl_string mccStr;
+    hidl_string mncStr;
+} PlmnStrings;
+
+typedef struct CellInfoCache {
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    std::vector<CellInfo> records;
+    PlmnStrings plmns[CELL_INFO_PLMN_CACHE_SIZE];
+    int plmnCount = 0;
+    int nextPlmn = 0;
+} CellInfoCache;
+
+static CellInfoCache s_cellInfoCache[SIM_COUNT];
+
+template <typename T>
+static void resizeCellInfoVector(hidl_vec<T>& vec, bool used) {
+    size_t size = used ? 1 : 0;
+    if (vec.size() != size) {
+        vec.resize(size);
+    }
+}
+
+static void convertPlmnToHal(hidl_string& mccStr, hidl_string& mncStr, int mcc, int mnc,
+        CellInfoCache *plmnCache) {
+    if (plmnCache == NULL) {
+        mccStr = std::to_string(mcc);
+        mncStr = ril::util::mnc::decode(mnc);
+        return;
+    }
+
+    PlmnStrings *plmn = NULL;
+    for (int i = 0; i < plmnCache->plmnCount; i++) {
+        if (plmnCache->plmns[i].mcc == mcc && plmnCache->plmns[i].mnc == mnc) {
+            plmn = &plmnCache->plmns[i];
+            break;
+        }
+    }
+    if (plmn == NULL) {
+        plmn = &plmnCache->plmns[plmnCache->nextPlmn];
+        plmnCache->nextPlmn = (plmnCache->nextPlmn + 1) % CELL_INFO_PLMN_CACHE_SIZE;
+        if (plmnCache->plmnCount < CELL_INFO_PLMN_CACHE_SIZE) {
+            plmnCache->plmnCount++;
+        }
+        plmn->mcc = mcc;
+        plmn->mnc = mnc;
+        plmn->mccStr = std::to_string(mcc);
+        plmn->mncStr = ril::util::mnc::decode(mnc);
+    }
+
+    // Cached records usually describe the same cell as last time, skip the copy then
+    if (mccStr != plmn->mccStr) {
+        mccStr = plmn->mccStr;
+    }
+    if (mncStr != plmn->mncStr) {
+        mncStr = plmn->mncStr;
+    }
+}
+
+static void convertRilCellInfoToHal(CellInfo& record, RIL_CellInfo_v12 *rilCellInfo,
+        CellInfoCache *plmnCache) {
+    record.cellInfoType = (CellInfoType) rilCellInfo->cellInfoType;
+    record.registered = rilCellInfo->registered;
+    record.timeStampType = (TimeStampType) rilCellInfo->timeStampType;
+    record.timeStamp = rilCellInfo->timeStamp;
+    // All vectors should be size 0 except one which will be size 1. Records coming from the
+    // cache may already have the right one, so only resize the ones that change.
+    resizeCellInfoVector(record.gsm, rilCellInfo->cellInfoType == RIL_CELL_INFO_TYPE_GSM);
+    resizeCellInfoVector(record.wcdma, rilCellInfo->cellInfoType == RIL_CELL_INFO_TYPE_WCDMA);
+    resizeCellInfoVector(record.cdma, rilCellInfo->cellInfoType == RIL_CELL_INFO_TYPE_CDMA);
+    resizeCellInfoVector(record.lte, rilCellInfo->cellInfoType == RIL_CELL_INFO_TYPE_LTE);
+    resizeCellInfoVector(record.tdscdma,
+            rilCellInfo->cellInfoType == RIL_CELL_INFO_TYPE_TD_SCDMA);
+    switch(rilCellInfo->cellInfoType) {
+        case RIL_CELL_INFO_TYPE_GSM: {
+            CellInfoGsm *cellInfoGsm = &record.gsm[0];
+            convertPlmnToHal(cellInfoGsm->cellIdentityGsm.mcc, cellInfoGsm->cellIdentityGsm.mnc,
+                    rilCellInfo->CellInfo.gsm.cellIdentityGsm.mcc,
+                    rilCellInfo->CellInfo.gsm.cellIdentityGsm.mnc, plmnCache);
+            cellInfoGsm->cellIdentityGsm.lac =
+                    rilCellInfo->CellInfo.gsm.cellIdentityGsm.lac;
+            cellInfoGsm->cellIdentityGsm.cid =
+                    rilCellInfo->CellInfo.gsm.cellIdentityGsm.cid;
+            cellInfoGsm->cellIdentityGsm.arfcn =
+                    rilCellInfo->CellInfo.gsm.cellIdentityGsm.arfcn;
+            cellInfoGsm->cellIdentityGsm.bsic =
+                    rilCellInfo->CellInfo.gsm.cellIdentityGsm.bsic;
+            cellInfoGsm->signalStrengthGsm.signalStrength =
+                    rilCellInfo->CellInfo.gsm.signalStrengthGsm.signalStrength;
+            cellInfoGsm->signalStrengthGsm.bitErrorRate =
+                    rilCellInfo->CellInfo.gsm.signalStrengthGsm.bitErrorRate;
+            cellInfoGsm->signalStrengthGsm.timingAdvance =
+                    rilCellInfo->CellInfo.gsm.signalStrengthGsm.timingAdvance;
+            break;
+        }
+
+        case RIL_CELL_INFO_TYPE_WCDMA: {
+            CellInfoWcdma *cellInfoWcdma = &record.wcdma[0];
+            convertPlmnToHal(cellInfoWcdma->cellIdentityWcdma.mcc,
+                    cellInfoWcdma->cellIdentityWcdma.mnc,
+                    rilCellInfo->CellInfo.wcdma.cellIdentityWcdma.mcc,
+                    rilCellInfo->CellInfo.wcdma.cellIdentityWcdma.mnc, plmnCache);
+            cellInfoWcdma->cellIdentityWcdma.lac =
+                    rilCellInfo->CellInfo.wcdma.cellIdentityWcdma.lac;
+            cellInfoWcdma->cellIdentityWcdma.cid =
+                    rilCellInfo->CellInfo.wcdma.cellIdentityWcdma.cid;
+            cellInfoWcdma->cellIdentityWcdma.psc =
+                    rilCellInfo->CellInfo.wcdma.cellIdentityWcdma.psc;
+            cellInfoWcdma->cellIdentityWcdma.uarfcn =
+                    rilCellInfo->CellInfo.wcdma.cellIdentityWcdma.uarfcn;
+            cellInfoWcdma->signalStrengthWcdma.signalStrength =
+                    rilCellInfo->CellInfo.wcdma.signalStrengthWcdma.signalStrength;
+            cellInfoWcdma->signalStrengthWcdma.bitErrorRate =
+                    rilCellInfo->CellInfo.wcdma.signalStrengthWcdma.bitErrorRate;
+            break;
+        }
+
+        case RIL_CELL_INFO_TYPE_CDMA: {
+            CellInfoCdma *cellInfoCdma = &record.cdma[0];
+            cellInfoCdma->cellIdentityCdma.networkId =
+                    rilCellInfo->CellInfo.cdma.cellIdentityCdma.networkId;
+            cellInfoCdma->cellIdentityCdma.systemId =
+                    rilCellInfo->CellInfo.cdma.cellIdentityCdma.systemId;
+            cellInfoCdma->cellIdentityCdma.baseStationId =
+                    rilCellInfo->CellInfo.cdma.cellIdentityCdma.basestationId;
+            cellInfoCdma->cellIdentityCdma.longitude =
+                    rilCellInfo->CellInfo.cdma.cellIdentityCdma.longitude;
+            cellInfoCdma->cellIdentityCdma.latitude =
+                    rilCellInfo->CellInfo.cdma.cellIdentityCdma.latitude;
+            cellInfoCdma->signalStrengthCdma.dbm =
+                    rilCellInfo->CellInfo.cdma.signalStrengthCdma.dbm;
+            cellInfoCdma->signalStrengthCdma.ecio =
+                    rilCellInfo->CellInfo.cdma.signalStrengthCdma.ecio;
+            cellInfoCdma->signalStrengthEvdo.dbm =
+                    rilCellInfo->CellInfo.cdma.signalStrengthEvdo.dbm;
+            cellInfoCdma->signalStrengthEvdo.ecio =
+                    rilCellInfo->CellInfo.cdma.signalStrengthEvdo.ecio;
+            cellInfoCdma->signalStrengthEvdo.signalNoiseRatio =
+                    rilCellInfo->CellInfo.cdma.signalStrengthEvdo.signalNoiseRatio;
+            break;
+        }
+
+        case RIL_CELL_INFO_TYPE_LTE: {
+            CellInfoLte *cellInfoLte = &record.lte[0];
+            convertPlmnToHal(cellInfoLte->cellIdentityLte.mcc, cellInfoLte->cellIdentityLte.mnc,
+                    rilCellInfo->CellInfo.lte.cellIdentityLte.mcc,
+                    rilCellInfo->CellInfo.lte.cellIdentityLte.mnc, plmnCache);
+            cellInfoLte->cellIdentityLte.ci =
+                    rilCellInfo->CellInfo.lte.cellIdentityLte.ci;
+            cellInfoLte->cellIdentityLte.pci =
+                    rilCellInfo->CellInfo.lte.cellIdentityLte.pci;
+            cellInfoLte->cellIdentityLte.tac =
+                    rilCellInfo->CellInfo.lte.cellIdentityLte.tac;
+            cellInfoLte->cellIdentityLte.earfcn =
+                    rilCellInfo->CellInfo.lte.cellIdentityLte.earfcn;
+            cellInfoLte->signalStrengthLte.signalStrength =
+                    rilCellInfo->CellInfo.lte.signalStrengthLte.signalStrength;
+            cellInfoLte->signalStrengthLte.rsrp =
+                    rilCellInfo->CellInfo.lte.signalStrengthLte.rsrp;
+            cellInfoLte->signalStrengthLte.rsrq =
+                    rilCellInfo->CellInfo.lte.signalStrengthLte.rsrq;
+            cellInfoLte->signalStrengthLte.rssnr =
+                    rilCellInfo->CellInfo.lte.signalStrengthLte.rssnr;
+            cellInfoLte->signalStrengthLte.cqi =
+                    rilCellInfo->CellInfo.lte.signalStrengthLte.cqi;
+            cellInfoLte->signalStrengthLte.timingAdvance =
+                    rilCellInfo->CellInfo.lte.signalStrengthLte.timingAdvance;
+            break;
+        }
+
+        case RIL_CELL_INFO_TYPE_TD_SCDMA: {
+            CellInfoTdscdma *cellInfoTdscdma = &record.tdscdma[0];
+            convertPlmnToHal(cellInfoTdscdma->cellIdentityTdscdma.mcc,
+                    cellInfoTdscdma->cellIdentityTdscdma.mnc,
+                    rilCellInfo->CellInfo.tdscdma.cellIdentityTdscdma.mcc,
+                    rilCellInfo->CellInfo.tdscdma.cellIdentityTdscdma.mnc, plmnCache);
+            cellInfoTdscdma->cellIdentityTdscdma.lac =
+                    rilCellInfo->CellInfo.tdscdma.cellIdentityTdscdma.lac;
+            cellInfoTdscdma->cellIdentityTdscdma.cid =
+                    rilCellInfo->CellInfo.tdscdma.cellIdentityTdscdma.cid;
+            cellInfoTdscdma->cellIdentityTdscdma.cpid =
+                    rilCellInfo->CellInfo.tdscdma.cellIdentityTdscdma.cpid;
+            cellInfoTdscdma->signalStrengthTdscdma.rscp =
+                    rilCellInfo->CellInfo.tdscdma.signalStrengthTdscdma.rscp;
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
 void convertRilCellInfoListToHal(void *response, size_t responseLen, hidl_vec<CellInfo>& records) {
     int num = responseLen / sizeof(RIL_CellInfo_v12);
     records.resize(num);
 
     RIL_CellInfo_v12 *rillCellInfo = (RIL_CellInfo_v12 *) response;
     for (int i = 0; i < num; i++) {
-        records[i].cellInfoType = (CellInfoType) rillCellInfo->cellInfoType;
-        records[i].registered = rillCellInfo->registered;
-        records[i].timeStampType = (TimeStampType) rillCellInfo->timeStampType;
-        records[i].timeStamp = rillCellInfo->timeStamp;
-        // All vectors should be size 0 except one which will be size 1. Set everything to
-        // size 0 initially.
-        records[i].gsm.resize(0);
-        records[i].wcdma.resize(0);
-        records[i].cdma.resize(0);
-        records[i].lte.resize(0);
-        records[i].tdscdma.resize(0);
-        switch(rillCellInfo->cellInfoType) {
-            case RIL_CELL_INFO_TYPE_GSM: {
-                records[i].gsm.resize(1);
-                CellInfoGsm *cellInfoGsm = &records[i].gsm[0];
-                cellInfoGsm->cellIdentityGsm.mcc =
-                        std::to_string(rillCellInfo->CellInfo.gsm.cellIdentityGsm.mcc);
-                cellInfoGsm->cellIdentityGsm.mnc =
-                        ril::util::mnc::decode(rillCellInfo->CellInfo.gsm.cellIdentityGsm.mnc);
-                cellInfoGsm->cellIdentityGsm.lac =
-                        rillCellInfo->CellInfo.gsm.cellIdentityGsm.lac;
-                cellInfoGsm->cellIdentityGsm.cid =
-                        rillCellInfo->CellInfo.gsm.cellIdentityGsm.cid;
-                cellInfoGsm->cellIdentityGsm.arfcn =
-                        rillCellInfo->CellInfo.gsm.cellIdentityGsm.arfcn;
-                cellInfoGsm->cellIdentityGsm.bsic =
-                        rillCellInfo->CellInfo.gsm.cellIdentityGsm.bsic;
-                cellInfoGsm->signalStrengthGsm.signalStrength =
-                        rillCellInfo->CellInfo.gsm.signalStrengthGsm.signalStrength;
-                cellInfoGsm->signalStrengthGsm.bitErrorRate =
-                        rillCellInfo->CellInfo.gsm.signalStrengthGsm.bitErrorRate;
-                cellInfoGsm->signalStrengthGsm.timingAdvance =
-                        rillCellInfo->CellInfo.gsm.signalStrengthGsm.timingAdvance;
-                break;
-            }
-
-            case RIL_CELL_INFO_TYPE_WCDMA: {
-                records[i].wcdma.resize(1);
-                CellInfoWcdma *cellInfoWcdma = &records[i].wcdma[0];
-                cellInfoWcdma->cellIdentityWcdma.mcc =
-                        std::to_string(rillCellInfo->CellInfo.wcdma.cellIdentityWcdma.mcc);
-                cellInfoWcdma->cellIdentityWcdma.mnc =
-                        ril::util::mnc::decode(rillCellInfo->CellInfo.wcdma.cellIdentityWcdma.mnc);
-                cellInfoWcdma->cellIdentityWcdma.lac =
-                        rillCellInfo->CellInfo.wcdma.cellIdentityWcdma.lac;
-                cellInfoWcdma->cellIdentityWcdma.cid =
-                        rillCellInfo->CellInfo.wcdma.cellIdentityWcdma.cid;
-                cellInfoWcdma->cellIdentityWcdma.psc =
-                        rillCellInfo->CellInfo.wcdma.cellIdentityWcdma.psc;
-                cellInfoWcdma->cellIdentityWcdma.uarfcn =
-                        rillCellInfo->CellInfo.wcdma.cellIdentityWcdma.uarfcn;
-                cellInfoWcdma->signalStrengthWcdma.signalStrength =
-                        rillCellInfo->CellInfo.wcdma.signalStrengthWcdma.signalStrength;
-                cellInfoWcdma->signalStrengthWcdma.bitErrorRate =
-                        rillCellInfo->CellInfo.wcdma.signalStrengthWcdma.bitErrorRate;
-                break;
-            }
+        convertRilCellInfoToHal(records[i], rillCellInfo, NULL);
+        rillCellInfo += 1;
+    }
+}
 
-            case RIL_CELL_INFO_TYPE_CDMA: {
-                records[i].cdma.resize(1);
-                CellInfoCdma *cellInfoCdma = &records[i].cdma[0];
-                cellInfoCdma->cellIdentityCdma.networkId =
-                        rillCellInfo->CellInfo.cdma.cellIdentityCdma.networkId;
-                cellInfoCdma->cellIdentityCdma.systemId =
-                        rillCellInfo->CellInfo.cdma.cellIdentityCdma.systemId;
-                cellInfoCdma->cellIdentityCdma.baseStationId =
-                        rillCellInfo->CellInfo.cdma.cellIdentityCdma.basestationId;
-                cellInfoCdma->cellIdentityCdma.longitude =
-                        rillCellInfo->CellInfo.cdma.cellIdentityCdma.longitude;
-                cellInfoCdma->cellIdentityCdma.latitude =
-                        rillCellInfo->CellInfo.cdma.cellIdentityCdma.latitude;
-                cellInfoCdma->signalStrengthCdma.dbm =
-                        rillCellInfo->CellInfo.cdma.signalStrengthCdma.dbm;
-                cellInfoCdma->signalStrengthCdma.ecio =
-                        rillCellInfo->CellInfo.cdma.signalStrengthCdma.ecio;
-                cellInfoCdma->signalStrengthEvdo.dbm =
-                        rillCellInfo->CellInfo.cdma.signalStrengthEvdo.dbm;
-                cellInfoCdma->signalStrengthEvdo.ecio =
-                        rillCellInfo->CellInfo.cdma.signalStrengthEvdo.ecio;
-                cellInfoCdma->signalStrengthEvdo.signalNoiseRatio =
-                        rillCellInfo->CellInfo.cdma.signalStrengthEvdo.signalNoiseRatio;
-                break;
-            }
+/**
+ * Same as convertRilCellInfoListToHal(), but converts into the cache of slotId and points
+ * records at it instead of allocating. The cache is returned locked and must be handed to
+ * releaseCellInfoCache() once records has been sent. If another thread is using the cache,
+ * the list is converted the uncached way and NULL is returned.
+ */
+static CellInfoCache *convertRilCellInfoListToHalCached(int slotId, void *response,
+        size_t responseLen, hidl_vec<CellInfo>& records) {
+    CellInfoCache *cache = &s_cellInfoCache[slotId];
+    if (pthread_mutex_trylock(&cache->mutex) != 0) {
+        convertRilCellInfoListToHal(response, responseLen, records);
+        return NULL;
+    }
 
-            case RIL_CELL_INFO_TYPE_LTE: {
-                records[i].lte.resize(1);
-                CellInfoLte *cellInfoLte = &records[i].lte[0];
-                cellInfoLte->cellIdentityLte.mcc =
-                        std::to_string(rillCellInfo->CellInfo.lte.cellIdentityLte.mcc);
-                cellInfoLte->cellIdentityLte.mnc =
-                        ril::util::mnc::decode(rillCellInfo->CellInfo.lte.cellIdentityLte.mnc);
-                cellInfoLte->cellIdentityLte.ci =
-                        rillCellInfo->CellInfo.lte.cellIdentityLte.ci;
-                cellInfoLte->cellIdentityLte.pci =
-                        rillCellInfo->CellInfo.lte.cellIdentityLte.pci;
-                cellInfoLte->cellIdentityLte.tac =
-                        rillCellInfo->CellInfo.lte.cellIdentityLte.tac;
-                cellInfoLte->cellIdentityLte.earfcn =
-                        rillCellInfo->CellInfo.lte.cellIdentityLte.earfcn;
-                cellInfoLte->signalStrengthLte.signalStrength =
-                        rillCellInfo->CellInfo.lte.signalStrengthLte.signalStrength;
-                cellInfoLte->signalStrengthLte.rsrp =
-                        rillCellInfo->CellInfo.lte.signalStrengthLte.rsrp;
-                cellInfoLte->signalStrengthLte.rsrq =
-                        rillCellInfo->CellInfo.lte.signalStrengthLte.rsrq;
-                cellInfoLte->signalStrengthLte.rssnr =
-                        rillCellInfo->CellInfo.lte.signalStrengthLte.rssnr;
-                cellInfoLte->signalStrengthLte.cqi =
-                        rillCellInfo->CellInfo.lte.signalStrengthLte.cqi;
-                cellInfoLte->signalStrengthLte.timingAdvance =
-                        rillCellInfo->CellInfo.lte.signalStrengthLte.timingAdvance;
-                break;
-            }
+    size_t num = responseLen / sizeof(RIL_CellInfo_v12);
+    if (cache->records.size() < num) {
+        cache->records.resize(num);
+    }
 
-            case RIL_CELL_INFO_TYPE_TD_SCDMA: {
-                records[i].tdscdma.resize(1);
-                CellInfoTdscdma *cellInfoTdscdma = &records[i].tdscdma[0];
-                cellInfoTdscdma->cellIdentityTdscdma.mcc =
-                        std::to_string(rillCellInfo->CellInfo.tdscdma.cellIdentityTdscdma.mcc);
-                cellInfoTdscdma->cellIdentityTdscdma.mnc =
-                        ril::util::mnc::decode(
-                                rillCellInfo->CellInfo.tdscdma.cellIdentityTdscdma.mnc);
-                cellInfoTdscdma->cellIdentityTdscdma.lac =
-                        rillCellInfo->CellInfo.tdscdma.cellIdentityTdscdma.lac;
-                cellInfoTdscdma->cellIdentityTdscdma.cid =
-                        rillCellInfo->CellInfo.tdscdma.cellIdentityTdscdma.cid;
-                cellInfoTdscdma->cellIdentityTdscdma.cpid =
-                        rillCellInfo->CellInfo.tdscdma.cellIdentityTdscdma.cpid;
-                cellInfoTdscdma->signalStrengthTdscdma.rscp =
-                        rillCellInfo->CellInfo.tdscdma.signalStrengthTdscdma.rscp;
-                break;
-            }
-            default: {
-                break;
-            }
-        }
+    RIL_CellInfo_v12 *rillCellInfo = (RIL_CellInfo_v12 *) response;
+    for (size_t i = 0; i < num; i++) {
+        convertRilCellInfoToHal(cache->records[i], rillCellInfo, cache);
         rillCellInfo += 1;
     }
+
+    records.setToExternal(cache->records.data(), num);
+    return cache;
+}
+
+static void releaseCellInfoCache(CellInfoCache *cache) {
+    if (cache != NULL) {
+        pthread_mutex_unlock(&cache->mutex);
+    }
 }
 
 int radio::cellInfoListInd(int slotId,
@@ -8211,13 +7674,16 @@ int radio::cellInfoListInd(int slotId,
         }
 
         hidl_vec<CellInfo> records;
-        convertRilCellInfoListToHal(response, responseLen, records);
+        CellInfoCache *cache = convertRilCellInfoListToHalCached(slotId, response, responseLen,
+                records);
 
 #if VDBG
         RLOGD("cellInfoListInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->cellInfoList(
-                convertIntToRadioIndicationType(indicationType), records);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::cellInfoList, convertIntToRadioIndicationType(indicationType),
+                records);
+        releaseCellInfoCache(cache);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("cellInfoListInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -8233,7 +7699,8 @@ int radio::imsNetworkStateChangedInd(int slotId,
 #if VDBG
         RLOGD("imsNetworkStateChangedInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->imsNetworkStateChanged(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::imsNetworkStateChanged,
                 convertIntToRadioIndicationType(indicationType));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -8256,7 +7723,8 @@ int radio::subscriptionStatusChangedInd(int slotId,
 #if VDBG
         RLOGD("subscriptionStatusChangedInd: activate %d", activate);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->subscriptionStatusChanged(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::subscriptionStatusChanged,
                 convertIntToRadioIndicationType(indicationType), activate);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -8279,7 +7747,8 @@ int radio::srvccStateNotifyInd(int slotId,
 #if VDBG
         RLOGD("srvccStateNotifyInd: rat %d", state);
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->srvccStateNotify(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::srvccStateNotify,
                 convertIntToRadioIndicationType(indicationType), (SrvccState) state);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -8338,7 +7807,8 @@ int radio::hardwareConfigChangedInd(int slotId,
 #if VDBG
         RLOGD("hardwareConfigChangedInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->hardwareConfigChanged(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::hardwareConfigChanged,
                 convertIntToRadioIndicationType(indicationType), configs);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -8373,7 +7843,8 @@ int radio::radioCapabilityIndicationInd(int slotId,
 #if VDBG
         RLOGD("radioCapabilityIndicationInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->radioCapabilityIndication(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::radioCapabilityIndication,
                 convertIntToRadioIndicationType(indicationType), rc);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -8465,9 +7936,9 @@ int radio::onSupplementaryServiceIndicationInd(int slotId,
 #if VDBG
         RLOGD("onSupplementaryServiceIndicationInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->
-                onSupplementaryServiceIndication(convertIntToRadioIndicationType(indicationType),
-                ss);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::onSupplementaryServiceIndication,
+                convertIntToRadioIndicationType(indicationType), ss);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("onSupplementaryServiceIndicationInd: "
@@ -8488,7 +7959,8 @@ int radio::stkCallControlAlphaNotifyInd(int slotId,
 #if VDBG
         RLOGD("stkCallControlAlphaNotifyInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->stkCallControlAlphaNotify(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::stkCallControlAlphaNotify,
                 convertIntToRadioIndicationType(indicationType),
                 convertCharPtrToHidlString((char *) response));
         radioService[slotId]->checkReturnStatus(retStatus);
@@ -8521,8 +7993,8 @@ int radio::lceDataInd(int slotId,
 #if VDBG
         RLOGD("lceDataInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->lceData(
-                convertIntToRadioIndicationType(indicationType), lce);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::lceData, convertIntToRadioIndicationType(indicationType), lce);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("lceDataInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -8550,8 +8022,8 @@ int radio::pcoDataInd(int slotId,
 #if VDBG
         RLOGD("pcoDataInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->pcoData(
-                convertIntToRadioIndicationType(indicationType), pco);
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::pcoData, convertIntToRadioIndicationType(indicationType), pco);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("pcoDataInd: radioService[%d]->mRadioIndication == NULL", slotId);
@@ -8571,8 +8043,8 @@ int radio::modemResetInd(int slotId,
 #if VDBG
         RLOGD("modemResetInd");
 #endif
-        Return<void> retStatus = radioService[slotId]->mRadioIndication->modemReset(
-                convertIntToRadioIndicationType(indicationType),
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndication,
+                &IRadioIndication::modemReset, convertIntToRadioIndicationType(indicationType),
                 convertCharPtrToHidlString((char *) response));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
@@ -8604,13 +8076,15 @@ int radio::networkScanResultInd(int slotId,
         V1_1::NetworkScanResult result;
         result.status = (V1_1::ScanStatus) networkScanResult->status;
         result.error = (RadioError) networkScanResult->error;
-        convertRilCellInfoListToHal(
+        CellInfoCache *cache = convertRilCellInfoListToHalCached(slotId,
                 networkScanResult->network_infos,
                 networkScanResult->network_infos_length * sizeof(RIL_CellInfo_v12),
                 result.networkInfos);
 
-        Return<void> retStatus = radioService[slotId]->mRadioIndicationV1_1->networkScanResult(
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndicationV1_1,
+                &V1_1::IRadioIndication::networkScanResult,
                 convertIntToRadioIndicationType(indicationType), result);
+        releaseCellInfoCache(cache);
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("networkScanResultInd: radioService[%d]->mRadioIndicationV1_1 == NULL", slotId);
@@ -8627,8 +8101,9 @@ int radio::carrierInfoForImsiEncryption(int slotId,
             return 0;
         }
         RLOGD("carrierInfoForImsiEncryption");
-        Return<void> retStatus = radioService[slotId]->mRadioIndicationV1_1->
-                carrierInfoForImsiEncryption(convertIntToRadioIndicationType(indicationType));
+        Return<void> retStatus = sendRadioCall(slotId, radioService[slotId]->mRadioIndicationV1_1,
+                &V1_1::IRadioIndication::carrierInfoForImsiEncryption,
+                convertIntToRadioIndicationType(indicationType));
         radioService[slotId]->checkReturnStatus(retStatus);
     } else {
         RLOGE("carrierInfoForImsiEncryption: radioService[%d]->mRadioIndicationV1_1 == NULL",
@@ -8665,7 +8140,8 @@ int radio::keepaliveStatusInd(int slotId,
     V1_1::KeepaliveStatus ks;
     convertRilKeepaliveStatusToHal(static_cast<RIL_KeepaliveStatus*>(response), ks);
 
-    Return<void> retStatus = radioIndicationV1_1->keepaliveStatus(
+    Return<void> retStatus = sendRadioCall(slotId, radioIndicationV1_1,
+            &V1_1::IRadioIndication::keepaliveStatus,
             convertIntToRadioIndicationType(indicationType), ks);
     radioService[slotId]->checkReturnStatus(retStatus);
     return 0;
@@ -8720,7 +8196,16 @@ void radio::registerService(RIL_RadioFunctions *callbacks, CommandInfo *commands
     s_vendorFunctions = callbacks;
     s_commands = commands;
 
-    configureRpcThreadpool(1, true /* callerWillJoin */);
+    // Before any service is up, so no response or indication of a slot is ever sent inline once
+    // its sender is running
+    startResponseSenders(simCount);
+
+    int rpcThreads = property_get_int32(PROPERTY_RPC_THREADS, 1);
+    if (rpcThreads < 1) {
+        rpcThreads = 1;
+    }
+    RLOGD("registerService: %d RPC threads", rpcThreads);
+    configureRpcThreadpool(rpcThreads, true /* callerWillJoin */);
     for (int i = 0; i < simCount; i++) {
         pthread_rwlock_t *radioServiceRwlockPtr = getRadioServiceRwlock(i);
         int ret = pthread_rwlock_wrlock(radioServiceRwlockPtr);
@@ -8750,12 +8235,13 @@ void rilc_thread_pool() {
 pthread_rwlock_t * radio::getRadioServiceRwlock(int slotId) {
     pthread_rwlock_t *radioServiceRwlockPtr = &radioServiceRwlock;
 
+    // slotId is 0 based, like RIL_SOCKET_ID
     #if (SIM_COUNT >= 2)
-    if (slotId == 2) radioServiceRwlockPtr = &radioServiceRwlock2;
+    if (slotId == 1) radioServiceRwlockPtr = &radioServiceRwlock2;
     #if (SIM_COUNT >= 3)
-    if (slotId == 3) radioServiceRwlockPtr = &radioServiceRwlock3;
+    if (slotId == 2) radioServiceRwlockPtr = &radioServiceRwlock3;
     #if (SIM_COUNT >= 4)
-    if (slotId == 4) radioServiceRwlockPtr = &radioServiceRwlock4;
+    if (slotId == 3) radioServiceRwlockPtr = &radioServiceRwlock4;
     #endif
     #endif
     #endif
@@ -8763,7 +8249,7 @@ pthread_rwlock_t * radio::getRadioServiceRwlock(int slotId) {
     return radioServiceRwlockPtr;
 }
 
-// should acquire write lock for the corresponding service before calling this
+// atomic, so no service lock is needed to call this
 void radio::setNitzTimeReceived(int slotId, long timeReceived) {
-    nitzTimeReceived[slotId] = timeReceived;
+    __atomic_store_n(&nitzTimeReceived[slotId], (int64_t) timeReceived, __ATOMIC_RELEASE);
 }
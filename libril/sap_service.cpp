@@ -18,6 +18,8 @@
 
 #include <android/hardware/radio/1.1/ISap.h>
 
+#include <atomic>
+
 #include <hwbinder/IPCThreadState.h>
 #include <hwbinder/ProcessState.h>
 #include <sap_service.h>
@@ -47,6 +49,21 @@ struct SapImpl : public android::hardware::radio::V1_1::ISap {
     sp<ISapCallback> sapCallback;
     RIL_SOCKET_ID rilSocketId;
 
+    /**
+     * Encoded request payload and APDU command, kept for the whole connection. ISap calls are
+     * oneway and hwbinder hands them to this object one at a time, so these need no lock.
+     */
+    uint8_t *requestBuffer = NULL;
+    size_t requestBufferSize = 0;
+    uint8_t *commandBuffer = NULL;
+    size_t commandBufferSize = 0;
+
+    /**
+     * Message size from the last connect response. It arrives on the vendor RIL's thread, so it
+     * is only recorded here and the next request resizes requestBuffer to it.
+     */
+    std::atomic<int32_t> negotiatedMsgSize{0};
+
     Return<void> setCallback(const ::android::sp<ISapCallback>& sapCallbackParam);
 
     Return<void> connectReq(int32_t token, int32_t maxMsgSize);
@@ -67,7 +84,8 @@ struct SapImpl : public android::hardware::radio::V1_1::ISap {
 
     MsgHeader* createMsgHeader(MsgId msgId, int32_t token);
 
-    Return<void> addPayloadAndDispatchRequest(MsgHeader *msg, uint16_t reqLen, uint8_t *reqPtr);
+    Return<void> encodeAndDispatchRequest(MsgHeader *msg, const pb_field_t fields[],
+            const void *req);
 
     void sendFailedResponse(MsgId msgId, int32_t token, int numPointers, ...);
 
@@ -104,29 +122,83 @@ MsgHeader* SapImpl::createMsgHeader(MsgId msgId, int32_t token) {
     return msg;
 }
 
-Return<void> SapImpl::addPayloadAndDispatchRequest(MsgHeader *msg, uint16_t reqLen,
-        uint8_t *reqPtr) {
-    pb_bytes_array_t *payload = (pb_bytes_array_t *) malloc(sizeof(pb_bytes_array_t) - 1 + reqLen);
-    if (payload == NULL) {
-        sendFailedResponse(msg->id, msg->token, 2, reqPtr, msg);
-        return Void();
+/**
+ * Grow a per-connection buffer to hold at least size bytes.
+ */
+static bool reserveBuffer(uint8_t **buffer, size_t *bufferSize, size_t size) {
+    if (*bufferSize >= size) {
+        return true;
+    }
+    uint8_t *grown = (uint8_t *)realloc(*buffer, size);
+    if (grown == NULL) {
+        return false;
     }
+    *buffer = grown;
+    *bufferSize = size;
+    return true;
+}
 
-    msg->payload = payload;
-    msg->payload->size = reqLen;
-    memcpy(msg->payload->bytes, reqPtr, reqLen);
+/**
+ * Resize a per-connection buffer to exactly size bytes, keeping the old one if that fails.
+ */
+static void resizeBuffer(uint8_t **buffer, size_t *bufferSize, size_t size) {
+    uint8_t *resized = (uint8_t *)realloc(*buffer, size);
+    if (resized != NULL) {
+        *buffer = resized;
+        *bufferSize = size;
+    }
+}
+
+Return<void> SapImpl::encodeAndDispatchRequest(MsgHeader *msg, const pb_field_t fields[],
+        const void *req) {
+    size_t offset = PB_BYTES_ARRAY_T_ALLOCSIZE(0);
+    pb_ostream_t stream;
+    bool encoded = false;
+
+    int32_t negotiated = negotiatedMsgSize.exchange(0);
+    if (negotiated > 0) {
+        resizeBuffer(&requestBuffer, &requestBufferSize, offset + negotiated);
+    }
+
+    if (requestBufferSize > offset) {
+        stream = pb_ostream_from_buffer(requestBuffer + offset, requestBufferSize - offset);
+        encoded = pb_encode(&stream, fields, req);
+    }
+
+    if (!encoded) {
+        // nothing negotiated yet or larger than the negotiated size, size it exactly and retry
+        size_t encodedSize = 0;
+        if (!pb_get_encoded_size(&encodedSize, fields, req)) {
+            RLOGE("SapImpl::encodeAndDispatchRequest: Error getting encoded size for msgId %d",
+                    msg->id);
+            sendFailedResponse(msg->id, msg->token, 1, msg);
+            return Void();
+        }
+        if (!reserveBuffer(&requestBuffer, &requestBufferSize, offset + encodedSize)) {
+            RLOGE("SapImpl::encodeAndDispatchRequest: Error allocating memory for buffer");
+            sendFailedResponse(msg->id, msg->token, 1, msg);
+            return Void();
+        }
+        stream = pb_ostream_from_buffer(requestBuffer + offset, requestBufferSize - offset);
+        if (!pb_encode(&stream, fields, req)) {
+            RLOGE("SapImpl::encodeAndDispatchRequest: Error encoding msgId %d", msg->id);
+            sendFailedResponse(msg->id, msg->token, 1, msg);
+            return Void();
+        }
+    }
+
+    // the vendor RIL copies the payload in onRequest, so it can stay in requestBuffer
+    msg->payload = (pb_bytes_array_t *)requestBuffer;
+    msg->payload->size = stream.bytes_written;
 
     RilSapSocket *sapSocket = RilSapSocket::getSocketById(rilSocketId);
     if (sapSocket) {
-        RLOGD("SapImpl::addPayloadAndDispatchRequest: calling dispatchRequest");
+        RLOGD("SapImpl::encodeAndDispatchRequest: calling dispatchRequest");
         sapSocket->dispatchRequest(msg);
     } else {
-        RLOGE("SapImpl::addPayloadAndDispatchRequest: sapSocket is null");
-        sendFailedResponse(msg->id, msg->token, 3, payload, reqPtr, msg);
-        return Void();
+        RLOGE("SapImpl::encodeAndDispatchRequest: sapSocket is null");
+        sendFailedResponse(msg->id, msg->token, 1, msg);
     }
-    free(msg->payload);
-    free(reqPtr);
     return Void();
 }
 
@@ -198,31 +270,8 @@ Return<void> SapImpl::connectReq(int32_t token, int32_t maxMsgSize) {
     memset(&req, 0, sizeof(RIL_SIM_SAP_CONNECT_REQ));
     req.max_message_size = maxMsgSize;
 
-    size_t encodedSize = 0;
-    if (!pb_get_encoded_size(&encodedSize, RIL_SIM_SAP_CONNECT_REQ_fields, &req)) {
-        RLOGE("SapImpl::connectReq: Error getting encoded size for RIL_SIM_SAP_CONNECT_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_CONNECT, token, 1, msg);
-        return Void();
-    }
-
-    uint8_t *buffer = (uint8_t *)calloc(1, encodedSize);
-    if (buffer == NULL) {
-        RLOGE("SapImpl::connectReq: Error allocating memory for buffer");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_CONNECT, token, 1, msg);
-        return Void();
-    }
-    pb_ostream_t stream = pb_ostream_from_buffer(buffer, encodedSize);
-
-    RLOGD("SapImpl::connectReq calling pb_encode");
-    if (!pb_encode(&stream, RIL_SIM_SAP_CONNECT_REQ_fields, &req)) {
-        RLOGE("SapImpl::connectReq: Error encoding RIL_SIM_SAP_CONNECT_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_CONNECT, token, 2, buffer, msg);
-        return Void();
-    }
-    /***** Encode RIL_SIM_SAP_CONNECT_REQ done *****/
-
     /* encoded req is payload */
-    return addPayloadAndDispatchRequest(msg, stream.bytes_written, buffer);
+    return encodeAndDispatchRequest(msg, RIL_SIM_SAP_CONNECT_REQ_fields, &req);
 }
 
 Return<void> SapImpl::disconnectReq(int32_t token) {
@@ -238,32 +287,8 @@ Return<void> SapImpl::disconnectReq(int32_t token) {
     RIL_SIM_SAP_DISCONNECT_REQ req;
     memset(&req, 0, sizeof(RIL_SIM_SAP_DISCONNECT_REQ));
 
-    size_t encodedSize = 0;
-    if (!pb_get_encoded_size(&encodedSize, RIL_SIM_SAP_DISCONNECT_REQ_fields, &req)) {
-        RLOGE("SapImpl::disconnectReq: Error getting encoded size for RIL_SIM_SAP_DISCONNECT_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_DISCONNECT, token, 1, msg);
-        return Void();
-    }
-
-    uint8_t *buffer = (uint8_t *)calloc(1, encodedSize);
-    if (buffer == NULL) {
-        RLOGE("SapImpl::disconnectReq: Error allocating memory for buffer");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_DISCONNECT, token, 1, msg);
-        return Void();
-    }
-
-    pb_ostream_t stream = pb_ostream_from_buffer(buffer, encodedSize);
-
-    RLOGD("SapImpl::disconnectReq calling pb_encode");
-    if (!pb_encode(&stream, RIL_SIM_SAP_DISCONNECT_REQ_fields, &req)) {
-        RLOGE("SapImpl::disconnectReq: Error encoding RIL_SIM_SAP_DISCONNECT_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_DISCONNECT, token, 2, buffer, msg);
-        return Void();
-    }
-    /***** Encode RIL_SIM_SAP_DISCONNECT_REQ done *****/
-
     /* encoded req is payload */
-    return addPayloadAndDispatchRequest(msg, stream.bytes_written, buffer);
+    return encodeAndDispatchRequest(msg, RIL_SIM_SAP_DISCONNECT_REQ_fields, &req);
 }
 
 Return<void> SapImpl::apduReq(int32_t token, SapApduType type, const hidl_vec<uint8_t>& command) {
@@ -281,42 +306,19 @@ Return<void> SapImpl::apduReq(int32_t token, SapApduType type, const hidl_vec<ui
     req.type = (RIL_SIM_SAP_APDU_REQ_Type)type;
 
     if (command.size() > 0) {
-        req.command = (pb_bytes_array_t *)malloc(sizeof(pb_bytes_array_t) - 1 + command.size());
-        if (req.command == NULL) {
+        if (!reserveBuffer(&commandBuffer, &commandBufferSize,
+                PB_BYTES_ARRAY_T_ALLOCSIZE(command.size()))) {
             RLOGE("SapImpl::apduReq: Error allocating memory for req.command");
             sendFailedResponse(MsgId_RIL_SIM_SAP_APDU, token, 1, msg);
             return Void();
         }
+        req.command = (pb_bytes_array_t *)commandBuffer;
         req.command->size = command.size();
         memcpy(req.command->bytes, command.data(), command.size());
     }
 
-    size_t encodedSize = 0;
-    if (!pb_get_encoded_size(&encodedSize, RIL_SIM_SAP_APDU_REQ_fields, &req)) {
-        RLOGE("SapImpl::apduReq: Error getting encoded size for RIL_SIM_SAP_APDU_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_APDU, token, 2, req.command, msg);
-        return Void();
-    }
-
-    uint8_t *buffer = (uint8_t *)calloc(1, encodedSize);
-    if (buffer == NULL) {
-        RLOGE("SapImpl::apduReq: Error allocating memory for buffer");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_APDU, token, 2, req.command, msg);
-        return Void();
-    }
-
-    pb_ostream_t stream = pb_ostream_from_buffer(buffer, encodedSize);
-
-    RLOGD("SapImpl::apduReq calling pb_encode");
-    if (!pb_encode(&stream, RIL_SIM_SAP_APDU_REQ_fields, &req)) {
-        RLOGE("SapImpl::apduReq: Error encoding RIL_SIM_SAP_APDU_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_APDU, token, 3, req.command, buffer, msg);
-        return Void();
-    }
-    /***** Encode RIL_SIM_SAP_APDU_REQ done *****/
-
     /* encoded req is payload */
-    return addPayloadAndDispatchRequest(msg, stream.bytes_written, buffer);
+    return encodeAndDispatchRequest(msg, RIL_SIM_SAP_APDU_REQ_fields, &req);
 }
 
 Return<void> SapImpl::transferAtrReq(int32_t token) {
@@ -332,33 +334,8 @@ Return<void> SapImpl::transferAtrReq(int32_t token) {
     RIL_SIM_SAP_TRANSFER_ATR_REQ req;
     memset(&req, 0, sizeof(RIL_SIM_SAP_TRANSFER_ATR_REQ));
 
-    size_t encodedSize = 0;
-    if (!pb_get_encoded_size(&encodedSize, RIL_SIM_SAP_TRANSFER_ATR_REQ_fields, &req)) {
-        RLOGE("SapImpl::transferAtrReq: Error getting encoded size for "
-                "RIL_SIM_SAP_TRANSFER_ATR_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_TRANSFER_ATR, token, 1, msg);
-        return Void();
-    }
-
-    uint8_t *buffer = (uint8_t *)calloc(1, encodedSize);
-    if (buffer == NULL) {
-        RLOGE("SapImpl::transferAtrReq: Error allocating memory for buffer");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_TRANSFER_ATR, token, 1, msg);
-        return Void();
-    }
-
-    pb_ostream_t stream = pb_ostream_from_buffer(buffer, encodedSize);
-
-    RLOGD("SapImpl::transferAtrReq calling pb_encode");
-    if (!pb_encode(&stream, RIL_SIM_SAP_TRANSFER_ATR_REQ_fields, &req)) {
-        RLOGE("SapImpl::transferAtrReq: Error encoding RIL_SIM_SAP_TRANSFER_ATR_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_TRANSFER_ATR, token, 2, buffer, msg);
-        return Void();
-    }
-    /***** Encode RIL_SIM_SAP_TRANSFER_ATR_REQ done *****/
-
     /* encoded req is payload */
-    return addPayloadAndDispatchRequest(msg, stream.bytes_written, buffer);
+    return encodeAndDispatchRequest(msg, RIL_SIM_SAP_TRANSFER_ATR_REQ_fields, &req);
 }
 
 Return<void> SapImpl::powerReq(int32_t token, bool state) {
@@ -375,32 +352,8 @@ Return<void> SapImpl::powerReq(int32_t token, bool state) {
     memset(&req, 0, sizeof(RIL_SIM_SAP_POWER_REQ));
     req.state = state;
 
-    size_t encodedSize = 0;
-    if (!pb_get_encoded_size(&encodedSize, RIL_SIM_SAP_POWER_REQ_fields, &req)) {
-        RLOGE("SapImpl::powerReq: Error getting encoded size for RIL_SIM_SAP_POWER_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_POWER, token, 1, msg);
-        return Void();
-    }
-
-    uint8_t *buffer = (uint8_t *)calloc(1, encodedSize);
-    if (buffer == NULL) {
-        RLOGE("SapImpl::powerReq: Error allocating memory for buffer");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_POWER, token, 1, msg);
-        return Void();
-    }
-
-    pb_ostream_t stream = pb_ostream_from_buffer(buffer, encodedSize);
-
-    RLOGD("SapImpl::powerReq calling pb_encode");
-    if (!pb_encode(&stream, RIL_SIM_SAP_POWER_REQ_fields, &req)) {
-        RLOGE("SapImpl::powerReq: Error encoding RIL_SIM_SAP_POWER_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_POWER, token, 2, buffer, msg);
-        return Void();
-    }
-    /***** Encode RIL_SIM_SAP_POWER_REQ done *****/
-
     /* encoded req is payload */
-    return addPayloadAndDispatchRequest(msg, stream.bytes_written, buffer);
+    return encodeAndDispatchRequest(msg, RIL_SIM_SAP_POWER_REQ_fields, &req);
 }
 
 Return<void> SapImpl::resetSimReq(int32_t token) {
@@ -416,32 +369,8 @@ Return<void> SapImpl::resetSimReq(int32_t token) {
     RIL_SIM_SAP_RESET_SIM_REQ req;
     memset(&req, 0, sizeof(RIL_SIM_SAP_RESET_SIM_REQ));
 
-    size_t encodedSize = 0;
-    if (!pb_get_encoded_size(&encodedSize, RIL_SIM_SAP_RESET_SIM_REQ_fields, &req)) {
-        RLOGE("SapImpl::resetSimReq: Error getting encoded size for RIL_SIM_SAP_RESET_SIM_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_RESET_SIM, token, 1, msg);
-        return Void();
-    }
-
-    uint8_t *buffer = (uint8_t *)calloc(1, encodedSize);
-    if (buffer == NULL) {
-        RLOGE("SapImpl::resetSimReq: Error allocating memory for buffer");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_RESET_SIM, token, 1, msg);
-        return Void();
-    }
-
-    pb_ostream_t stream = pb_ostream_from_buffer(buffer, encodedSize);
-
-    RLOGD("SapImpl::resetSimReq calling pb_encode");
-    if (!pb_encode(&stream, RIL_SIM_SAP_RESET_SIM_REQ_fields, &req)) {
-        RLOGE("SapImpl::resetSimReq: Error encoding RIL_SIM_SAP_RESET_SIM_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_RESET_SIM, token, 2, buffer, msg);
-        return Void();
-    }
-    /***** Encode RIL_SIM_SAP_RESET_SIM_REQ done *****/
-
     /* encoded req is payload */
-    return addPayloadAndDispatchRequest(msg, stream.bytes_written, buffer);
+    return encodeAndDispatchRequest(msg, RIL_SIM_SAP_RESET_SIM_REQ_fields, &req);
 }
 
 Return<void> SapImpl::transferCardReaderStatusReq(int32_t token) {
@@ -457,35 +386,9 @@ Return<void> SapImpl::transferCardReaderStatusReq(int32_t token) {
     RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_REQ req;
     memset(&req, 0, sizeof(RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_REQ));
 
-    size_t encodedSize = 0;
-    if (!pb_get_encoded_size(&encodedSize, RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_REQ_fields,
-            &req)) {
-        RLOGE("SapImpl::transferCardReaderStatusReq: Error getting encoded size for "
-                "RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS, token, 1, msg);
-        return Void();
-    }
-
-    uint8_t *buffer = (uint8_t *)calloc(1, encodedSize);
-    if (buffer == NULL) {
-        RLOGE("SapImpl::transferCardReaderStatusReq: Error allocating memory for buffer");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS, token, 1, msg);
-        return Void();
-    }
-
-    pb_ostream_t stream = pb_ostream_from_buffer(buffer, encodedSize);
-
-    RLOGD("SapImpl::transferCardReaderStatusReq calling pb_encode");
-    if (!pb_encode(&stream, RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_REQ_fields, &req)) {
-        RLOGE("SapImpl::transferCardReaderStatusReq: Error encoding "
-                "RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS, token, 2, buffer, msg);
-        return Void();
-    }
-    /***** Encode RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_REQ done *****/
-
     /* encoded req is payload */
-    return addPayloadAndDispatchRequest(msg, stream.bytes_written, buffer);
+    return encodeAndDispatchRequest(msg, RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_REQ_fields,
+            &req);
 }
 
 Return<void> SapImpl::setTransferProtocolReq(int32_t token, SapTransferProtocol transferProtocol) {
@@ -502,162 +405,170 @@ Return<void> SapImpl::setTransferProtocolReq(int32_t token, SapTransferProtocol
     memset(&req, 0, sizeof(RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_REQ));
     req.protocol = (RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_REQ_Protocol)transferProtocol;
 
-    size_t encodedSize = 0;
-    if (!pb_get_encoded_size(&encodedSize, RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_REQ_fields, &req)) {
-        RLOGE("SapImpl::setTransferProtocolReq: Error getting encoded size for "
-                "RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_SET_TRANSFER_PROTOCOL, token, 1, msg);
-        return Void();
-    }
-
-    uint8_t *buffer = (uint8_t *)calloc(1, encodedSize);
-    if (buffer == NULL) {
-        RLOGE("SapImpl::setTransferProtocolReq: Error allocating memory for buffer");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_SET_TRANSFER_PROTOCOL, token, 1, msg);
-        return Void();
-    }
+    /* encoded req is payload */
+    return encodeAndDispatchRequest(msg, RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_REQ_fields, &req);
+}
 
-    pb_ostream_t stream = pb_ostream_from_buffer(buffer, encodedSize);
+/**
+ * Any response or indication sapDecodeMessage() can decode, so it can be decoded on the stack.
+ */
+typedef union SapMessage {
+    RIL_SIM_SAP_CONNECT_RSP connectRsp;
+    RIL_SIM_SAP_DISCONNECT_RSP disconnectRsp;
+    RIL_SIM_SAP_DISCONNECT_IND disconnectInd;
+    RIL_SIM_SAP_APDU_RSP apduRsp;
+    RIL_SIM_SAP_TRANSFER_ATR_RSP transferAtrRsp;
+    RIL_SIM_SAP_POWER_RSP powerRsp;
+    RIL_SIM_SAP_RESET_SIM_RSP resetSimRsp;
+    RIL_SIM_SAP_STATUS_IND statusInd;
+    RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_RSP transferCardReaderStatusRsp;
+    RIL_SIM_SAP_ERROR_RSP errorRsp;
+    RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_RSP setTransferProtocolRsp;
+} SapMessage;
+
+/**
+ * The bytes field of an APDU or ATR response. It points into the vendor buffer the response was
+ * decoded from, so it is only valid until processResponse() returns.
+ */
+typedef struct SapBytes {
+    const uint8_t *bytes;
+    size_t size;
+} SapBytes;
+
+/**
+ * Decode a response made of a required enum and an optional bytes field. pb_decode() would
+ * malloc the bytes field for every response, so the fields are read with the nanopb stream
+ * functions and the bytes are left in the vendor buffer.
+ */
+static bool sapDecodeBytesResponse(pb_istream_t *stream, const uint8_t *payloadPtr,
+        size_t payloadLen, uint32_t responseTag, uint32_t bytesTag, uint64_t *response,
+        SapBytes *bytes) {
+    bool haveResponse = false;
+    while (stream->bytes_left > 0) {
+        pb_wire_type_t wireType;
+        uint32_t tag;
+        bool eof;
+        if (!pb_decode_tag(stream, &wireType, &tag, &eof)) {
+            if (eof) {
+                break;
+            }
+            return false;
+        }
 
-    RLOGD("SapImpl::setTransferProtocolReq calling pb_encode");
-    if (!pb_encode(&stream, RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_REQ_fields, &req)) {
-        RLOGE("SapImpl::setTransferProtocolReq: Error encoding "
-                "RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_REQ");
-        sendFailedResponse(MsgId_RIL_SIM_SAP_SET_TRANSFER_PROTOCOL, token, 2, buffer, msg);
-        return Void();
+        if (tag == responseTag && wireType == PB_WT_VARINT) {
+            if (!pb_decode_varint(stream, response)) {
+                return false;
+            }
+            haveResponse = true;
+        } else if (tag == bytesTag && wireType == PB_WT_STRING) {
+            uint64_t size;
+            if (!pb_decode_varint(stream, &size) || size > stream->bytes_left) {
+                return false;
+            }
+            bytes->bytes = payloadPtr + (payloadLen - stream->bytes_left);
+            bytes->size = size;
+            if (!pb_read(stream, NULL, size)) {
+                return false;
+            }
+        } else if (!pb_skip_field(stream, wireType)) {
+            return false;
+        }
     }
-    /***** Encode RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_REQ done *****/
-
-    /* encoded req is payload */
-    return addPayloadAndDispatchRequest(msg, stream.bytes_written, buffer);
+    return haveResponse;
 }
 
-void *sapDecodeMessage(MsgId msgId, MsgType msgType, uint8_t *payloadPtr, size_t payloadLen) {
-    void *responsePtr = NULL;
+bool sapDecodeMessage(MsgId msgId, MsgType msgType, const uint8_t *payloadPtr, size_t payloadLen,
+        SapMessage *message, SapBytes *bytes) {
+    const pb_field_t *fields;
+    const char *name;
     pb_istream_t stream;
+    uint64_t response = 0;
+    bool decoded;
 
-    /* Create the stream */
-    stream = pb_istream_from_buffer((uint8_t *)payloadPtr, payloadLen);
-
-    /* Decode based on the message id */
+    /* Pick the message based on the message id */
     switch (msgId)
     {
         case MsgId_RIL_SIM_SAP_CONNECT:
-            responsePtr = malloc(sizeof(RIL_SIM_SAP_CONNECT_RSP));
-            if (responsePtr) {
-                if (!pb_decode(&stream, RIL_SIM_SAP_CONNECT_RSP_fields, responsePtr)) {
-                    RLOGE("Error decoding RIL_SIM_SAP_CONNECT_RSP");
-                    return NULL;
-                }
-            }
+            fields = RIL_SIM_SAP_CONNECT_RSP_fields;
+            name = "RIL_SIM_SAP_CONNECT_RSP";
             break;
 
         case MsgId_RIL_SIM_SAP_DISCONNECT:
             if (msgType == MsgType_RESPONSE) {
-                responsePtr = malloc(sizeof(RIL_SIM_SAP_DISCONNECT_RSP));
-                if (responsePtr) {
-                    if (!pb_decode(&stream, RIL_SIM_SAP_DISCONNECT_RSP_fields, responsePtr)) {
-                        RLOGE("Error decoding RIL_SIM_SAP_DISCONNECT_RSP");
-                        return NULL;
-                    }
-                }
+                fields = RIL_SIM_SAP_DISCONNECT_RSP_fields;
+                name = "RIL_SIM_SAP_DISCONNECT_RSP";
             } else {
-                responsePtr = malloc(sizeof(RIL_SIM_SAP_DISCONNECT_IND));
-                if (responsePtr) {
-                    if (!pb_decode(&stream, RIL_SIM_SAP_DISCONNECT_IND_fields, responsePtr)) {
-                        RLOGE("Error decoding RIL_SIM_SAP_DISCONNECT_IND");
-                        return NULL;
-                    }
-                }
+                fields = RIL_SIM_SAP_DISCONNECT_IND_fields;
+                name = "RIL_SIM_SAP_DISCONNECT_IND";
             }
             break;
 
         case MsgId_RIL_SIM_SAP_APDU:
-            responsePtr = malloc(sizeof(RIL_SIM_SAP_APDU_RSP));
-            if (responsePtr) {
-                if (!pb_decode(&stream, RIL_SIM_SAP_APDU_RSP_fields, responsePtr)) {
-                    RLOGE("Error decoding RIL_SIM_SAP_APDU_RSP");
-                    return NULL;
-                }
-            }
+            fields = RIL_SIM_SAP_APDU_RSP_fields;
+            name = "RIL_SIM_SAP_APDU_RSP";
             break;
 
         case MsgId_RIL_SIM_SAP_TRANSFER_ATR:
-            responsePtr = malloc(sizeof(RIL_SIM_SAP_TRANSFER_ATR_RSP));
-            if (responsePtr) {
-                if (!pb_decode(&stream, RIL_SIM_SAP_TRANSFER_ATR_RSP_fields, responsePtr)) {
-                    RLOGE("Error decoding RIL_SIM_SAP_TRANSFER_ATR_RSP");
-                    return NULL;
-                }
-            }
+            fields = RIL_SIM_SAP_TRANSFER_ATR_RSP_fields;
+            name = "RIL_SIM_SAP_TRANSFER_ATR_RSP";
             break;
 
         case MsgId_RIL_SIM_SAP_POWER:
-            responsePtr = malloc(sizeof(RIL_SIM_SAP_POWER_RSP));
-            if (responsePtr) {
-                if (!pb_decode(&stream, RIL_SIM_SAP_POWER_RSP_fields, responsePtr)) {
-                    RLOGE("Error decoding RIL_SIM_SAP_POWER_RSP");
-                    return NULL;
-                }
-            }
+            fields = RIL_SIM_SAP_POWER_RSP_fields;
+            name = "RIL_SIM_SAP_POWER_RSP";
             break;
 
         case MsgId_RIL_SIM_SAP_RESET_SIM:
-            responsePtr = malloc(sizeof(RIL_SIM_SAP_RESET_SIM_RSP));
-            if (responsePtr) {
-                if (!pb_decode(&stream, RIL_SIM_SAP_RESET_SIM_RSP_fields, responsePtr)) {
-                    RLOGE("Error decoding RIL_SIM_SAP_RESET_SIM_RSP");
-                    return NULL;
-                }
-            }
+            fields = RIL_SIM_SAP_RESET_SIM_RSP_fields;
+            name = "RIL_SIM_SAP_RESET_SIM_RSP";
             break;
 
         case MsgId_RIL_SIM_SAP_STATUS:
-            responsePtr = malloc(sizeof(RIL_SIM_SAP_STATUS_IND));
-            if (responsePtr) {
-                if (!pb_decode(&stream, RIL_SIM_SAP_STATUS_IND_fields, responsePtr)) {
-                    RLOGE("Error decoding RIL_SIM_SAP_STATUS_IND");
-                    return NULL;
-                }
-            }
+            fields = RIL_SIM_SAP_STATUS_IND_fields;
+            name = "RIL_SIM_SAP_STATUS_IND";
             break;
 
         case MsgId_RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS:
-            responsePtr = malloc(sizeof(RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_RSP));
-            if (responsePtr) {
-                if (!pb_decode(&stream, RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_RSP_fields,
-                        responsePtr)) {
-                    RLOGE("Error decoding RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_RSP");
-                    return NULL;
-                }
-            }
+            fields = RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_RSP_fields;
+            name = "RIL_SIM_SAP_TRANSFER_CARD_READER_STATUS_RSP";
             break;
 
         case MsgId_RIL_SIM_SAP_ERROR_RESP:
-            responsePtr = malloc(sizeof(RIL_SIM_SAP_ERROR_RSP));
-            if (responsePtr) {
-                if (!pb_decode(&stream, RIL_SIM_SAP_ERROR_RSP_fields, responsePtr)) {
-                    RLOGE("Error decoding RIL_SIM_SAP_ERROR_RSP");
-                    return NULL;
-                }
-            }
+            fields = RIL_SIM_SAP_ERROR_RSP_fields;
+            name = "RIL_SIM_SAP_ERROR_RSP";
             break;
 
         case MsgId_RIL_SIM_SAP_SET_TRANSFER_PROTOCOL:
-            responsePtr = malloc(sizeof(RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_RSP));
-            if (responsePtr) {
-                if (!pb_decode(&stream, RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_RSP_fields,
-                        responsePtr)) {
-                    RLOGE("Error decoding RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_RSP");
-                    return NULL;
-                }
-            }
+            fields = RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_RSP_fields;
+            name = "RIL_SIM_SAP_SET_TRANSFER_PROTOCOL_RSP";
             break;
 
         default:
-            break;
+            return false;
+    }
+
+    /* Decode straight from the vendor buffer */
+    memset(message, 0, sizeof(SapMessage));
+    memset(bytes, 0, sizeof(SapBytes));
+    stream = pb_istream_from_buffer((uint8_t *)payloadPtr, payloadLen);
+    if (msgId == MsgId_RIL_SIM_SAP_APDU) {
+        decoded = sapDecodeBytesResponse(&stream, payloadPtr, payloadLen,
+                RIL_SIM_SAP_APDU_RSP_response_tag, RIL_SIM_SAP_APDU_RSP_apduResponse_tag,
+                &response, bytes);
+        message->apduRsp.response = (RIL_SIM_SAP_APDU_RSP_Response)response;
+    } else if (msgId == MsgId_RIL_SIM_SAP_TRANSFER_ATR) {
+        decoded = sapDecodeBytesResponse(&stream, payloadPtr, payloadLen,
+                RIL_SIM_SAP_TRANSFER_ATR_RSP_response_tag, RIL_SIM_SAP_TRANSFER_ATR_RSP_atr_tag,
+                &response, bytes);
+        message->transferAtrRsp.response = (RIL_SIM_SAP_TRANSFER_ATR_RSP_Response)response;
+    } else {
+        decoded = pb_decode(&stream, fields, message);
+    }
+    if (!decoded) {
+        RLOGE("Error decoding %s", name);
+        return false;
     }
-    return responsePtr;
+    return true;
 } /* sapDecodeMessage */
 
 sp<SapImpl> getSapImpl(RilSapSocket *sapSocket) {
@@ -763,12 +674,12 @@ SapResultCode convertTransferCardReaderStatusResponseProtoToHal(
     return SapResultCode::GENERIC_FAILURE;
 }
 
-void processResponse(MsgHeader *rsp, RilSapSocket *sapSocket, MsgType msgType) {
+void processResponse(MsgHeader *rsp, const uint8_t *data, size_t dataLen,
+        RilSapSocket *sapSocket, MsgType msgType) {
     MsgId msgId = rsp->id;
-    uint8_t *data = rsp->payload->bytes;
-    size_t dataLen = rsp->payload->size;
-
-    void *messagePtr = sapDecodeMessage(msgId, msgType, data, dataLen);
+    SapMessage message;
+    SapBytes bytes;
+    void *messagePtr = &message;
 
     sp<SapImpl> sapImpl = getSapImpl(sapSocket);
     if (sapImpl->sapCallback == NULL) {
@@ -777,8 +688,8 @@ void processResponse(MsgHeader *rsp, RilSapSocket *sapSocket, MsgType msgType) {
         return;
     }
 
-    if (messagePtr == NULL) {
-        RLOGE("processResponse: *messagePtr == NULL; msgId = %d; msgType = %d",
+    if (!sapDecodeMessage(msgId, msgType, data, dataLen, &message, &bytes)) {
+        RLOGE("processResponse: failed to decode; msgId = %d; msgType = %d",
                 msgId, msgType);
         sapImpl->sendFailedResponse(msgId, rsp->token, 0);
         return;
@@ -795,6 +706,9 @@ void processResponse(MsgHeader *rsp, RilSapSocket *sapSocket, MsgType msgType) {
                     rsp->token,
                     connectRsp->response,
                     connectRsp->max_message_size);
+            if (connectRsp->max_message_size > 0) {
+                sapImpl->negotiatedMsgSize = connectRsp->max_message_size;
+            }
             retStatus = sapImpl->sapCallback->connectResponse(rsp->token,
                     (SapConnectRsp)connectRsp->response,
                     connectRsp->max_message_size);
@@ -821,8 +735,8 @@ void processResponse(MsgHeader *rsp, RilSapSocket *sapSocket, MsgType msgType) {
             RLOGD("processResponse: calling sapCallback->apduResponse %d %d",
                     rsp->token, apduResponse);
             hidl_vec<uint8_t> apduRspVec;
-            if (apduRsp->apduResponse != NULL && apduRsp->apduResponse->size > 0) {
-                apduRspVec.setToExternal(apduRsp->apduResponse->bytes, apduRsp->apduResponse->size);
+            if (bytes.size > 0) {
+                apduRspVec.setToExternal((uint8_t *)bytes.bytes, bytes.size);
             }
             retStatus = sapImpl->sapCallback->apduResponse(rsp->token, apduResponse, apduRspVec);
             break;
@@ -836,9 +750,8 @@ void processResponse(MsgHeader *rsp, RilSapSocket *sapSocket, MsgType msgType) {
             RLOGD("processResponse: calling sapCallback->transferAtrResponse %d %d",
                     rsp->token, transferAtrResponse);
             hidl_vec<uint8_t> transferAtrRspVec;
-            if (transferAtrRsp->atr != NULL && transferAtrRsp->atr->size > 0) {
-                transferAtrRspVec.setToExternal(transferAtrRsp->atr->bytes,
-                        transferAtrRsp->atr->size);
+            if (bytes.size > 0) {
+                transferAtrRspVec.setToExternal((uint8_t *)bytes.bytes, bytes.size);
             }
             retStatus = sapImpl->sapCallback->transferAtrResponse(rsp->token, transferAtrResponse,
                     transferAtrRspVec);
@@ -915,12 +828,14 @@ void processResponse(MsgHeader *rsp, RilSapSocket *sapSocket, MsgType msgType) {
     sapImpl->checkReturnStatus(retStatus);
 }
 
-void sap::processResponse(MsgHeader *rsp, RilSapSocket *sapSocket) {
-    processResponse(rsp, sapSocket, MsgType_RESPONSE);
+void sap::processResponse(MsgHeader *rsp, const void *data, size_t dataLen,
+        RilSapSocket *sapSocket) {
+    processResponse(rsp, (const uint8_t *)data, dataLen, sapSocket, MsgType_RESPONSE);
 }
 
-void sap::processUnsolResponse(MsgHeader *rsp, RilSapSocket *sapSocket) {
-    processResponse(rsp, sapSocket, MsgType_UNSOL_RESPONSE);
+void sap::processUnsolResponse(MsgHeader *rsp, const void *data, size_t dataLen,
+        RilSapSocket *sapSocket) {
+    processResponse(rsp, (const uint8_t *)data, dataLen, sapSocket, MsgType_UNSOL_RESPONSE);
 }
 
 void sap::registerService(const RIL_RadioFunctions *callbacks) {
@@ -25,8 +25,9 @@
 namespace sap {
 
 void registerService(const RIL_RadioFunctions *callbacks);
-void processResponse(MsgHeader *rsp, RilSapSocket *sapSocket);
-void processUnsolResponse(MsgHeader *rsp, RilSapSocket *sapSocket);
+void processResponse(MsgHeader *rsp, const void *data, size_t dataLen, RilSapSocket *sapSocket);
+void processUnsolResponse(MsgHeader *rsp, const void *data, size_t dataLen,
+        RilSapSocket *sapSocket);
 
 }   // namespace android
 
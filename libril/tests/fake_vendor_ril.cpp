@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <deque>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include <telephony/ril.h>
+#include <ril_internal.h>
+#include "fake_vendor_ril.h"
+
+#define FAKE_VENDOR_RIL_VERSION 13
+#define FAKE_IMSI "001010123456789"
+
+using android::RequestInfo;
+
+/** A request the vendor thread completes once its due time has come */
+typedef struct PendingCompletion {
+    RIL_Token t;
+    int request;
+    struct timespec due;
+} PendingCompletion;
+
+static FakeVendorConfig s_config;
+static FakeVendorCompleteCallback s_onComplete;
+
+static pthread_mutex_t s_pendingMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_pendingCond = PTHREAD_COND_INITIALIZER;
+static std::deque<PendingCompletion> s_pending;
+
+static RIL_SignalStrength_v10 s_signalStrength;
+
+static void addUs(struct timespec *ts, int us) {
+    ts->tv_sec += us / 1000000;
+    ts->tv_nsec += (long) (us % 1000000) * 1000;
+    if (ts->tv_nsec >= 1000000000) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000;
+    }
+}
+
+static void complete(RIL_Token t, int request) {
+    int32_t serial = ((RequestInfo *) t)->token;
+
+    switch (request) {
+        case RIL_REQUEST_SIGNAL_STRENGTH:
+            RIL_onRequestComplete(t, RIL_E_SUCCESS, &s_signalStrength, sizeof(s_signalStrength));
+            break;
+        case RIL_REQUEST_GET_IMSI:
+            RIL_onRequestComplete(t, RIL_E_SUCCESS, (void *) FAKE_IMSI, sizeof(char *));
+            break;
+        default:
+            RIL_onRequestComplete(t, RIL_E_SUCCESS, NULL, 0);
+            break;
+    }
+
+    s_onComplete(serial);
+}
+
+static void *vendorThreadLoop(void *param) {
+    for (;;) {
+        pthread_mutex_lock(&s_pendingMutex);
+        while (s_pending.empty()) {
+            pthread_cond_wait(&s_pendingCond, &s_pendingMutex);
+        }
+        PendingCompletion pending = s_pending.front();
+        s_pending.pop_front();
+        pthread_mutex_unlock(&s_pendingMutex);
+
+        // Latency is the same for every request, so the queue is also in due order
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &pending.due, NULL) != 0) {
+        }
+        complete(pending.t, pending.request);
+    }
+
+    return NULL;
+}
+
+#if defined(ANDROID_MULTI_SIM)
+static void onRequest(int request, void *data, size_t datalen, RIL_Token t,
+        RIL_SOCKET_ID socket_id) {
+#else
+static void onRequest(int request, void *data, size_t datalen, RIL_Token t) {
+#endif
+    if (!s_config.async) {
+        if (s_config.latencyUs > 0) {
+            struct timespec delay = {0, 0};
+            addUs(&delay, s_config.latencyUs);
+            while (nanosleep(&delay, &delay) != 0) {
+            }
+        }
+        complete(t, request);
+        return;
+    }
+
+    if (s_config.ack) {
+        RIL_onRequestAck(t);
+    }
+
+    PendingCompletion pending;
+    pending.t = t;
+    pending.request = request;
+    clock_gettime(CLOCK_MONOTONIC, &pending.due);
+    addUs(&pending.due, s_config.latencyUs);
+
+    pthread_mutex_lock(&s_pendingMutex);
+    s_pending.push_back(pending);
+    pthread_cond_signal(&s_pendingCond);
+    pthread_mutex_unlock(&s_pendingMutex);
+}
+
+#if defined(ANDROID_MULTI_SIM)
+static RIL_RadioState onStateRequest(RIL_SOCKET_ID socket_id) {
+#else
+static RIL_RadioState onStateRequest() {
+#endif
+    return RADIO_STATE_ON;
+}
+
+static int supports(int requestCode) {
+    return 1;
+}
+
+static void onCancel(RIL_Token t) {
+}
+
+static const char *getVersion(void) {
+    return "fake-vendor-ril";
+}
+
+static RIL_RadioFunctions s_callbacks = {
+    FAKE_VENDOR_RIL_VERSION,
+    onRequest,
+    onStateRequest,
+    supports,
+    onCancel,
+    getVersion
+};
+
+const RIL_RadioFunctions *fake_vendor_ril_init(const FakeVendorConfig *config,
+        FakeVendorCompleteCallback onComplete) {
+    s_config = *config;
+    s_onComplete = onComplete;
+    s_callbacks.version = config->version > 0 ? config->version : FAKE_VENDOR_RIL_VERSION;
+
+    memset(&s_signalStrength, 0, sizeof(s_signalStrength));
+    s_signalStrength.GW_SignalStrength.signalStrength = 20;
+    s_signalStrength.GW_SignalStrength.bitErrorRate = 99;
+    s_signalStrength.LTE_SignalStrength.signalStrength = 99;
+
+    if (s_config.async) {
+        pthread_attr_t attr;
+        pthread_t tid;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        pthread_create(&tid, &attr, vendorThreadLoop, NULL);
+        pthread_attr_destroy(&attr);
+    }
+
+    return &s_callbacks;
+}
+
+void fake_vendor_ril_flood_unsol(void) {
+    RIL_SignalStrength_v10 signalStrength = s_signalStrength;
+
+    for (int i = 0; i < s_config.unsolCount; i++) {
+        signalStrength.GW_SignalStrength.signalStrength = i % 32;
+#if defined(ANDROID_MULTI_SIM)
+        RIL_onUnsolicitedResponse(RIL_UNSOL_SIGNAL_STRENGTH, &signalStrength,
+                sizeof(signalStrength), RIL_SOCKET_1);
+#else
+        RIL_onUnsolicitedResponse(RIL_UNSOL_SIGNAL_STRENGTH, &signalStrength,
+                sizeof(signalStrength));
+#endif
+        if (s_config.unsolIntervalUs > 0) {
+            struct timespec delay = {0, 0};
+            addUs(&delay, s_config.unsolIntervalUs);
+            while (nanosleep(&delay, &delay) != 0) {
+            }
+        }
+    }
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_FAKE_VENDOR_RIL_H
+#define ANDROID_FAKE_VENDOR_RIL_H
+
+#include <stdint.h>
+#include <telephony/ril.h>
+
+/**
+ * A stand-in vendor RIL for driving libril without a modem. It answers every request with
+ * RIL_E_SUCCESS after a fixed latency, either inside onRequest() as a blocking vendor RIL
+ * does or later from its own thread, and can send a flood of signal strength indications.
+ */
+typedef struct FakeVendorConfig {
+    int version;            // RIL_RadioFunctions version to report, 0 for the default
+    int latencyUs;          // Time the vendor takes for each request
+    bool async;             // Complete from the vendor thread instead of inside onRequest()
+    bool ack;               // RIL_onRequestAck() each async request when it is received
+    int unsolCount;         // Indications sent by fake_vendor_ril_flood_unsol()
+    int unsolIntervalUs;    // Gap between two indications, 0 for back to back
+} FakeVendorConfig;
+
+// Called with the serial of each request once RIL_onRequestComplete() returned for it
+typedef void (*FakeVendorCompleteCallback)(int32_t serial);
+
+// Set up the fake vendor RIL; the result is meant for RIL_register()
+const RIL_RadioFunctions *fake_vendor_ril_init(const FakeVendorConfig *config,
+        FakeVendorCompleteCallback onComplete);
+
+// Send config->unsolCount indications from the calling thread
+void fake_vendor_ril_flood_unsol(void);
+
+#endif // ANDROID_FAKE_VENDOR_RIL_H
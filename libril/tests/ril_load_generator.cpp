@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Load generator for libril. It registers the fake vendor RIL, then pushes requests through
+ * dispatchVoid(), dispatchStrings() and dispatchInts() the way the IRadio methods do, with
+ * a bounded number in flight, and reports requests/s, completion latency percentiles and
+ * heap allocations per request. No framework client is attached, so response functions
+ * stop where they would call IRadioResponse.
+ *
+ * Usage: ril_load_generator [-n requests] [-w in flight] [-l latency us] [-a] [-k]
+ *                           [-u indications] [-i indication interval us]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <getopt.h>
+#include <inttypes.h>
+#include <new>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include <telephony/ril.h>
+#include <ril_internal.h>
+#include <ril_recorder.h>
+#include "fake_vendor_ril.h"
+
+#define LOAD_GENERATOR_SERVICE_NAME "load1"
+#define LOAD_GENERATOR_AID "A0000000871002"
+
+// Defined in ril_service.cpp; the IRadio methods queue their requests through these
+bool dispatchVoid(int serial, int slotId, int request);
+bool dispatchStrings(int serial, int slotId, int request, bool allowEmpty, int countStrings, ...);
+bool dispatchInts(int serial, int slotId, int request, int countInts, ...);
+
+extern "C" char ril_service_name[MAX_SERVICE_NAME_LENGTH];
+extern "C" void RIL_startEventLoop(void);
+
+/**
+ * Heap allocations made by libril. The module links with --wrap for the C allocator, which
+ * covers the libril sources built into it, and replaces operator new for everything else.
+ */
+static std::atomic<uint64_t> s_allocations(0);
+
+extern "C" void *__real_malloc(size_t size);
+extern "C" void *__real_calloc(size_t nmemb, size_t size);
+extern "C" void *__real_realloc(void *ptr, size_t size);
+extern "C" char *__real_strdup(const char *s);
+
+extern "C" void *__wrap_malloc(size_t size) {
+    s_allocations++;
+    return __real_malloc(size);
+}
+
+extern "C" void *__wrap_calloc(size_t nmemb, size_t size) {
+    s_allocations++;
+    return __real_calloc(nmemb, size);
+}
+
+extern "C" void *__wrap_realloc(void *ptr, size_t size) {
+    s_allocations++;
+    return __real_realloc(ptr, size);
+}
+
+extern "C" char *__wrap_strdup(const char *s) {
+    s_allocations++;
+    return __real_strdup(s);
+}
+
+void *operator new(size_t size) {
+    s_allocations++;
+    void *p = __real_malloc(size == 0 ? 1 : size);
+    if (p == NULL) {
+        abort();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t size) noexcept {
+    free(p);
+}
+
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_cond = PTHREAD_COND_INITIALIZER;
+static int s_inFlight;
+static int s_completed;
+
+static std::vector<uint64_t> s_startTimes;
+static std::vector<uint64_t> s_latencies;
+
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void onComplete(int32_t serial) {
+    uint64_t now = nowNs();
+
+    pthread_mutex_lock(&s_mutex);
+    s_latencies[serial] = now - s_startTimes[serial];
+    s_inFlight--;
+    s_completed++;
+    pthread_cond_broadcast(&s_cond);
+    pthread_mutex_unlock(&s_mutex);
+}
+
+static void *unsolFloodLoop(void *param) {
+    fake_vendor_ril_flood_unsol();
+    return NULL;
+}
+
+static void dispatch(int serial) {
+    switch (serial % 3) {
+        case 0:
+            dispatchVoid(serial, 0, RIL_REQUEST_SIGNAL_STRENGTH);
+            break;
+        case 1:
+            dispatchStrings(serial, 0, RIL_REQUEST_GET_IMSI, false, 1, LOAD_GENERATOR_AID);
+            break;
+        default:
+            dispatchInts(serial, 0, RIL_REQUEST_HANGUP, 1, 1);
+            break;
+    }
+}
+
+static double percentileUs(const std::vector<uint64_t>& sorted, int percent) {
+    size_t index = (sorted.size() - 1) * percent / 100;
+    return sorted[index] / 1000.0;
+}
+
+int main(int argc, char **argv) {
+    FakeVendorConfig config = {};
+    int requests = 10000;
+    int window = 8;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:w:l:aku:i:")) != -1) {
+        switch (opt) {
+            case 'n': requests = atoi(optarg); break;
+            case 'w': window = atoi(optarg); break;
+            case 'l': config.latencyUs = atoi(optarg); break;
+            case 'a': config.async = true; break;
+            case 'k': config.ack = true; break;
+            case 'u': config.unsolCount = atoi(optarg); break;
+            case 'i': config.unsolIntervalUs = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-n requests] [-w in flight] [-l latency us] [-a] "
+                        "[-k] [-u indications] [-i indication interval us]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (requests < 1 || window < 1) {
+        fprintf(stderr, "%s: need at least one request in flight\n", argv[0]);
+        return 1;
+    }
+
+    s_startTimes.resize(requests);
+    s_latencies.resize(requests);
+
+    // Never take over the services of the real rild
+    strlcpy(ril_service_name, LOAD_GENERATOR_SERVICE_NAME, sizeof(ril_service_name));
+    // nor its trace
+    android::ril_recorder_disable();
+    RIL_startEventLoop();
+    RIL_register(fake_vendor_ril_init(&config, onComplete));
+
+    pthread_t unsolThread;
+    if (config.unsolCount > 0) {
+        pthread_create(&unsolThread, NULL, unsolFloodLoop, NULL);
+    }
+
+    uint64_t allocationsBefore = s_allocations;
+    uint64_t start = nowNs();
+
+    for (int serial = 0; serial < requests; serial++) {
+        pthread_mutex_lock(&s_mutex);
+        while (s_inFlight >= window) {
+            pthread_cond_wait(&s_cond, &s_mutex);
+        }
+        s_inFlight++;
+        s_startTimes[serial] = nowNs();
+        pthread_mutex_unlock(&s_mutex);
+
+        dispatch(serial);
+    }
+
+    pthread_mutex_lock(&s_mutex);
+    while (s_completed < requests) {
+        pthread_cond_wait(&s_cond, &s_mutex);
+    }
+    pthread_mutex_unlock(&s_mutex);
+
+    uint64_t elapsed = nowNs() - start;
+    uint64_t allocations = s_allocations - allocationsBefore;
+
+    if (config.unsolCount > 0) {
+        pthread_join(unsolThread, NULL);
+    }
+
+    std::vector<uint64_t> sorted(s_latencies);
+    std::sort(sorted.begin(), sorted.end());
+
+    printf("%d requests, %d in flight, %s vendor, %dus latency%s, %d indications\n", requests,
+            window, config.async ? "async" : "sync", config.latencyUs,
+            config.ack ? ", acked" : "", config.unsolCount);
+    printf("  %.0f requests/s over %.1fms\n", requests * 1e9 / elapsed, elapsed / 1e6);
+    printf("  completion latency: p50 %.1fus p90 %.1fus p99 %.1fus max %.1fus\n",
+            percentileUs(sorted, 50), percentileUs(sorted, 90), percentileUs(sorted, 99),
+            percentileUs(sorted, 100));
+    printf("  allocations: %.2f per request\n", (double) allocations / requests);
+    return 0;
+}
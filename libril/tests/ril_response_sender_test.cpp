@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <ril_response_sender.h>
+#include <telephony/ril.h>
+
+using android::hardware::Return;
+using android::hardware::Status;
+using android::hardware::Void;
+
+namespace {
+
+constexpr int kCalls = 500;
+
+// Longest a call waits for the gate before opening it, so a sender that runs calls inline
+// fails the test instead of hanging it
+constexpr std::chrono::seconds kGateTimeout(5);
+
+/**
+ * Stands in for the framework's IRadioResponse and records the order calls were made in.
+ * While held, a call blocks its caller until release(), like a binder transaction to a client
+ * that is not reading.
+ */
+struct FakeClient {
+    std::atomic<int> calls{0};
+    std::atomic<int> lastSerial{-1};
+    std::atomic<bool> outOfOrder{false};
+    std::atomic<bool> dead{false};
+
+    std::mutex gateLock;
+    std::condition_variable gate;
+    bool held = false;
+
+    Return<void> response(int serial) {
+        {
+            std::unique_lock<std::mutex> lock(gateLock);
+            if (!gate.wait_for(lock, kGateTimeout, [this]() { return !held; })) {
+                held = false;
+            }
+        }
+        if (lastSerial.exchange(serial) != serial - 1) {
+            outOfOrder = true;
+        }
+        calls++;
+        if (dead) {
+            return Status::fromExceptionCode(Status::EX_TRANSACTION_FAILED);
+        }
+        return Void();
+    }
+
+    void hold() {
+        std::lock_guard<std::mutex> lock(gateLock);
+        held = true;
+    }
+
+    void release() {
+        {
+            std::lock_guard<std::mutex> lock(gateLock);
+            held = false;
+        }
+        gate.notify_all();
+    }
+
+    void waitFor(int n) {
+        while (calls < n) {
+            usleep(1000);
+        }
+    }
+};
+
+std::atomic<int> s_failedCount{0};
+std::atomic<int32_t> s_failedCounter{-1};
+
+void onSendFailed(int slotId, int32_t counter) {
+    s_failedCount++;
+    s_failedCounter = counter;
+}
+
+class RilResponseSenderTest : public ::testing::Test {
+protected:
+    static void SetUpTestCase() {
+        android::ril_response_sender_start(1, onSendFailed);
+    }
+};
+
+TEST_F(RilResponseSenderTest, VendorThreadIsNotHeldByTheClient) {
+    FakeClient client;
+    client.hold();
+    for (int i = 0; i < kCalls; i++) {
+        android::ril_response_sender_queue(0, 0, [&client, i]() {
+            return client.response(i);
+        });
+    }
+
+    // Every call was queued while the client still blocks the first one
+    EXPECT_EQ(0, client.calls);
+
+    client.release();
+    client.waitFor(kCalls);
+    EXPECT_FALSE(client.outOfOrder);
+}
+
+TEST_F(RilResponseSenderTest, FailureReportsTheQueuedCounter) {
+    FakeClient client;
+    client.dead = true;
+    s_failedCount = 0;
+
+    android::ril_response_sender_queue(0, 7, [&client]() {
+        return client.response(0);
+    });
+    client.waitFor(1);
+    while (s_failedCount == 0) {
+        usleep(1000);
+    }
+    EXPECT_EQ(1, s_failedCount);
+    EXPECT_EQ(7, s_failedCounter);
+}
+
+TEST_F(RilResponseSenderTest, UnstartedSlotIsReported) {
+    EXPECT_TRUE(android::ril_response_sender_started(0));
+#if (SIM_COUNT >= 2)
+    EXPECT_FALSE(android::ril_response_sender_started(1));
+#endif
+}
+
+}   // namespace
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Replays a trace written by the RIL recorder (ro.ril.recorder_kb) through libril. Every
+ * recorded request is added to the pending list the way the IRadio methods add it, and
+ * every completion and unsolicited response goes back in through RIL_onRequestComplete()
+ * and RIL_onUnsolicitedResponse() with its payload unflattened, so they reach the
+ * s_commands and s_unsolResponses functions as they did on the device. No framework
+ * client is attached, so response functions stop where they would call IRadioResponse.
+ *
+ * Usage: ril_trace_replayer [-n passes] [-r] trace.bin
+ *   -n  replay the trace this many times
+ *   -r  keep the recorded gaps between records instead of replaying back to back
+ */
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <utility>
+#include <vector>
+
+#include <telephony/ril.h>
+#include <ril_internal.h>
+#include <ril_recorder.h>
+#include "fake_vendor_ril.h"
+
+#define TRACE_REPLAYER_SERVICE_NAME "play1"
+
+extern "C" char ril_service_name[MAX_SERVICE_NAME_LENGTH];
+extern "C" void RIL_startEventLoop(void);
+
+using android::RequestInfo;
+
+typedef struct ReplayStats {
+    uint64_t count;
+    uint64_t partial;           // payload missing or cut short, handed over as NULL
+    uint64_t busyNs;            // time spent inside libril
+} ReplayStats;
+
+static ReplayStats s_completeStats;
+static ReplayStats s_unsolStats;
+static uint64_t s_requestCount;
+static uint64_t s_orphanCount;
+
+// Requests that were handed to the vendor RIL and have not completed yet, by slot and serial
+static std::map<std::pair<int, int32_t>, RequestInfo *> s_pending;
+
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void onComplete(int32_t serial) {
+}
+
+static bool readTrace(const char *path, std::vector<uint64_t> *trace) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < (long) sizeof(android::RilRecorderHeader)) {
+        fprintf(stderr, "%s: too short for a trace\n", path);
+        fclose(f);
+        return false;
+    }
+
+    // uint64_t keeps the records 8 byte aligned, as they were in the ring
+    trace->resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    bool ok = fread(trace->data(), 1, size, f) == (size_t) size;
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "%s: read failed\n", path);
+        return false;
+    }
+
+    const android::RilRecorderHeader *header = (const android::RilRecorderHeader *) trace->data();
+    if (header->magic != RIL_RECORDER_MAGIC || header->version != RIL_RECORDER_VERSION) {
+        fprintf(stderr, "%s: not a version %d trace\n", path, RIL_RECORDER_VERSION);
+        return false;
+    }
+    if (header->pointerSize != sizeof(void *)) {
+        fprintf(stderr, "%s: recorded with %u byte pointers, this build has %zu\n", path,
+                header->pointerSize, sizeof(void *));
+        return false;
+    }
+    if (header->capacity > (uint64_t) size - sizeof(*header)
+            || header->capacity % sizeof(uint64_t) != 0 || header->tail > header->head
+            || header->head - header->tail > header->capacity) {
+        fprintf(stderr, "%s: ring does not match the file\n", path);
+        return false;
+    }
+    return true;
+}
+
+static void replayRecord(const android::RilRecorderHeader *header,
+        const android::RilRecord *record, std::vector<uint64_t> *payload) {
+    std::pair<int, int32_t> key(record->slot, record->token);
+    void *data = NULL;
+    size_t datalen = 0;
+    ReplayStats *stats = record->type == android::RIL_RECORD_COMPLETE ? &s_completeStats
+            : &s_unsolStats;
+
+    if (record->type == android::RIL_RECORD_REQUEST) {
+        RequestInfo *pRI = android::addRequestToList(record->token, record->slot, record->id);
+        if (pRI != NULL) {
+            s_pending[key] = pRI;
+            s_requestCount++;
+        }
+        return;
+    }
+
+    if (record->payloadLen > 0) {
+        payload->resize((record->payloadLen + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        memcpy(payload->data(), record + 1, record->payloadLen);
+        if (android::ril_recorder_unflatten(header, record, payload->data())) {
+            data = payload->data();
+            datalen = record->originalLen;
+        }
+    }
+    if (data == NULL && (record->flags & RIL_RECORD_PAYLOAD_PARTIAL)) {
+        stats->partial++;
+    }
+
+    uint64_t start = nowNs();
+    if (record->type == android::RIL_RECORD_COMPLETE) {
+        std::map<std::pair<int, int32_t>, RequestInfo *>::iterator it = s_pending.find(key);
+        RequestInfo *pRI;
+        if (it != s_pending.end()) {
+            pRI = it->second;
+            s_pending.erase(it);
+        } else {
+            // the request was recorded before the oldest record still in the ring
+            pRI = android::addRequestToList(record->token, record->slot, record->id);
+            s_orphanCount++;
+        }
+        if (pRI == NULL) {
+            return;
+        }
+        start = nowNs();
+        RIL_onRequestComplete(pRI, (RIL_Errno) record->error, data, datalen);
+    } else {
+#if defined(ANDROID_MULTI_SIM)
+        RIL_onUnsolicitedResponse(record->id, data, datalen, (RIL_SOCKET_ID) record->slot);
+#else
+        RIL_onUnsolicitedResponse(record->id, data, datalen);
+#endif
+    }
+    stats->busyNs += nowNs() - start;
+    stats->count++;
+}
+
+static void replay(const std::vector<uint64_t>& trace, bool realTime) {
+    const android::RilRecorderHeader *header = (const android::RilRecorderHeader *) trace.data();
+    const uint8_t *ring = (const uint8_t *) (header + 1);
+    std::vector<uint64_t> payload;
+    uint64_t firstTimestampNs = 0;
+    uint64_t startNs = nowNs();
+
+    for (uint64_t offset = header->tail; offset < header->head; ) {
+        const android::RilRecord *record =
+                (const android::RilRecord *) (ring + offset % header->capacity);
+        // padding can be shorter than a record, but always holds length and type
+        if (record->length < sizeof(uint64_t) || record->length % sizeof(uint64_t) != 0
+                || record->length > header->capacity - offset % header->capacity
+                || (record->type != android::RIL_RECORD_PAD
+                        && (record->length < sizeof(*record)
+                                || record->payloadLen > record->length - sizeof(*record)))) {
+            fprintf(stderr, "corrupt record at %" PRIu64 ", stopping\n", offset);
+            return;
+        }
+        offset += record->length;
+        if (record->type == android::RIL_RECORD_PAD || record->slot >= SIM_COUNT) {
+            continue;
+        }
+
+        if (realTime) {
+            if (firstTimestampNs == 0) {
+                firstTimestampNs = record->timestampNs;
+            }
+            uint64_t dueNs = startNs + (record->timestampNs - firstTimestampNs);
+            struct timespec due = { (time_t) (dueNs / 1000000000),
+                    (long) (dueNs % 1000000000) };
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) != 0) {
+            }
+        }
+        replayRecord(header, record, &payload);
+    }
+}
+
+static void printStats(const char *name, const ReplayStats& stats) {
+    printf("  %-14s %8" PRIu64 " (%" PRIu64 " without payload), %.2fus each in libril\n", name,
+            stats.count, stats.partial, stats.count > 0 ? stats.busyNs / 1e3 / stats.count : 0);
+}
+
+int main(int argc, char **argv) {
+    FakeVendorConfig config = {};
+    std::vector<uint64_t> trace;
+    int passes = 1;
+    bool realTime = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:r")) != -1) {
+        switch (opt) {
+            case 'n': passes = atoi(optarg); break;
+            case 'r': realTime = true; break;
+            default:
+                optind = argc;
+                break;
+        }
+    }
+    if (optind != argc - 1 || passes < 1) {
+        fprintf(stderr, "usage: %s [-n passes] [-r] trace.bin\n", argv[0]);
+        return 1;
+    }
+    if (!readTrace(argv[optind], &trace)) {
+        return 1;
+    }
+    config.version = ((const android::RilRecorderHeader *) trace.data())->rilVersion;
+
+    // Never take over the services of the real rild
+    strlcpy(ril_service_name, TRACE_REPLAYER_SERVICE_NAME, sizeof(ril_service_name));
+    // nor rotate the trace of the real rild, which is likely the one being replayed
+    android::ril_recorder_disable();
+    RIL_startEventLoop();
+    RIL_register(fake_vendor_ril_init(&config, onComplete));
+
+    uint64_t start = nowNs();
+    for (int i = 0; i < passes; i++) {
+        replay(trace, realTime);
+    }
+    uint64_t elapsed = nowNs() - start;
+
+    uint64_t records = s_completeStats.count + s_unsolStats.count;
+    printf("%d passes over %s\n", passes, argv[optind]);
+    printf("  %-14s %8" PRIu64 "\n", "requests", s_requestCount);
+    printStats("completions", s_completeStats);
+    printStats("unsolicited", s_unsolStats);
+    printf("  %" PRIu64 " completions without a recorded request\n", s_orphanCount);
+    printf("  %.0f records/s over %.1fms\n", elapsed > 0 ? records * 1e9 / elapsed : 0,
+            elapsed / 1e6);
+    return 0;
+}
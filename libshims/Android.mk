@@ -59,3 +59,25 @@ LOCAL_MODULE_TAGS := optional
 LOCAL_MODULE_CLASS := SHARED_LIBRARIES
 
 include $(BUILD_SHARED_LIBRARY)
+
+# VectorImpl sort benchmark
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+    tests/VectorImpl_benchmark.cpp \
+    utils/VectorImpl.cpp
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)/include \
+    system/core/libutils
+
+LOCAL_SHARED_LIBRARIES := \
+    libcutils \
+    libutils \
+    liblog
+
+LOCAL_MODULE := libshim_camera_VectorImpl_benchmark
+
+LOCAL_MODULE_TAGS := optional
+
+include $(BUILD_NATIVE_BENCHMARK)
@@ -2,6 +2,7 @@
 #include <sys/types.h>
 #include <dlfcn.h>
 #include <string.h>
+#include <utils/Looper.h>
 
 extern "C" {
   int property_get(const char * key, char * value, const char * default_value) {
@@ -12,4 +13,9 @@ extern "C" {
 
     return ((int( * )(const char * , char *, const char * ))(dlsym((void * ) - 1, "property_get")))(key, value, default_value);
   }
+
+  // Resolved by the camera wrapper from its dump(fd) hook
+  void looper_shim_dump(int fd) {
+    android::Looper::dumpAll(fd);
+  }
 }
@@ -138,6 +138,7 @@ private:
 class Looper : public RefBase {
 protected:
     virtual ~Looper();
+    virtual void onFirstRef();
 
 public:
     enum {
@@ -395,6 +396,21 @@ public:
      */
     bool isPolling() const;
 
+    /**
+     * Writes this looper's counters to the given file descriptor: wakes, epoll
+     * events per poll, epoll set rebuilds, message queue depth and a duration
+     * histogram for each message handler and fd callback it has invoked.
+     *
+     * This method can be called on any thread.
+     */
+    void dump(int fd);
+
+    /**
+     * Writes the counters of every live looper in the process to the given file
+     * descriptor.  Meant for a HAL's dump(fd) path.
+     */
+    static void dumpAll(int fd);
+
     /**
      * Prepares a looper associated with the calling thread, and returns it.
      * If the thread already has a looper, it is returned.  Otherwise, a new
@@ -419,6 +435,10 @@ public:
     static sp<Looper> getForThread();
 
 private:
+    // Everything the looper keeps beyond the members below.  Prebuilt blobs are linked
+    // against this class, so its size and member offsets must not change; see Looper.cpp.
+    struct State;
+
     struct Request {
         int fd;
         int ident;
@@ -427,6 +447,8 @@ private:
         sp<LooperCallback> callback;
         void* data;
 
+        Request() : fd(-1), ident(0), events(0), seq(0), data(nullptr) { }
+
         void initEventItem(struct epoll_event* eventItem) const;
     };
 
@@ -436,14 +458,20 @@ private:
     };
 
     struct MessageEnvelope {
-        MessageEnvelope() : uptime(0) { }
+        MessageEnvelope() : uptime(0), seq(0) { }
 
         MessageEnvelope(nsecs_t u, const sp<MessageHandler> h,
-                const Message& m) : uptime(u), handler(h), message(m) {
+                const Message& m) : uptime(u), seq(0), handler(h), message(m) {
+        }
+
+        // Messages due at the same time are delivered in the order they were sent.
+        bool before(const MessageEnvelope& other) const {
+            return uptime < other.uptime || (uptime == other.uptime && seq < other.seq);
         }
 
         nsecs_t uptime;
-        sp<MessageHandler> handler;
+        uint64_t seq;
+        sp<MessageHandler> handler; // null once removed, until the envelope is discarded
         Message message;
     };
 
@@ -452,6 +480,8 @@ private:
     android::base::unique_fd mWakeEventFd;  // immutable
     Mutex mLock;
 
+    // Binary min-heap ordered by MessageEnvelope::before().  Removed messages stay in
+    // place with a null handler until they reach the top or the heap is compacted.
     Vector<MessageEnvelope> mMessageEnvelopes; // guarded by mLock
     bool mSendingMessage; // guarded by mLock
 
@@ -462,8 +492,8 @@ private:
     android::base::unique_fd mEpollFd;  // guarded by mLock but only modified on the looper thread
     bool mEpollRebuildRequired; // guarded by mLock
 
-    // Locked list of file descriptor monitoring requests.
-    KeyedVector<int, Request> mRequests;  // guarded by mLock
+    // Unused, file descriptor requests are indexed by fd in State::requests.
+    KeyedVector<int, Request> mRequests;
     int mNextRequestSeq;
 
     // This state is only used privately by pollOnce and does not require a lock since
@@ -472,12 +502,20 @@ private:
     size_t mResponseIndex;
     nsecs_t mNextMessageUptime; // set to LLONG_MAX when none
 
+    State& state() const;
     int pollInner(int timeoutMillis);
     int removeFd(int fd, int seq);
-    void awoken();
+    void awoken(State& state);
     void pushResponse(int events, const Request& request);
-    void rebuildEpollLocked();
+    ssize_t indexOfRequestLocked(const State& state, int fd) const;
+    void setRequestLocked(State& state, int fd, const Request& request);
+    void rebuildEpollLocked(State& state);
     void scheduleEpollRebuildLocked();
+    void siftUpMessageLocked(size_t index);
+    void siftDownMessageLocked(size_t index);
+    void popMessageLocked(State& state);
+    void pruneMessagesLocked(State& state);
+    void removeMessageAtLocked(State& state, size_t index);
 
     static void initTLSKey();
     static void threadDestructor(void *st);
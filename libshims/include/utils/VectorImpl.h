@@ -118,6 +118,11 @@ protected:
 private:
         void* _grow(size_t where, size_t amount);
         void  _shrink(size_t where, size_t amount);
+        bool  _merge_sort(compar_r_t cmp, void* state);
+        void  _insertion_sort_run(void* array, size_t from, size_t to, void* temp,
+                                  compar_r_t cmp, void* state) const;
+        void  _merge_pass(void* dest, void* from, size_t count, size_t width,
+                          compar_r_t cmp, void* state) const;
 
         inline void _do_construct(void* storage, size_t num) const;
         inline void _do_destroy(void* storage, size_t num) const;
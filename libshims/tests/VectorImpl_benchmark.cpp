@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Benchmarks VectorImpl::sort() from the shim, built into this binary,
+ * for an item type that is moved with memcpy and one that has to go
+ * through its copy constructor and destructor. Runs up to 32 items are
+ * insertion sorted, longer ones are merge sorted.
+ */
+
+#include <utils/VectorImpl.h>
+
+#include <benchmark/benchmark.h>
+
+#include <new>
+#include <random>
+#include <string>
+
+using android::VectorImpl;
+
+namespace {
+
+struct TrivialItem {
+    int32_t key;
+    int32_t seq;
+};
+
+struct StringItem {
+    int32_t key;
+    int32_t seq;
+    std::string name;
+};
+
+/*
+ * The subset of Vector<T> that sort() needs, with the traits given
+ * explicitly instead of through TypeHelpers.
+ */
+template <typename T, uint32_t FLAGS>
+class SortVector : public VectorImpl {
+public:
+    SortVector() : VectorImpl(sizeof(T), FLAGS) { }
+    virtual ~SortVector() { finish_vector(); }
+
+    void add(const T& item) { VectorImpl::add(&item); }
+
+protected:
+    virtual void do_construct(void* storage, size_t num) const {
+        T* p = static_cast<T*>(storage);
+        while (num--) new (p++) T();
+    }
+    virtual void do_destroy(void* storage, size_t num) const {
+        T* p = static_cast<T*>(storage);
+        while (num--) (p++)->~T();
+    }
+    virtual void do_copy(void* dest, const void* from, size_t num) const {
+        T* d = static_cast<T*>(dest);
+        const T* s = static_cast<const T*>(from);
+        while (num--) new (d++) T(*s++);
+    }
+    virtual void do_splat(void* dest, const void* item, size_t num) const {
+        T* d = static_cast<T*>(dest);
+        while (num--) new (d++) T(*static_cast<const T*>(item));
+    }
+    virtual void do_move_forward(void* dest, const void* from, size_t num) const {
+        T* d = static_cast<T*>(dest) + num;
+        const T* s = static_cast<const T*>(from) + num;
+        while (num--) {
+            new (--d) T(*--s);
+            s->~T();
+        }
+    }
+    virtual void do_move_backward(void* dest, const void* from, size_t num) const {
+        T* d = static_cast<T*>(dest);
+        const T* s = static_cast<const T*>(from);
+        while (num--) {
+            new (d++) T(*s);
+            (s++)->~T();
+        }
+    }
+};
+
+typedef SortVector<TrivialItem, VectorImpl::HAS_TRIVIAL_CTOR | VectorImpl::HAS_TRIVIAL_DTOR |
+        VectorImpl::HAS_TRIVIAL_COPY> TrivialVector;
+typedef SortVector<StringItem, 0> StringVector;
+
+template <typename T>
+int compareKeys(const void* lhs, const void* rhs) {
+    int32_t l = static_cast<const T*>(lhs)->key;
+    int32_t r = static_cast<const T*>(rhs)->key;
+    return l < r ? -1 : (l > r ? 1 : 0);
+}
+
+TrivialItem makeItem(TrivialItem*, int32_t key, int32_t seq) {
+    return TrivialItem{key, seq};
+}
+
+StringItem makeItem(StringItem*, int32_t key, int32_t seq) {
+    // Long enough to stay out of the small string buffer, so copies allocate.
+    return StringItem{key, seq, std::string(40, 'a' + seq % 26)};
+}
+
+enum Order { RANDOM, SORTED };
+
+template <typename T, typename V>
+void BM_VectorImpl_sort(benchmark::State& state, Order order) {
+    const size_t count = state.range(0);
+    std::mt19937 rng(count);
+    V source;
+    for (size_t i = 0; i < count; i++) {
+        int32_t key = order == SORTED ? int32_t(i) : int32_t(rng() % 1000000);
+        source.add(makeItem(static_cast<T*>(nullptr), key, int32_t(i)));
+    }
+
+    V v;
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        v.clear();
+        v.appendVector(source);
+        state.ResumeTiming();
+
+        v.sort(compareKeys<T>);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_VectorImpl_sort_trivial_random(benchmark::State& state) {
+    BM_VectorImpl_sort<TrivialItem, TrivialVector>(state, RANDOM);
+}
+BENCHMARK(BM_VectorImpl_sort_trivial_random)->RangeMultiplier(8)->Range(8, 32 << 10);
+
+void BM_VectorImpl_sort_trivial_sorted(benchmark::State& state) {
+    BM_VectorImpl_sort<TrivialItem, TrivialVector>(state, SORTED);
+}
+BENCHMARK(BM_VectorImpl_sort_trivial_sorted)->RangeMultiplier(8)->Range(8, 32 << 10);
+
+void BM_VectorImpl_sort_string_random(benchmark::State& state) {
+    BM_VectorImpl_sort<StringItem, StringVector>(state, RANDOM);
+}
+BENCHMARK(BM_VectorImpl_sort_string_random)->RangeMultiplier(8)->Range(8, 32 << 10);
+
+void BM_VectorImpl_sort_string_sorted(benchmark::State& state) {
+    BM_VectorImpl_sort<StringItem, StringVector>(state, SORTED);
+}
+BENCHMARK(BM_VectorImpl_sort_string_sorted)->RangeMultiplier(8)->Range(8, 32 << 10);
+
+} // namespace
+
+BENCHMARK_MAIN();
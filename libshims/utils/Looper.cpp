@@ -14,8 +14,14 @@
 #define DEBUG_CALLBACKS 0
 
 #include <utils/Looper.h>
+#include <utils/RWLock.h>
 #include <sys/eventfd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <inttypes.h>
+#include <stdio.h>
+
 namespace android {
 
 // --- WeakMessageHandler ---
@@ -54,9 +60,114 @@ int SimpleLooperCallback::handleEvent(int fd, int events, void* data) {
 // Maximum number of file descriptors for which to retrieve poll events each iteration.
 static const int EPOLL_MAX_EVENTS = 16;
 
+// Most callbacks whose durations are tracked separately by each looper.
+static const size_t MAX_CALLBACK_STATS = 32;
+
+// Histogram sizes for dump(); the last bucket of each is open ended.
+static const size_t POLL_EVENT_BUCKETS = 6;
+static const size_t CALLBACK_TIME_BUCKETS = 9;
+
+// Upper bounds of the epoll events per poll histogram buckets.
+static const int POLL_EVENT_BOUNDS[] = { 0, 1, 2, 4, 8 };
+static const char* const POLL_EVENT_LABELS[] = { "0", "1", "2", "3-4", "5-8", "9+" };
+
+// Upper bounds of the callback duration histogram buckets.
+static const nsecs_t CALLBACK_TIME_BOUNDS[] = {
+    us2ns(100), us2ns(500), ms2ns(1), ms2ns(4), ms2ns(8), ms2ns(16), ms2ns(33), ms2ns(100),
+};
+static const char* const CALLBACK_TIME_LABELS[] = {
+    "<100us", "<500us", "<1ms", "<4ms", "<8ms", "<16ms", "<33ms", "<100ms", ">=100ms",
+};
+
 static pthread_once_t gTLSOnce = PTHREAD_ONCE_INIT;
 static pthread_key_t gTLSKey = 0;
 
+// libshim_camera interposes this Looper into camera.vendor.qcom.so, which was built
+// against the original class, so sizeof(Looper) and its member offsets have to stay
+// as they were.  Whatever the looper needs on top of those members lives here
+// instead, one per looper, created with it and found again through its address.
+struct Looper::State {
+    struct CallbackStats {
+        CallbackStats() : address(nullptr), isMessageHandler(false), lastUsed(0), count(0),
+                totalTime(0), maxTime(0), buckets() { }
+
+        wp<RefBase> callback; // keeps the key from being reused while the entry exists
+        const void* address;
+        bool isMessageHandler;
+        uint64_t lastUsed;
+        uint64_t count;
+        nsecs_t totalTime;
+        nsecs_t maxTime;
+        uint64_t buckets[CALLBACK_TIME_BUCKETS];
+    };
+
+    // Due messages moved out of the heap and being sent without the lock held.  Each
+    // pollInner() call sends its own batch from its stack, so a handler that polls the
+    // looper again stacks a new batch on top instead of touching the one it came from.
+    // The looper owns the envelopes below claimed; removeMessages() may cancel the rest
+    // under mLock after bumping messageRemovals, which the looper checks before each one.
+    struct MessageBatch {
+        MessageBatch() : claimed(0), outer(nullptr) { }
+
+        Vector<MessageEnvelope> envelopes;
+        std::atomic<size_t> claimed;
+        MessageBatch* outer; // batch of the pollInner() call this one is nested in
+    };
+
+    State() : removedMessageCount(0), nextMessageSeq(0), messageBatch(nullptr),
+            messageRemovals(0), requestCount(0), pollCount(0), pollEventCounts(),
+            wakeCount(0), wakeSignalCount(0), epollRebuildCount(0),
+            messageQueueHighWater(0), statsClock(0) { }
+
+    void recordCallbackTime(MessageHandler* handler, nsecs_t duration) {
+        recordCallbackTime(handler, handler, true, duration);
+    }
+
+    void recordCallbackTime(LooperCallback* callback, nsecs_t duration) {
+        recordCallbackTime(callback, callback, false, duration);
+    }
+
+    void recordCallbackTime(const void* address, RefBase* callback, bool isMessageHandler,
+            nsecs_t duration);
+
+    size_t removedMessageCount; // guarded by mLock
+    uint64_t nextMessageSeq; // guarded by mLock
+
+    MessageBatch* messageBatch; // innermost batch being sent; guarded by mLock
+    std::atomic<uint32_t> messageRemovals;
+
+    // Table of file descriptor monitoring requests indexed by fd.
+    // Unused slots have a request fd of -1.
+    Vector<Request> requests; // guarded by mLock
+    size_t requestCount; // guarded by mLock
+
+    // Counters reported by dump().
+    uint64_t pollCount; // guarded by mLock
+    uint64_t pollEventCounts[POLL_EVENT_BUCKETS]; // guarded by mLock
+    uint64_t wakeCount; // times awoken() drained mWakeEventFd; guarded by mLock
+    uint64_t wakeSignalCount; // wake() calls folded into those wakes; guarded by mLock
+    uint64_t epollRebuildCount; // guarded by mLock
+    size_t messageQueueHighWater; // guarded by mLock
+
+    // Callbacks run without mLock held, so their timings have a lock of their own.
+    // Keyed by the weak reference object of the MessageHandler or LooperCallback, which
+    // the entry holds on to, so a callback allocated where a destroyed one was gets an
+    // entry of its own.  Once the table is full the least recently used entry is folded
+    // into the nullptr one.
+    Mutex statsLock;
+    KeyedVector<const void*, CallbackStats> callbackStats; // guarded by statsLock
+    uint64_t statsClock; // guarded by statsLock
+
+    // Set once the looper has a strong reference, for dumpAll() to promote.
+    wp<Looper> looper; // guarded by sLock
+
+    static RWLock sLock;
+    static KeyedVector<const Looper*, State*> sStates; // guarded by sLock
+};
+
+RWLock Looper::State::sLock;
+KeyedVector<const Looper*, Looper::State*> Looper::State::sStates;
+
 Looper::Looper(bool allowNonCallbacks)
     : mAllowNonCallbacks(allowNonCallbacks),
       mSendingMessage(false),
@@ -68,11 +179,36 @@ Looper::Looper(bool allowNonCallbacks)
     mWakeEventFd.reset(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
     LOG_ALWAYS_FATAL_IF(mWakeEventFd.get() < 0, "Could not make wake event fd: %s", strerror(errno));
 
+    State* state = new State();
+    { // acquire lock
+        RWLock::AutoWLock _l(State::sLock);
+        State::sStates.add(this, state);
+    } // release lock
+
     AutoMutex _l(mLock);
-    rebuildEpollLocked();
+    rebuildEpollLocked(*state);
 }
 
 Looper::~Looper() {
+    State* state;
+    { // acquire lock
+        RWLock::AutoWLock _l(State::sLock);
+        ssize_t index = State::sStates.indexOfKey(this);
+        state = State::sStates.valueAt(index);
+        State::sStates.removeItemsAt(index);
+    } // release lock
+    delete state;
+}
+
+void Looper::onFirstRef() {
+    // Promoting a looper nobody holds yet would destroy it when dumpAll() lets go.
+    RWLock::AutoWLock _l(State::sLock);
+    State::sStates.valueFor(this)->looper = this;
+}
+
+Looper::State& Looper::state() const {
+    RWLock::AutoRLock _l(State::sLock);
+    return *State::sStates.valueFor(this);
 }
 
 void Looper::initTLSKey() {
@@ -126,13 +262,14 @@ bool Looper::getAllowNonCallbacks() const {
     return mAllowNonCallbacks;
 }
 
-void Looper::rebuildEpollLocked() {
+void Looper::rebuildEpollLocked(State& state) {
     // Close old epoll instance if we have one.
     if (mEpollFd >= 0) {
 #if DEBUG_CALLBACKS
         ALOGD("%p ~ rebuildEpollLocked - rebuilding epoll set", this);
 #endif
         mEpollFd.reset();
+        state.epollRebuildCount += 1;
     }
 
     // Allocate the new epoll instance and register the wake pipe.
@@ -147,8 +284,13 @@ void Looper::rebuildEpollLocked() {
     LOG_ALWAYS_FATAL_IF(result != 0, "Could not add wake event fd to epoll instance: %s",
                         strerror(errno));
 
-    for (size_t i = 0; i < mRequests.size(); i++) {
-        const Request& request = mRequests.valueAt(i);
+    size_t requestsLeft = state.requestCount;
+    for (size_t i = 0; requestsLeft > 0 && i < state.requests.size(); i++) {
+        const Request& request = state.requests.itemAt(i);
+        if (request.fd < 0) {
+            continue;
+        }
+        requestsLeft -= 1;
         struct epoll_event eventItem;
         request.initEventItem(&eventItem);
 
@@ -211,6 +353,8 @@ int Looper::pollInner(int timeoutMillis) {
     ALOGD("%p ~ pollOnce - waiting: timeoutMillis=%d", this, timeoutMillis);
 #endif
 
+    State& state = this->state();
+
     // Adjust the timeout based on when the next message is due.
     if (timeoutMillis != 0 && mNextMessageUptime != LLONG_MAX) {
         nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
@@ -242,10 +386,19 @@ int Looper::pollInner(int timeoutMillis) {
     // Acquire lock.
     mLock.lock();
 
+    state.pollCount += 1;
+    if (eventCount >= 0) {
+        size_t bucket = 0;
+        while (bucket < POLL_EVENT_BUCKETS - 1 && eventCount > POLL_EVENT_BOUNDS[bucket]) {
+            bucket += 1;
+        }
+        state.pollEventCounts[bucket] += 1;
+    }
+
     // Rebuild epoll set if needed.
     if (mEpollRebuildRequired) {
         mEpollRebuildRequired = false;
-        rebuildEpollLocked();
+        rebuildEpollLocked(state);
         goto Done;
     }
 
@@ -278,19 +431,19 @@ int Looper::pollInner(int timeoutMillis) {
         uint32_t epollEvents = eventItems[i].events;
         if (fd == mWakeEventFd.get()) {
             if (epollEvents & EPOLLIN) {
-                awoken();
+                awoken(state);
             } else {
                 ALOGW("Ignoring unexpected epoll events 0x%x on wake event fd.", epollEvents);
             }
         } else {
-            ssize_t requestIndex = mRequests.indexOfKey(fd);
+            ssize_t requestIndex = indexOfRequestLocked(state, fd);
             if (requestIndex >= 0) {
                 int events = 0;
                 if (epollEvents & EPOLLIN) events |= EVENT_INPUT;
                 if (epollEvents & EPOLLOUT) events |= EVENT_OUTPUT;
                 if (epollEvents & EPOLLERR) events |= EVENT_ERROR;
                 if (epollEvents & EPOLLHUP) events |= EVENT_HANGUP;
-                pushResponse(events, mRequests.valueAt(requestIndex));
+                pushResponse(events, state.requests.itemAt(requestIndex));
             } else {
                 ALOGW("Ignoring unexpected epoll events 0x%x on fd %d that is "
                         "no longer registered.", epollEvents, fd);
@@ -301,36 +454,67 @@ Done: ;
 
     // Invoke pending message callbacks.
     mNextMessageUptime = LLONG_MAX;
-    while (mMessageEnvelopes.size() != 0) {
+    for (;;) {
+        pruneMessagesLocked(state);
+        if (mMessageEnvelopes.size() == 0) {
+            break;
+        }
         nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
-        const MessageEnvelope& messageEnvelope = mMessageEnvelopes.itemAt(0);
-        if (messageEnvelope.uptime <= now) {
-            // Remove the envelope from the list.
+        if (mMessageEnvelopes.itemAt(0).uptime > now) {
+            // The last message left at the head of the queue determines the next wakeup time.
+            mNextMessageUptime = mMessageEnvelopes.itemAt(0).uptime;
+            break;
+        }
+
+        // Move every message that is due into the batch under this one lock hold.
+        State::MessageBatch batch;
+        do {
+            batch.envelopes.add(mMessageEnvelopes.itemAt(0));
+            popMessageLocked(state);
+            pruneMessagesLocked(state);
+        } while (mMessageEnvelopes.size() != 0 && mMessageEnvelopes.itemAt(0).uptime <= now);
+        batch.outer = state.messageBatch;
+        state.messageBatch = &batch;
+
+        size_t batchSize = batch.envelopes.size();
+        uint32_t removals = state.messageRemovals.load();
+        mSendingMessage = true;
+        mLock.unlock();
+
+        for (size_t i = 0; i < batchSize; i++) {
+            // Claim the envelope first so removeMessages() leaves it alone.  If a removal
+            // started before the claim, wait for it to finish before looking at the handler.
+            batch.claimed.store(i + 1);
+            if (state.messageRemovals.load() != removals) {
+                AutoMutex _l(mLock);
+                removals = state.messageRemovals.load();
+            }
+            if (batch.envelopes.itemAt(i).handler == nullptr) {
+                continue; // cancelled by removeMessages()
+            }
+
             // We keep a strong reference to the handler until the call to handleMessage
-            // finishes.  Then we drop it so that the handler can be deleted *before*
-            // we reacquire our lock.
+            // finishes.  Then we drop it so that the handler can be deleted before the
+            // next message is sent.
+            MessageEnvelope& messageEnvelope = batch.envelopes.editItemAt(i);
             { // obtain handler
                 sp<MessageHandler> handler = messageEnvelope.handler;
-                Message message = messageEnvelope.message;
-                mMessageEnvelopes.removeAt(0);
-                mSendingMessage = true;
-                mLock.unlock();
+                messageEnvelope.handler.clear();
 
 #if DEBUG_POLL_AND_WAKE || DEBUG_CALLBACKS
                 ALOGD("%p ~ pollOnce - sending message: handler=%p, what=%d",
-                        this, handler.get(), message.what);
+                        this, handler.get(), messageEnvelope.message.what);
 #endif
-                handler->handleMessage(message);
+                nsecs_t start = systemTime(SYSTEM_TIME_MONOTONIC);
+                handler->handleMessage(messageEnvelope.message);
+                state.recordCallbackTime(handler.get(), systemTime(SYSTEM_TIME_MONOTONIC) - start);
             } // release handler
-
-            mLock.lock();
-            mSendingMessage = false;
-            result = POLL_CALLBACK;
-        } else {
-            // The last message left at the head of the queue determines the next wakeup time.
-            mNextMessageUptime = messageEnvelope.uptime;
-            break;
         }
+
+        mLock.lock();
+        state.messageBatch = batch.outer;
+        mSendingMessage = batch.outer != nullptr; // still sending if this poll was nested
+        result = POLL_CALLBACK;
     }
 
     // Release lock.
@@ -350,7 +534,10 @@ Done: ;
             // Invoke the callback.  Note that the file descriptor may be closed by
             // the callback (and potentially even reused) before the function returns so
             // we need to be a little careful when removing the file descriptor afterwards.
+            nsecs_t start = systemTime(SYSTEM_TIME_MONOTONIC);
             int callbackResult = response.request.callback->handleEvent(fd, events, data);
+            state.recordCallbackTime(response.request.callback.get(),
+                    systemTime(SYSTEM_TIME_MONOTONIC) - start);
             if (callbackResult == 0) {
                 removeFd(fd, response.request.seq);
             }
@@ -405,13 +592,17 @@ void Looper::wake() {
     }
 }
 
-void Looper::awoken() {
+void Looper::awoken(State& state) {
 #if DEBUG_POLL_AND_WAKE
     ALOGD("%p ~ awoken", this);
 #endif
 
     uint64_t counter;
-    TEMP_FAILURE_RETRY(read(mWakeEventFd.get(), &counter, sizeof(uint64_t)));
+    if (TEMP_FAILURE_RETRY(read(mWakeEventFd.get(), &counter, sizeof(uint64_t)))
+            == sizeof(uint64_t)) {
+        state.wakeCount += 1;
+        state.wakeSignalCount += counter;
+    }
 }
 
 void Looper::pushResponse(int events, const Request& request) {
@@ -421,6 +612,27 @@ void Looper::pushResponse(int events, const Request& request) {
     mResponses.push(response);
 }
 
+ssize_t Looper::indexOfRequestLocked(const State& state, int fd) const {
+    if (fd < 0 || size_t(fd) >= state.requests.size() || state.requests.itemAt(fd).fd != fd) {
+        return -1;
+    }
+    return fd;
+}
+
+void Looper::setRequestLocked(State& state, int fd, const Request& request) {
+    if (size_t(fd) >= state.requests.size()) {
+        // Grow to cover the new fd; Vector keeps some slack so that registering
+        // increasing fds doesn't reallocate every time.
+        state.requests.insertAt(Request(), state.requests.size(),
+                size_t(fd) + 1 - state.requests.size());
+    }
+    Request& slot = state.requests.editItemAt(fd);
+    if (slot.fd < 0) {
+        state.requestCount += 1;
+    }
+    slot = request;
+}
+
 int Looper::addFd(int fd, int ident, int events, Looper_callbackFunc callback, void* data) {
     return addFd(fd, ident, events, callback ? new SimpleLooperCallback(callback) : nullptr, data);
 }
@@ -445,6 +657,7 @@ int Looper::addFd(int fd, int ident, int events, const sp<LooperCallback>& callb
         ident = POLL_CALLBACK;
     }
 
+    State& state = this->state();
     { // acquire lock
         AutoMutex _l(mLock);
 
@@ -460,14 +673,14 @@ int Looper::addFd(int fd, int ident, int events, const sp<LooperCallback>& callb
         struct epoll_event eventItem;
         request.initEventItem(&eventItem);
 
-        ssize_t requestIndex = mRequests.indexOfKey(fd);
+        ssize_t requestIndex = indexOfRequestLocked(state, fd);
         if (requestIndex < 0) {
             int epollResult = epoll_ctl(mEpollFd.get(), EPOLL_CTL_ADD, fd, &eventItem);
             if (epollResult < 0) {
                 ALOGE("Error adding epoll events for fd %d: %s", fd, strerror(errno));
                 return -1;
             }
-            mRequests.add(fd, request);
+            setRequestLocked(state, fd, request);
         } else {
             int epollResult = epoll_ctl(mEpollFd.get(), EPOLL_CTL_MOD, fd, &eventItem);
             if (epollResult < 0) {
@@ -502,7 +715,7 @@ int Looper::addFd(int fd, int ident, int events, const sp<LooperCallback>& callb
                     return -1;
                 }
             }
-            mRequests.replaceValueAt(requestIndex, request);
+            setRequestLocked(state, fd, request);
         }
     } // release lock
     return 1;
@@ -517,25 +730,27 @@ int Looper::removeFd(int fd, int seq) {
     ALOGD("%p ~ removeFd - fd=%d, seq=%d", this, fd, seq);
 #endif
 
+    State& state = this->state();
     { // acquire lock
         AutoMutex _l(mLock);
-        ssize_t requestIndex = mRequests.indexOfKey(fd);
+        ssize_t requestIndex = indexOfRequestLocked(state, fd);
         if (requestIndex < 0) {
             return 0;
         }
 
         // Check the sequence number if one was given.
-        if (seq != -1 && mRequests.valueAt(requestIndex).seq != seq) {
+        if (seq != -1 && state.requests.itemAt(requestIndex).seq != seq) {
 #if DEBUG_CALLBACKS
             ALOGD("%p ~ removeFd - sequence number mismatch, oldSeq=%d",
-                    this, mRequests.valueAt(requestIndex).seq);
+                    this, state.requests.itemAt(requestIndex).seq);
 #endif
             return 0;
         }
 
         // Always remove the FD from the request map even if an error occurs while
         // updating the epoll set so that we avoid accidentally leaking callbacks.
-        mRequests.removeItemsAt(requestIndex);
+        state.requests.editItemAt(requestIndex) = Request();
+        state.requestCount -= 1;
 
         int epollResult = epoll_ctl(mEpollFd.get(), EPOLL_CTL_DEL, fd, nullptr);
         if (epollResult < 0) {
@@ -588,17 +803,20 @@ void Looper::sendMessageAtTime(nsecs_t uptime, const sp<MessageHandler>& handler
             this, uptime, handler.get(), message.what);
 #endif
 
-    size_t i = 0;
+    State& state = this->state();
+    bool atHead;
     { // acquire lock
         AutoMutex _l(mLock);
 
-        size_t messageCount = mMessageEnvelopes.size();
-        while (i < messageCount && uptime >= mMessageEnvelopes.itemAt(i).uptime) {
-            i += 1;
-        }
-
         MessageEnvelope messageEnvelope(uptime, handler, message);
-        mMessageEnvelopes.insertAt(messageEnvelope, i, 1);
+        messageEnvelope.seq = state.nextMessageSeq++;
+        siftUpMessageLocked(mMessageEnvelopes.add(messageEnvelope));
+        atHead = mMessageEnvelopes.itemAt(0).seq == messageEnvelope.seq;
+
+        size_t depth = mMessageEnvelopes.size() - state.removedMessageCount;
+        if (depth > state.messageQueueHighWater) {
+            state.messageQueueHighWater = depth;
+        }
 
         // Optimization: If the Looper is currently sending a message, then we can skip
         // the call to wake() because the next thing the Looper will do after processing
@@ -610,7 +828,7 @@ void Looper::sendMessageAtTime(nsecs_t uptime, const sp<MessageHandler>& handler
     } // release lock
 
     // Wake the poll loop only when we enqueue a new message at the head.
-    if (i == 0) {
+    if (atHead) {
         wake();
     }
 }
@@ -620,13 +838,26 @@ void Looper::removeMessages(const sp<MessageHandler>& handler) {
     ALOGD("%p ~ removeMessages - handler=%p", this, handler.get());
 #endif
 
+    State& state = this->state();
     { // acquire lock
         AutoMutex _l(mLock);
 
-        for (size_t i = mMessageEnvelopes.size(); i != 0; ) {
-            const MessageEnvelope& messageEnvelope = mMessageEnvelopes.itemAt(--i);
+        for (size_t i = 0; i < mMessageEnvelopes.size(); i++) {
+            const MessageEnvelope& messageEnvelope = mMessageEnvelopes.itemAt(i);
             if (messageEnvelope.handler == handler) {
-                mMessageEnvelopes.removeAt(i);
+                removeMessageAtLocked(state, i);
+            }
+        }
+        pruneMessagesLocked(state);
+
+        // Cancel matching messages the looper has batched but not yet claimed.
+        state.messageRemovals.fetch_add(1);
+        for (State::MessageBatch* batch = state.messageBatch; batch; batch = batch->outer) {
+            for (size_t i = batch->claimed.load(); i < batch->envelopes.size(); i++) {
+                const MessageEnvelope& messageEnvelope = batch->envelopes.itemAt(i);
+                if (messageEnvelope.handler == handler) {
+                    batch->envelopes.editItemAt(i).handler.clear();
+                }
             }
         }
     } // release lock
@@ -637,23 +868,242 @@ void Looper::removeMessages(const sp<MessageHandler>& handler, int what) {
     ALOGD("%p ~ removeMessages - handler=%p, what=%d", this, handler.get(), what);
 #endif
 
+    State& state = this->state();
     { // acquire lock
         AutoMutex _l(mLock);
 
-        for (size_t i = mMessageEnvelopes.size(); i != 0; ) {
-            const MessageEnvelope& messageEnvelope = mMessageEnvelopes.itemAt(--i);
+        for (size_t i = 0; i < mMessageEnvelopes.size(); i++) {
+            const MessageEnvelope& messageEnvelope = mMessageEnvelopes.itemAt(i);
             if (messageEnvelope.handler == handler
                     && messageEnvelope.message.what == what) {
-                mMessageEnvelopes.removeAt(i);
+                removeMessageAtLocked(state, i);
+            }
+        }
+        pruneMessagesLocked(state);
+
+        // Cancel matching messages the looper has batched but not yet claimed.
+        state.messageRemovals.fetch_add(1);
+        for (State::MessageBatch* batch = state.messageBatch; batch; batch = batch->outer) {
+            for (size_t i = batch->claimed.load(); i < batch->envelopes.size(); i++) {
+                const MessageEnvelope& messageEnvelope = batch->envelopes.itemAt(i);
+                if (messageEnvelope.handler == handler
+                        && messageEnvelope.message.what == what) {
+                    batch->envelopes.editItemAt(i).handler.clear();
+                }
             }
         }
     } // release lock
 }
 
+void Looper::siftUpMessageLocked(size_t index) {
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!mMessageEnvelopes.itemAt(index).before(mMessageEnvelopes.itemAt(parent))) {
+            break;
+        }
+        std::swap(mMessageEnvelopes.editItemAt(index), mMessageEnvelopes.editItemAt(parent));
+        index = parent;
+    }
+}
+
+void Looper::siftDownMessageLocked(size_t index) {
+    size_t count = mMessageEnvelopes.size();
+    for (;;) {
+        size_t smallest = index;
+        size_t left = index * 2 + 1;
+        size_t right = left + 1;
+        if (left < count
+                && mMessageEnvelopes.itemAt(left).before(mMessageEnvelopes.itemAt(smallest))) {
+            smallest = left;
+        }
+        if (right < count
+                && mMessageEnvelopes.itemAt(right).before(mMessageEnvelopes.itemAt(smallest))) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            break;
+        }
+        std::swap(mMessageEnvelopes.editItemAt(index), mMessageEnvelopes.editItemAt(smallest));
+        index = smallest;
+    }
+}
+
+void Looper::popMessageLocked(State& state) {
+    size_t last = mMessageEnvelopes.size() - 1;
+    if (mMessageEnvelopes.itemAt(0).handler == nullptr) {
+        state.removedMessageCount -= 1;
+    }
+    if (last > 0) {
+        std::swap(mMessageEnvelopes.editItemAt(0), mMessageEnvelopes.editItemAt(last));
+    }
+    mMessageEnvelopes.removeAt(last);
+    siftDownMessageLocked(0);
+}
+
+void Looper::removeMessageAtLocked(State& state, size_t index) {
+    // Drop the handler now so it can be destroyed; the envelope itself goes lazily.
+    mMessageEnvelopes.editItemAt(index).handler.clear();
+    state.removedMessageCount += 1;
+}
+
+void Looper::pruneMessagesLocked(State& state) {
+    if (state.removedMessageCount == 0) {
+        return;
+    }
+
+    if (state.removedMessageCount * 2 > mMessageEnvelopes.size()) {
+        // Mostly removed messages: compact and re-heapify in O(n).
+        size_t kept = 0;
+        for (size_t i = 0; i < mMessageEnvelopes.size(); i++) {
+            if (mMessageEnvelopes.itemAt(i).handler != nullptr) {
+                if (kept != i) {
+                    std::swap(mMessageEnvelopes.editItemAt(kept),
+                            mMessageEnvelopes.editItemAt(i));
+                }
+                kept += 1;
+            }
+        }
+        mMessageEnvelopes.removeItemsAt(kept, mMessageEnvelopes.size() - kept);
+        state.removedMessageCount = 0;
+        for (size_t i = kept / 2; i != 0; ) {
+            siftDownMessageLocked(--i);
+        }
+        return;
+    }
+
+    // Otherwise only make sure the head is a live message.
+    while (mMessageEnvelopes.size() != 0 && mMessageEnvelopes.itemAt(0).handler == nullptr) {
+        popMessageLocked(state);
+    }
+}
+
 bool Looper::isPolling() const {
     return mPolling;
 }
 
+void Looper::State::recordCallbackTime(const void* address, RefBase* callback,
+        bool isMessageHandler, nsecs_t duration) {
+    // Declared before the lock so it is released after it, in case it is the last
+    // reference to an evicted callback.
+    wp<RefBase> evicted;
+    AutoMutex _l(statsLock);
+
+    const void* key = callback->getWeakRefs();
+    ssize_t index = callbackStats.indexOfKey(key);
+    if (index < 0) {
+        if (callbackStats.size() >= MAX_CALLBACK_STATS) {
+            ssize_t oldest = -1;
+            for (size_t i = 0; i < callbackStats.size(); i++) {
+                if (callbackStats.keyAt(i) != nullptr && (oldest < 0
+                        || callbackStats.valueAt(i).lastUsed
+                                < callbackStats.valueAt(oldest).lastUsed)) {
+                    oldest = i;
+                }
+            }
+            CallbackStats old = callbackStats.valueAt(oldest);
+            callbackStats.removeItemsAt(oldest);
+            evicted = old.callback;
+
+            ssize_t otherIndex = callbackStats.indexOfKey(nullptr);
+            if (otherIndex < 0) {
+                otherIndex = callbackStats.add(nullptr, CallbackStats());
+            }
+            CallbackStats& other = callbackStats.editValueAt(otherIndex);
+            other.count += old.count;
+            other.totalTime += old.totalTime;
+            other.maxTime = std::max(other.maxTime, old.maxTime);
+            for (size_t i = 0; i < CALLBACK_TIME_BUCKETS; i++) {
+                other.buckets[i] += old.buckets[i];
+            }
+        }
+
+        CallbackStats stats;
+        stats.callback = callback;
+        stats.address = address;
+        stats.isMessageHandler = isMessageHandler;
+        index = callbackStats.add(key, stats);
+    }
+
+    CallbackStats& stats = callbackStats.editValueAt(index);
+    stats.lastUsed = ++statsClock;
+    size_t bucket = 0;
+    while (bucket < CALLBACK_TIME_BUCKETS - 1 && duration >= CALLBACK_TIME_BOUNDS[bucket]) {
+        bucket += 1;
+    }
+    stats.buckets[bucket] += 1;
+    stats.count += 1;
+    stats.totalTime += duration;
+    if (duration > stats.maxTime) {
+        stats.maxTime = duration;
+    }
+}
+
+void Looper::dump(int fd) {
+    uint64_t pollCount, wakeCount, wakeSignalCount, epollRebuildCount;
+    uint64_t pollEventCounts[POLL_EVENT_BUCKETS];
+    size_t queueDepth, queueHighWater, requestCount;
+    State& state = this->state();
+    { // acquire lock
+        AutoMutex _l(mLock);
+        pollCount = state.pollCount;
+        memcpy(pollEventCounts, state.pollEventCounts, sizeof(pollEventCounts));
+        wakeCount = state.wakeCount;
+        wakeSignalCount = state.wakeSignalCount;
+        epollRebuildCount = state.epollRebuildCount;
+        queueDepth = mMessageEnvelopes.size() - state.removedMessageCount;
+        queueHighWater = state.messageQueueHighWater;
+        requestCount = state.requestCount;
+    } // release lock
+
+    dprintf(fd, "Looper %p:\n", this);
+    dprintf(fd, "  polls: %" PRIu64 ", epoll events per poll:", pollCount);
+    for (size_t i = 0; i < POLL_EVENT_BUCKETS; i++) {
+        dprintf(fd, " %s: %" PRIu64, POLL_EVENT_LABELS[i], pollEventCounts[i]);
+    }
+    dprintf(fd, "\n");
+    dprintf(fd, "  wakes: %" PRIu64 " (%" PRIu64 " wake calls), epoll rebuilds: %" PRIu64 "\n",
+            wakeCount, wakeSignalCount, epollRebuildCount);
+    dprintf(fd, "  messages: %zu queued, %zu high-water; fds: %zu\n",
+            queueDepth, queueHighWater, requestCount);
+
+    AutoMutex _l(state.statsLock);
+    for (size_t i = 0; i < state.callbackStats.size(); i++) {
+        const State::CallbackStats& stats = state.callbackStats.valueAt(i);
+        if (state.callbackStats.keyAt(i) == nullptr) {
+            dprintf(fd, "  other callbacks:");
+        } else {
+            dprintf(fd, "  %s %p:", stats.isMessageHandler ? "handler" : "fd callback",
+                    stats.address);
+        }
+        dprintf(fd, " count %" PRIu64 ", avg %" PRId64 "us, max %" PRId64 "us,",
+                stats.count, ns2us(stats.totalTime / int64_t(stats.count)),
+                ns2us(stats.maxTime));
+        for (size_t j = 0; j < CALLBACK_TIME_BUCKETS; j++) {
+            dprintf(fd, " %s: %" PRIu64, CALLBACK_TIME_LABELS[j], stats.buckets[j]);
+        }
+        dprintf(fd, "\n");
+    }
+}
+
+void Looper::dumpAll(int fd) {
+    // Hold on to the loopers rather than the lock while dumping, so that neither a
+    // looper being destroyed nor one busy under mLock can hold up the others.
+    Vector<sp<Looper> > loopers;
+    { // acquire lock
+        RWLock::AutoRLock _l(State::sLock);
+        for (size_t i = 0; i < State::sStates.size(); i++) {
+            sp<Looper> looper = State::sStates.valueAt(i)->looper.promote();
+            if (looper != nullptr) {
+                loopers.push(looper);
+            }
+        }
+    } // release lock
+
+    for (size_t i = 0; i < loopers.size(); i++) {
+        loopers.itemAt(i)->dump(fd);
+    }
+}
+
 void Looper::Request::initEventItem(struct epoll_event* eventItem) const {
     int epollEvents = 0;
     if (events & EVENT_INPUT) epollEvents |= EPOLLIN;
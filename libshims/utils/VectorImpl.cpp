@@ -35,10 +35,19 @@ namespace android {
 
 const size_t kMinVectorCapacity = 4;
 
+// Above this many items sort() merges insertion sorted runs of kSortRunLength
+// items instead of insertion sorting the whole array.
+const size_t kMergeSortThreshold = 32;
+const size_t kSortRunLength = 16;
+
 static inline size_t max(size_t a, size_t b) {
     return a>b ? a : b;
 }
 
+static inline size_t min(size_t a, size_t b) {
+    return a<b ? a : b;
+}
+
 // ----------------------------------------------------------------------------
 
 VectorImpl::VectorImpl(size_t itemSize, uint32_t flags)
@@ -171,8 +180,11 @@ status_t VectorImpl::sort(VectorImpl::compar_r_t cmp, void* state)
 {
     // the sort must be stable. we're using insertion sort which
     // is well suited for small and already sorted arrays
-    // for big arrays, it could be better to use mergesort
+    // big arrays are merge sorted unless we can't get the extra buffer
     const ssize_t count = size();
+    if (size_t(count) > kMergeSortThreshold && _merge_sort(cmp, state)) {
+        return OK;
+    }
     if (count > 1) {
         void* array = const_cast<void*>(arrayImpl());
         void* temp = nullptr;
@@ -223,6 +235,107 @@ status_t VectorImpl::sort(VectorImpl::compar_r_t cmp, void* state)
     return OK;
 }
 
+bool VectorImpl::_merge_sort(VectorImpl::compar_r_t cmp, void* state)
+{
+    const size_t count = size();
+    const char* items = reinterpret_cast<const char*>(arrayImpl());
+
+    // don't touch (and possibly copy) a shared array that is already sorted
+    size_t i = 1;
+    while (i < count && cmp(items + mItemSize*(i-1), items + mItemSize*i, state) <= 0) {
+        i++;
+    }
+    if (i == count) {
+        return true;
+    }
+
+    void* buffer = malloc(count*mItemSize);
+    void* temp = malloc(mItemSize);
+    void* array = buffer && temp ? editArrayImpl() : nullptr;
+    if (!array) {
+        free(buffer);
+        free(temp);
+        return false;
+    }
+
+    for (size_t from = 0; from < count; from += kSortRunLength) {
+        _insertion_sort_run(array, from, min(from + kSortRunLength, count), temp, cmp, state);
+    }
+    free(temp);
+
+    // merge runs back and forth between the array and the buffer
+    void* from = array;
+    void* dest = buffer;
+    for (size_t width = kSortRunLength; width < count; width *= 2) {
+        _merge_pass(dest, from, count, width, cmp, state);
+        void* sorted = dest;
+        dest = from;
+        from = sorted;
+    }
+    if (from != array) {
+        _do_copy(array, from, count);
+        _do_destroy(from, count);
+    }
+    free(buffer);
+    return true;
+}
+
+void VectorImpl::_insertion_sort_run(void* array, size_t from, size_t to, void* temp,
+        VectorImpl::compar_r_t cmp, void* state) const
+{
+    // temp is raw storage for one item
+    char* items = reinterpret_cast<char*>(array);
+    for (size_t i = from + 1; i < to; i++) {
+        void* item = items + mItemSize*i;
+        if (cmp(items + mItemSize*(i-1), item, state) <= 0) {
+            continue;
+        }
+        _do_copy(temp, item, 1);
+        size_t j = i;
+        do {
+            void* next = items + mItemSize*j;
+            _do_destroy(next, 1);
+            _do_copy(next, items + mItemSize*(j-1), 1);
+            --j;
+        } while (j > from && cmp(items + mItemSize*(j-1), temp, state) > 0);
+        void* next = items + mItemSize*j;
+        _do_destroy(next, 1);
+        _do_copy(next, temp, 1);
+        _do_destroy(temp, 1);
+    }
+}
+
+void VectorImpl::_merge_pass(void* dest, void* from, size_t count, size_t width,
+        VectorImpl::compar_r_t cmp, void* state) const
+{
+    // merges each pair of sorted runs of width items from "from" into raw "dest",
+    // then destroys "from". _do_copy() is a plain memcpy for HAS_TRIVIAL_COPY items.
+    char* src = reinterpret_cast<char*>(from);
+    char* dst = reinterpret_cast<char*>(dest);
+    for (size_t lo = 0; lo < count; lo += 2*width) {
+        const size_t mid = min(lo + width, count);
+        const size_t hi = min(lo + 2*width, count);
+        size_t i = lo;
+        size_t j = mid;
+        size_t k = lo;
+        // runs that are already in order are copied as they are
+        if (mid < hi && cmp(src + mItemSize*(mid-1), src + mItemSize*mid, state) > 0) {
+            while (i < mid && j < hi) {
+                // take from the left run on ties to keep the sort stable
+                if (cmp(src + mItemSize*j, src + mItemSize*i, state) < 0) {
+                    _do_copy(dst + mItemSize*k++, src + mItemSize*j++, 1);
+                } else {
+                    _do_copy(dst + mItemSize*k++, src + mItemSize*i++, 1);
+                }
+            }
+        }
+        _do_copy(dst + mItemSize*k, src + mItemSize*i, mid - i);
+        k += mid - i;
+        _do_copy(dst + mItemSize*k, src + mItemSize*j, hi - j);
+    }
+    _do_destroy(from, count);
+}
+
 void VectorImpl::pop()
 {
     if (size())
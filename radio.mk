@@ -39,6 +39,10 @@ PRODUCT_PROPERTY_OVERRIDES += \
 
 PRODUCT_PROPERTY_OVERRIDES += \
     ro.data.large_tcp_window_size=true \
+    ro.ril.async_responses=true \
+    ro.ril.rpc_threads=2 \
     ro.ril.telephony.mqanelements=5 \
+    ro.ril.unsol_coalesce_ms=500 \
+    ro.ril.unsol_coalesce_screen_off_ms=5000 \
     ro.telephony.call_ring.multiple=false \
     ro.use_data_netmgrd=true
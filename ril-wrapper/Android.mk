@@ -3,7 +3,16 @@ LOCAL_PATH := $(call my-dir)
 include $(CLEAR_VARS)
 LOCAL_MODULE           := libril-wrapper
 LOCAL_VENDOR_MODULE    := true
-LOCAL_SRC_FILES        := ril-wrapper.c
+LOCAL_SRC_FILES        := ril-wrapper.c ril-transforms.c
 LOCAL_SHARED_LIBRARIES := libdl liblog libril libcutils
 LOCAL_CFLAGS           := -Wall -Werror
 include $(BUILD_SHARED_LIBRARY)
+
+include $(CLEAR_VARS)
+LOCAL_MODULE           := ril_wrapper_transform_replay
+LOCAL_VENDOR_MODULE    := true
+LOCAL_SRC_FILES        := ril-transforms.c tests/transform_replay.c
+LOCAL_SHARED_LIBRARIES := liblog libril
+LOCAL_CFLAGS           := -Wall -Werror
+LOCAL_GTEST            := false
+include $(BUILD_NATIVE_TEST)
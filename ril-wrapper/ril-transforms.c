@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ril-wrapper"
+
+#include <log/log.h>
+#include <telephony/ril.h>
+
+#include <stddef.h>
+#include <string.h>
+
+#include "ril-transforms.h"
+
+/*
+ * Fails the build unless member sits at the same distance from base
+ * in both structs, i.e. a single move of base carries member along.
+ */
+#define ASSERT_MOVES_WITH(from_type, to_type, base, member)                         \
+    _Static_assert(offsetof(from_type, member) - offsetof(from_type, base) ==       \
+                           offsetof(to_type, member) - offsetof(to_type, base),     \
+                   #member " does not move with " #base)
+
+/*
+ * The vendor signal strength carries an extra UMTS block after GW.
+ * Everything from CDMA onwards slides down over it.
+ */
+_Static_assert(offsetof(RIL_SignalStrength_v10_vendor, GW_SignalStrength) ==
+                       offsetof(RIL_SignalStrength_v10, GW_SignalStrength),
+               "GW_SignalStrength must stay in place");
+ASSERT_MOVES_WITH(RIL_SignalStrength_v10_vendor, RIL_SignalStrength_v10, CDMA_SignalStrength,
+                  EVDO_SignalStrength);
+ASSERT_MOVES_WITH(RIL_SignalStrength_v10_vendor, RIL_SignalStrength_v10, CDMA_SignalStrength,
+                  LTE_SignalStrength);
+ASSERT_MOVES_WITH(RIL_SignalStrength_v10_vendor, RIL_SignalStrength_v10, CDMA_SignalStrength,
+                  TD_SCDMA_SignalStrength);
+_Static_assert(sizeof(RIL_SignalStrength_v10_vendor) -
+                               offsetof(RIL_SignalStrength_v10_vendor, CDMA_SignalStrength) ==
+                       sizeof(RIL_SignalStrength_v10) -
+                               offsetof(RIL_SignalStrength_v10, CDMA_SignalStrength),
+               "signal strength tails differ in size");
+
+static const ResponseMove signalStrengthMoves[] = {
+    {
+        offsetof(RIL_SignalStrength_v10_vendor, CDMA_SignalStrength),
+        offsetof(RIL_SignalStrength_v10, CDMA_SignalStrength),
+        sizeof(RIL_SignalStrength_v10) - offsetof(RIL_SignalStrength_v10, CDMA_SignalStrength),
+    },
+};
+
+#define RESPONSE_TRANSFORM(id, vendor_type, ril_type, moves) \
+    { id, #id, sizeof(vendor_type), sizeof(ril_type), moves, sizeof(moves) / sizeof(moves[0]) }
+
+#define RESPONSE_TRANSFORM_COUNT(table) (sizeof(table) / sizeof(table[0]))
+
+static const ResponseTransform requestTransforms[] = {
+    RESPONSE_TRANSFORM(RIL_REQUEST_SIGNAL_STRENGTH, RIL_SignalStrength_v10_vendor,
+                       RIL_SignalStrength_v10, signalStrengthMoves),
+};
+
+static const ResponseTransform unsolTransforms[] = {
+    RESPONSE_TRANSFORM(RIL_UNSOL_SIGNAL_STRENGTH, RIL_SignalStrength_v10_vendor,
+                       RIL_SignalStrength_v10, signalStrengthMoves),
+};
+
+static const ResponseTransform* findTransform(const ResponseTransform* transforms, size_t count,
+                                              int id) {
+    for (size_t i = 0; i < count; i++) {
+        if (transforms[i].id == id) {
+            return &transforms[i];
+        }
+    }
+
+    return NULL;
+}
+
+size_t transformResponse(const ResponseTransform* transform, void* response, size_t len) {
+    if (len != transform->vendorLen) {
+        ALOGE("%s: invalid response length of %s", __func__, transform->name);
+        return len;
+    }
+
+    char* data = (char*)response;
+    for (size_t i = 0; i < transform->moveCount; i++) {
+        const ResponseMove* move = &transform->moves[i];
+        memmove(data + move->to, data + move->from, move->len);
+    }
+
+    return transform->rilLen;
+}
+
+const ResponseTransform* findRequestTransform(int request) {
+    return findTransform(requestTransforms, RESPONSE_TRANSFORM_COUNT(requestTransforms), request);
+}
+
+const ResponseTransform* findUnsolTransform(int unsolResponse) {
+    return findTransform(unsolTransforms, RESPONSE_TRANSFORM_COUNT(unsolTransforms),
+                         unsolResponse);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RIL_WRAPPER_RIL_TRANSFORMS_H
+#define RIL_WRAPPER_RIL_TRANSFORMS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <telephony/ril.h>
+
+/*
+ * The signal strength of the qmi RIL, with a UMTS block libril does not know.
+ */
+typedef struct {
+    int rscp;    /* The Received Signal Code Power in dBm multipled by -1.
+                  * Range : 25 to 120
+                  * INT_MAX: 0x7FFFFFFF denotes invalid value.
+                  * Reference: 3GPP TS 25.123, section 9.1.1.1 */
+} RIL_UMTS_SignalStrength;
+
+typedef struct {
+    RIL_GW_SignalStrength GW_SignalStrength;
+    RIL_UMTS_SignalStrength     UMTS_SignalStrength;
+    RIL_CDMA_SignalStrength CDMA_SignalStrength;
+    RIL_EVDO_SignalStrength EVDO_SignalStrength;
+    RIL_LTE_SignalStrength_v8 LTE_SignalStrength;
+    RIL_TD_SCDMA_SignalStrength TD_SCDMA_SignalStrength;
+} RIL_SignalStrength_v10_vendor;
+
+/*
+ * A block of bytes moved within a response buffer.
+ */
+typedef struct {
+    size_t from;
+    size_t to;
+    size_t len;
+} ResponseMove;
+
+/*
+ * Rewrites a vendor payload into the layout libril expects, in place.
+ * The moves are applied in order with memmove, so they may overlap.
+ */
+typedef struct {
+    int id;
+    const char* name;
+    size_t vendorLen;
+    size_t rilLen;
+    const ResponseMove* moves;
+    size_t moveCount;
+} ResponseTransform;
+
+const ResponseTransform* findRequestTransform(int request);
+const ResponseTransform* findUnsolTransform(int unsolResponse);
+
+/*
+ * Returns the length of the transformed response, or len untouched
+ * if the payload does not have the vendor size.
+ */
+size_t transformResponse(const ResponseTransform* transform, void* response, size_t len);
+
+/*
+ * With ro.ril.wrapper.capture set, every payload that has a transform
+ * is appended to the capture file before it is transformed, as a
+ * CapturedPayload followed by len bytes. The file starts with
+ * CAPTURE_MAGIC and CAPTURE_VERSION as two uint32_t.
+ */
+#define CAPTURE_PATH "/data/vendor/radio/ril_wrapper_capture.bin"
+#define CAPTURE_MAGIC 0x50435752 /* "RWCP" */
+#define CAPTURE_VERSION 1
+
+typedef struct {
+    uint32_t unsol; /* 1 for unsolicited responses, 0 for request completions */
+    int32_t id;
+    uint32_t len;
+    uint32_t reserved;
+} CapturedPayload;
+
+#endif /* RIL_WRAPPER_RIL_TRANSFORMS_H */
@@ -21,28 +21,40 @@
  */
 #define RIL_SHLIB
 
+#include <cutils/properties.h>
 #include <log/log.h>
 #include <telephony/ril.h>
 
 #include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ril-transforms.h"
 
 #define RIL_LIB_NAME "libril-qc-qmi-1.so"
 
-typedef struct {
-    int rscp;    /* The Received Signal Code Power in dBm multipled by -1.
-                  * Range : 25 to 120
-                  * INT_MAX: 0x7FFFFFFF denotes invalid value.
-                  * Reference: 3GPP TS 25.123, section 9.1.1.1 */
-} RIL_UMTS_SignalStrength;
+/*
+ * Resolve every symbol of the qmi RIL at dlopen time instead of on first call.
+ */
+#define RIL_LIB_BIND_NOW_PROPERTY "ro.ril.wrapper.bind_now"
 
-typedef struct {
-    RIL_GW_SignalStrength GW_SignalStrength;
-    RIL_UMTS_SignalStrength     UMTS_SignalStrength;
-    RIL_CDMA_SignalStrength CDMA_SignalStrength;
-    RIL_EVDO_SignalStrength EVDO_SignalStrength;
-    RIL_LTE_SignalStrength_v8 LTE_SignalStrength;
-    RIL_TD_SCDMA_SignalStrength TD_SCDMA_SignalStrength;
-} RIL_SignalStrength_v10_vendor;
+/*
+ * Capture the vendor payloads that get transformed, see ril-transforms.h.
+ */
+#define RIL_CAPTURE_PROPERTY "ro.ril.wrapper.capture"
+
+/*
+ * Stop capturing once the capture file would grow past this.
+ */
+#define CAPTURE_MAX_BYTES (1024 * 1024)
 
 /*
  * These structs are only avaiable in ril_internal.h
@@ -65,17 +77,72 @@ typedef struct RequestInfo {
 static const RIL_RadioFunctions* qmiRilFunctions;
 static const struct RIL_Env* ossRilEnv;
 
-static size_t transformResponse(const void* response) {
-    RIL_SignalStrength_v10_vendor vendorResponse = *(RIL_SignalStrength_v10_vendor*)response;
-    RIL_SignalStrength_v10* rilResponse = (RIL_SignalStrength_v10*)response;
+/*
+ * Boot time stamps of the startup phases, in nanoseconds.
+ */
+static int64_t initStartNs;
+static int64_t dlopenDoneNs;
+static int64_t qmiInitDoneNs;
+static atomic_bool firstRequestSeen;
 
-    rilResponse->GW_SignalStrength = vendorResponse.GW_SignalStrength;
-    rilResponse->CDMA_SignalStrength = vendorResponse.CDMA_SignalStrength;
-    rilResponse->EVDO_SignalStrength = vendorResponse.EVDO_SignalStrength;
-    rilResponse->LTE_SignalStrength = vendorResponse.LTE_SignalStrength;
-    rilResponse->TD_SCDMA_SignalStrength.rscp = vendorResponse.TD_SCDMA_SignalStrength.rscp;
+static int captureFd = -1;
+static atomic_size_t captureBytes;
 
-    return sizeof(RIL_SignalStrength_v10);
+static int64_t nowNs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void logStartupPhases(int request) {
+    int64_t firstRequestNs = nowNs();
+
+    ALOGI("%s: dlopen %lld us, RIL_Init %lld us, first onRequest (%d) %lld us later", __func__,
+          (long long)(dlopenDoneNs - initStartNs) / 1000,
+          (long long)(qmiInitDoneNs - dlopenDoneNs) / 1000, request,
+          (long long)(firstRequestNs - qmiInitDoneNs) / 1000);
+}
+
+static void openCapture(void) {
+    uint32_t header[] = {CAPTURE_MAGIC, CAPTURE_VERSION};
+
+    if (!property_get_bool(RIL_CAPTURE_PROPERTY, false)) {
+        return;
+    }
+
+    captureFd = open(CAPTURE_PATH, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0660);
+    if (captureFd < 0) {
+        ALOGE("%s: failed to open %s: %s", __func__, CAPTURE_PATH, strerror(errno));
+        return;
+    }
+    if (write(captureFd, header, sizeof(header)) != sizeof(header)) {
+        ALOGE("%s: failed to write %s: %s", __func__, CAPTURE_PATH, strerror(errno));
+        close(captureFd);
+        captureFd = -1;
+        return;
+    }
+    atomic_store(&captureBytes, sizeof(header));
+}
+
+static void capturePayload(bool unsol, int id, const void* data, size_t len) {
+    CapturedPayload captured = {unsol, id, len, 0};
+    struct iovec iov[] = {
+        {&captured, sizeof(captured)},
+        {(void*)data, len},
+    };
+    size_t size = sizeof(captured) + len;
+
+    if (captureFd < 0 || atomic_fetch_add(&captureBytes, size) + size > CAPTURE_MAX_BYTES) {
+        return;
+    }
+
+    /*
+     * O_APPEND keeps records of concurrent callers whole.
+     */
+    if (writev(captureFd, iov, 2) < 0) {
+        ALOGE("%s: failed to write %s: %s", __func__, CAPTURE_PATH, strerror(errno));
+    }
 }
 
 static void onRequestCompleteShim(RIL_Token t, RIL_Errno e, void* response, size_t responselen) {
@@ -90,16 +157,10 @@ static void onRequestCompleteShim(RIL_Token t, RIL_Errno e, void* response, size
         goto do_not_handle;
     }
 
-    int request = requestInfo->pCI->requestNumber;
-    switch (request) {
-        case RIL_REQUEST_SIGNAL_STRENGTH:
-            if (responselen != sizeof(RIL_SignalStrength_v10_vendor)) {
-                ALOGE("%s: invalid response length of RIL_REQUEST_SIGNAL_STRENGTH", __func__);
-                goto do_not_handle;
-            }
-
-            responselen = transformResponse(response);
-            break;
+    const ResponseTransform* transform = findRequestTransform(requestInfo->pCI->requestNumber);
+    if (transform) {
+        capturePayload(false, transform->id, response, responselen);
+        responselen = transformResponse(transform, response, responselen);
     }
 
 do_not_handle:
@@ -112,25 +173,35 @@ static void onUnsolicitedResponseShim(int unsolResponse, const void* data, size_
         goto do_not_handle;
     }
 
-    switch (unsolResponse) {
-        case RIL_UNSOL_SIGNAL_STRENGTH:
-            if (datalen != sizeof(RIL_SignalStrength_v10_vendor)) {
-                ALOGE("%s: invalid response length", __func__);
-                goto do_not_handle;
-            }
-
-            datalen = transformResponse(data);
-            break;
+    const ResponseTransform* transform = findUnsolTransform(unsolResponse);
+    if (transform) {
+        capturePayload(true, transform->id, data, datalen);
+        datalen = transformResponse(transform, (void*)data, datalen);
     }
 
 do_not_handle:
     ossRilEnv->OnUnsolicitedResponse(unsolResponse, data, datalen);
 }
 
+static void onRequestShim(int request, void* data, size_t datalen, RIL_Token t) {
+    if (!atomic_load_explicit(&firstRequestSeen, memory_order_relaxed) &&
+        !atomic_exchange(&firstRequestSeen, true)) {
+        logStartupPhases(request);
+    }
+
+    qmiRilFunctions->onRequest(request, data, datalen, t);
+}
+
 const RIL_RadioFunctions* RIL_Init(const struct RIL_Env* env, int argc, char** argv) {
     RIL_RadioFunctions const* (*qmiRilInit)(const struct RIL_Env* env, int argc, char** argv);
     static struct RIL_Env shimmedRilEnv;
+    static RIL_RadioFunctions shimmedRilFunctions;
     void* qmiRil;
+    int dlopenFlags = RTLD_LOCAL;
+
+    initStartNs = nowNs();
+
+    openCapture();
 
     /*
      * Save the RilEnv passed from rild.
@@ -145,13 +216,20 @@ const RIL_RadioFunctions* RIL_Init(const struct RIL_Env* env, int argc, char** a
     shimmedRilEnv.OnUnsolicitedResponse = onUnsolicitedResponseShim;
 
     /*
-     * Open the qmi RIL.
+     * Open the qmi RIL, binding it up front if asked to.
      */
-    qmiRil = dlopen(RIL_LIB_NAME, RTLD_LOCAL);
+    if (property_get_bool(RIL_LIB_BIND_NOW_PROPERTY, false)) {
+        dlopenFlags |= RTLD_NOW;
+    } else {
+        dlopenFlags |= RTLD_LAZY;
+    }
+
+    qmiRil = dlopen(RIL_LIB_NAME, dlopenFlags);
     if (!qmiRil) {
         ALOGE("%s: failed to load %s: %s\n", __func__, RIL_LIB_NAME, dlerror());
         return NULL;
     }
+    dlopenDoneNs = nowNs();
 
     /*
      * Get a reference to the qmi RIL_Init.
@@ -170,8 +248,20 @@ const RIL_RadioFunctions* RIL_Init(const struct RIL_Env* env, int argc, char** a
         ALOGE("%s: failed to get functions from RIL_Init\n", __func__);
         goto fail_after_dlopen;
     }
+    qmiInitDoneNs = nowNs();
+
+    /*
+     * Copy the qmi RIL functions and shim onRequest to time the first request.
+     */
+    shimmedRilFunctions = *qmiRilFunctions;
+    shimmedRilFunctions.onRequest = onRequestShim;
+
+    ALOGI("%s: loaded %s with %s binding in %lld us, RIL_Init took %lld us", __func__,
+          RIL_LIB_NAME, (dlopenFlags & RTLD_NOW) ? "immediate" : "lazy",
+          (long long)(dlopenDoneNs - initStartNs) / 1000,
+          (long long)(qmiInitDoneNs - dlopenDoneNs) / 1000);
 
-    return qmiRilFunctions;
+    return &shimmedRilFunctions;
 
 fail_after_dlopen:
     dlclose(qmiRil);
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2018 The LineageOS Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Replays vendor payloads captured by ril-wrapper (ro.ril.wrapper.capture)
+ * through the response transforms, checks each result against a field by
+ * field conversion and reports the time a transform takes. Without a
+ * capture file, one made up payload per transform is replayed.
+ *
+ * Usage: ril_wrapper_transform_replay [-n rounds] [capture.bin]
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../ril-transforms.h"
+
+#define MAX_PAYLOAD 4096
+
+typedef struct {
+    bool unsol;
+    int id;
+    size_t len;
+    unsigned char data[MAX_PAYLOAD];
+} Payload;
+
+static int64_t nowNs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+ * The conversion ril-wrapper did before the transforms, one field at a time.
+ */
+static void convertSignalStrength(const void* vendorData, void* rilData) {
+    const RIL_SignalStrength_v10_vendor* vendor = vendorData;
+    RIL_SignalStrength_v10* ril = rilData;
+
+    ril->GW_SignalStrength = vendor->GW_SignalStrength;
+    ril->CDMA_SignalStrength = vendor->CDMA_SignalStrength;
+    ril->EVDO_SignalStrength = vendor->EVDO_SignalStrength;
+    ril->LTE_SignalStrength = vendor->LTE_SignalStrength;
+    ril->TD_SCDMA_SignalStrength = vendor->TD_SCDMA_SignalStrength;
+}
+
+static bool checkTransform(const ResponseTransform* transform, const Payload* payload) {
+    unsigned char transformed[MAX_PAYLOAD];
+    unsigned char expected[MAX_PAYLOAD];
+    size_t len;
+
+    memcpy(transformed, payload->data, payload->len);
+    len = transformResponse(transform, transformed, payload->len);
+    if (payload->len != transform->vendorLen) {
+        return len == payload->len && memcmp(transformed, payload->data, len) == 0;
+    }
+
+    switch (transform->id) {
+        case RIL_REQUEST_SIGNAL_STRENGTH:
+        case RIL_UNSOL_SIGNAL_STRENGTH:
+            memset(expected, 0, sizeof(expected));
+            convertSignalStrength(payload->data, expected);
+            break;
+        default:
+            fprintf(stderr, "no reference conversion for %s\n", transform->name);
+            return false;
+    }
+
+    return len == transform->rilLen && memcmp(transformed, expected, len) == 0;
+}
+
+static const ResponseTransform* lookupTransform(const Payload* payload) {
+    return payload->unsol ? findUnsolTransform(payload->id) : findRequestTransform(payload->id);
+}
+
+/*
+ * Time spent in lookup and transform per payload, without the copy that
+ * restores the vendor layout before each round.
+ */
+static double benchmarkTransforms(const Payload* payloads, size_t count, int rounds) {
+    unsigned char work[MAX_PAYLOAD];
+    volatile size_t sink = 0;
+    int64_t start;
+    int64_t copyNs;
+    int64_t totalNs;
+
+    start = nowNs();
+    for (int i = 0; i < rounds; i++) {
+        for (size_t j = 0; j < count; j++) {
+            memcpy(work, payloads[j].data, payloads[j].len);
+            sink += work[i % payloads[j].len];
+        }
+    }
+    copyNs = nowNs() - start;
+
+    start = nowNs();
+    for (int i = 0; i < rounds; i++) {
+        for (size_t j = 0; j < count; j++) {
+            memcpy(work, payloads[j].data, payloads[j].len);
+            sink += transformResponse(lookupTransform(&payloads[j]), work, payloads[j].len);
+        }
+    }
+    totalNs = nowNs() - start;
+
+    return (double)(totalNs - copyNs) / rounds / count;
+}
+
+static bool readPayload(FILE* f, Payload* payload) {
+    CapturedPayload captured;
+
+    if (fread(&captured, sizeof(captured), 1, f) != 1) {
+        return false;
+    }
+    if (captured.len == 0 || captured.len > MAX_PAYLOAD) {
+        fprintf(stderr, "skipping a payload of %u bytes\n", captured.len);
+        fseek(f, captured.len, SEEK_CUR);
+        payload->len = 0;
+        return true;
+    }
+
+    payload->unsol = captured.unsol;
+    payload->id = captured.id;
+    payload->len = captured.len;
+    return fread(payload->data, 1, captured.len, f) == captured.len;
+}
+
+/*
+ * A vendor payload for transform, with a different value in every byte.
+ */
+static void makePayload(const ResponseTransform* transform, bool unsol, Payload* payload) {
+    payload->unsol = unsol;
+    payload->id = transform->id;
+    payload->len = transform->vendorLen;
+    for (size_t i = 0; i < payload->len; i++) {
+        payload->data[i] = i * 7 + 1;
+    }
+}
+
+/*
+ * Check a payload and keep it for the benchmark if it gets transformed;
+ * payloads of the wrong size are passed on untouched and logged instead.
+ */
+static bool replayPayload(const Payload* payload, bool* benchmark) {
+    const ResponseTransform* transform = lookupTransform(payload);
+
+    *benchmark = false;
+    if (!transform) {
+        fprintf(stderr, "no transform for %s %d\n", payload->unsol ? "unsol" : "request",
+                payload->id);
+        return false;
+    }
+    if (!checkTransform(transform, payload)) {
+        fprintf(stderr, "%s: %zu byte payload transformed wrongly\n", transform->name,
+                payload->len);
+        return false;
+    }
+
+    *benchmark = payload->len == transform->vendorLen;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Payload* payloads = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    size_t replayed = 0;
+    int rounds = 0;
+    int failures = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:")) != -1) {
+        switch (opt) {
+            case 'n':
+                rounds = atoi(optarg);
+                break;
+            default:
+                optind = argc + 1;
+                break;
+        }
+    }
+    if (optind < argc - 1 || optind > argc || rounds < 0) {
+        fprintf(stderr, "usage: %s [-n rounds] [capture.bin]\n", argv[0]);
+        return 1;
+    }
+
+    FILE* f = NULL;
+    if (optind < argc) {
+        uint32_t header[2];
+
+        f = fopen(argv[optind], "rb");
+        if (!f) {
+            perror(argv[optind]);
+            return 1;
+        }
+        if (fread(header, sizeof(header), 1, f) != 1 || header[0] != CAPTURE_MAGIC ||
+            header[1] != CAPTURE_VERSION) {
+            fprintf(stderr, "%s: not a version %d capture\n", argv[optind], CAPTURE_VERSION);
+            fclose(f);
+            return 1;
+        }
+    }
+
+    for (;;) {
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            payloads = realloc(payloads, capacity * sizeof(*payloads));
+            if (!payloads) {
+                fprintf(stderr, "out of memory\n");
+                return 1;
+            }
+        }
+
+        Payload* payload = &payloads[count];
+        if (f) {
+            if (!readPayload(f, payload)) {
+                break;
+            }
+            if (payload->len == 0) {
+                continue;
+            }
+        } else if (replayed == 0) {
+            makePayload(findRequestTransform(RIL_REQUEST_SIGNAL_STRENGTH), false, payload);
+        } else if (replayed == 1) {
+            makePayload(findUnsolTransform(RIL_UNSOL_SIGNAL_STRENGTH), true, payload);
+        } else {
+            break;
+        }
+
+        bool benchmark;
+        replayed++;
+        if (!replayPayload(payload, &benchmark)) {
+            failures++;
+        } else if (benchmark) {
+            count++;
+        }
+    }
+    if (f) {
+        fclose(f);
+    }
+
+    printf("%zu payloads replayed, %d transformed wrongly, %zu left for the benchmark\n",
+           replayed, failures, count);
+    if (count > 0) {
+        if (rounds == 0) {
+            rounds = count < 1000000 ? 1000000 / count : 1;
+        }
+        printf("%.1f ns per lookup and transform over %d rounds\n",
+               benchmarkTransforms(payloads, count, rounds), rounds);
+    }
+
+    free(payloads);
+    return failures ? 1 : 0;
+}